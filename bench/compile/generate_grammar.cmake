@@ -0,0 +1,106 @@
+# Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+# 
+# Boost Software License - Version 1.0 - August 17th, 2003
+# 
+# Permission is hereby granted, free of charge, to any person or organization
+# obtaining a copy of the software and accompanying documentation covered by
+# this license (the "Software") to use, reproduce, display, distribute,
+# execute, and transmit the Software, and to prepare derivative works of the
+# Software, and to permit third-parties to whom the Software is furnished to
+# do so, all subject to the following:
+# 
+# The copyright notices in the Software and this entire statement, including
+# the above license grant, this restriction and the following disclaimer,
+# must be included in all copies of the Software, in whole or in part, and
+# all derivative works of the Software, unless such copies or derivative
+# works are solely in the form of machine-executable object code generated by
+# a source language processor.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+# SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+# FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+# ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+# Generate a synthetic grammar for the compile-time benchmark: STRUCTS
+# structs of MEMBERS options each, cycling through the built-in types,
+# and a function which parses each of them.
+#
+#   cmake -DOUTPUT=grammar.cxx -DSTRUCTS=16 -DMEMBERS=16 -P generate_grammar.cmake
+
+cmake_minimum_required(VERSION 3.12)
+
+foreach(var OUTPUT STRUCTS MEMBERS)
+	if(NOT DEFINED ${var})
+		message(FATAL_ERROR "generate_grammar.cmake: ${var} is not set")
+	endif()
+endforeach()
+
+set(types
+	"std::string"
+	"int"
+	"unsigned"
+	"long"
+	"long long"
+	"double"
+	"std::vector<std::string>"
+	"std::vector<int>"
+	"std::map<std::string, std::string>"
+	"std::map<std::string, int>")
+# Semicolons separate list items, so values use @ instead.
+set(values
+	"\\\"a string\\\""
+	"-42"
+	"42"
+	"-4242"
+	"424242"
+	"4.2"
+	"a, b, c"
+	"1, 2, 3"
+	"{ a b@ c d@ }"
+	"{ a 1@ b 2@ }")
+list(LENGTH types ntypes)
+
+math(EXPR last_struct "${STRUCTS} - 1")
+math(EXPR last_member "${MEMBERS} - 1")
+
+set(src "// Generated by generate_grammar.cmake; do not edit.\n\n")
+string(APPEND src "#include <map>\n#include <string>\n#include <vector>\n\n")
+string(APPEND src "#include <sk/config.hxx>\n\n")
+string(APPEND src "namespace skc = sk::config;\n\n")
+
+set(body "")
+foreach(s RANGE ${last_struct})
+	set(members "")
+	set(options "")
+	set(text "")
+	foreach(m RANGE ${last_member})
+		math(EXPR t "(${s} + ${m}) % ${ntypes}")
+		list(GET types ${t} type)
+		list(GET values ${t} value)
+		string(REPLACE "@" ";" value "${value}")
+		string(APPEND members "    ${type} m${m};\n")
+		if(m EQUAL last_member)
+			string(APPEND options "    skc::option(\"m${m}\", &s${s}::m${m}));\n")
+		else()
+			string(APPEND options "    skc::option(\"m${m}\", &s${s}::m${m}),\n")
+		endif()
+		string(APPEND text "m${m} ${value}; ")
+	endforeach()
+
+	string(APPEND src "struct s${s} {\n${members}};\n\n")
+	string(APPEND src "auto const s${s}_grammar = skc::config<s${s}>(\n${options}\n")
+	string(APPEND body "    s${s} v${s};\n")
+	string(APPEND body "    skc::parse(\"${text}\", s${s}_grammar, v${s});\n")
+endforeach()
+
+string(APPEND src "void parse_all() {\n${body}}\n")
+
+# Only touch the output if it changed, so rerunning the generator doesn't
+# force a rebuild.
+file(WRITE ${OUTPUT}.tmp "${src}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different
+	${OUTPUT}.tmp ${OUTPUT})
+file(REMOVE ${OUTPUT}.tmp)
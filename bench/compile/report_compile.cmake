@@ -0,0 +1,74 @@
+# Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+# 
+# Boost Software License - Version 1.0 - August 17th, 2003
+# 
+# Permission is hereby granted, free of charge, to any person or organization
+# obtaining a copy of the software and accompanying documentation covered by
+# this license (the "Software") to use, reproduce, display, distribute,
+# execute, and transmit the Software, and to prepare derivative works of the
+# Software, and to permit third-parties to whom the Software is furnished to
+# do so, all subject to the following:
+# 
+# The copyright notices in the Software and this entire statement, including
+# the above license grant, this restriction and the following disclaimer,
+# must be included in all copies of the Software, in whole or in part, and
+# all derivative works of the Software, unless such copies or derivative
+# works are solely in the form of machine-executable object code generated by
+# a source language processor.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+# SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+# FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+# ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+# Print the results recorded by time_compile.cmake and write them to
+# OUTPUT.
+
+cmake_minimum_required(VERSION 3.12)
+
+set(report "Compile-time benchmark: ${STRUCTS} structs of ${MEMBERS} options\n\n")
+string(APPEND report "variant                    time (s)    object (bytes)\n")
+
+file(GLOB files "${RESULTS}/*.txt")
+list(SORT files)
+
+if(NOT files)
+	message(FATAL_ERROR "no results; build with --clean-first to recompile")
+endif()
+
+foreach(file ${files})
+	get_filename_component(name "${file}" NAME_WE)
+	file(READ "${file}" result)
+	string(STRIP "${result}" result)
+	string(REPLACE " " ";" result "${result}")
+	list(GET result 0 ms)
+	list(GET result 1 size)
+
+	math(EXPR secs "${ms} / 1000")
+	math(EXPR frac "${ms} % 1000")
+	string(LENGTH "${frac}" len)
+	while(len LESS 3)
+		string(PREPEND frac "0")
+		math(EXPR len "${len} + 1")
+	endwhile()
+
+	set(line "${name}")
+	string(LENGTH "${line}" len)
+	while(len LESS 27)
+		string(APPEND line " ")
+		math(EXPR len "${len} + 1")
+	endwhile()
+	string(APPEND line "${secs}.${frac}")
+	string(LENGTH "${line}" len)
+	while(len LESS 39)
+		string(APPEND line " ")
+		math(EXPR len "${len} + 1")
+	endwhile()
+	string(APPEND report "${line}${size}\n")
+endforeach()
+
+message("${report}")
+file(WRITE "${OUTPUT}" "${report}")
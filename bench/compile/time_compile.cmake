@@ -0,0 +1,90 @@
+# Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+# 
+# Boost Software License - Version 1.0 - August 17th, 2003
+# 
+# Permission is hereby granted, free of charge, to any person or organization
+# obtaining a copy of the software and accompanying documentation covered by
+# this license (the "Software") to use, reproduce, display, distribute,
+# execute, and transmit the Software, and to prepare derivative works of the
+# Software, and to permit third-parties to whom the Software is furnished to
+# do so, all subject to the following:
+# 
+# The copyright notices in the Software and this entire statement, including
+# the above license grant, this restriction and the following disclaimer,
+# must be included in all copies of the Software, in whole or in part, and
+# all derivative works of the Software, unless such copies or derivative
+# works are solely in the form of machine-executable object code generated by
+# a source language processor.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+# SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+# FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+# ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+# Compiler launcher for the compile-time benchmark: run the compiler
+# command following "--", then record the elapsed time and the size of
+# the object file in RESULTS/NAME.txt.
+
+cmake_minimum_required(VERSION 3.12)
+
+set(command "")
+set(object "")
+set(in_command FALSE)
+set(next_is_object FALSE)
+
+math(EXPR last_arg "${CMAKE_ARGC} - 1")
+foreach(i RANGE ${last_arg})
+	set(arg "${CMAKE_ARGV${i}}")
+	if(in_command)
+		list(APPEND command "${arg}")
+		if(next_is_object)
+			set(object "${arg}")
+			set(next_is_object FALSE)
+		elseif(arg STREQUAL "-o")
+			set(next_is_object TRUE)
+		elseif(arg MATCHES "^[-/]Fo(.+)$")
+			set(object "${CMAKE_MATCH_1}")
+		endif()
+	elseif(arg STREQUAL "--")
+		set(in_command TRUE)
+	endif()
+endforeach()
+
+if(NOT command)
+	message(FATAL_ERROR "time_compile.cmake: no compiler command")
+endif()
+
+# %f (microseconds) needs CMake 3.23; older versions only get seconds.
+if(CMAKE_VERSION VERSION_LESS 3.23)
+	set(format "%s")
+else()
+	set(format "%s.%f")
+endif()
+
+string(TIMESTAMP start "${format}" UTC)
+execute_process(COMMAND ${command} RESULT_VARIABLE status)
+string(TIMESTAMP end "${format}" UTC)
+
+if(NOT status EQUAL 0)
+	message(FATAL_ERROR "compiler failed: ${status}")
+endif()
+
+# math() is integer-only, so work in milliseconds.
+foreach(t start end)
+	string(REGEX REPLACE "^([0-9]+)(\\.([0-9][0-9][0-9]).*)?$" "\\1\\3"
+		${t}_ms "${${t}}")
+	if(NOT ${t} MATCHES "\\.")
+		string(APPEND ${t}_ms "000")
+	endif()
+endforeach()
+math(EXPR elapsed_ms "${end_ms} - ${start_ms}")
+
+set(size 0)
+if(object AND EXISTS "${object}")
+	file(SIZE "${object}" size)
+endif()
+
+file(WRITE "${RESULTS}/${NAME}.txt" "${elapsed_ms} ${size}\n")
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_BENCH_COUNTERS_HXX_INCLUDED
+#define SK_CONFIG_BENCH_COUNTERS_HXX_INCLUDED
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "perf_counters.hxx"
+
+namespace sk::config::bench {
+
+    struct counter_options {
+        // Size of the input for each benchmark.
+        std::uint64_t size = 4 * 1024 * 1024;
+
+        std::uint64_t seed = 1;
+
+        // Run each benchmark for at least this long.
+        double min_time = 0.5;
+
+        // Only run benchmarks whose name contains this.
+        std::string filter;
+    };
+
+    struct counter_result {
+        std::string name;
+        std::uint64_t bytes = 0;
+        std::uint64_t statements = 0;
+        std::uint64_t iterations = 0;
+
+        // The sum over all iterations.
+        counter_values total;
+
+        auto per_byte(counter c) const -> std::optional<double> {
+            return per(c, bytes);
+        }
+
+        auto per_statement(counter c) const -> std::optional<double> {
+            return per(c, statements);
+        }
+
+        auto ns_per(std::uint64_t n) const -> double {
+            return total.seconds * 1e9 / static_cast<double>(iterations) /
+                   static_cast<double>(n);
+        }
+
+      private:
+        auto per(counter c, std::uint64_t n) const -> std::optional<double> {
+            auto const &v = total[c];
+            if (!v)
+                return std::nullopt;
+            return *v / static_cast<double>(iterations) /
+                   static_cast<double>(n);
+        }
+    };
+
+    inline auto selected(counter_options const &options, std::string_view name)
+        -> bool {
+        return name.find(options.filter) != std::string_view::npos;
+    }
+
+    /*
+     * Call f once to warm up, then repeatedly until options.min_time has
+     * been measured, and record the counters for all the measured calls.
+     */
+    template <typename F>
+    void measure(counter_options const &options, perf_counters &counters,
+                 counter_result &r, F &&f) {
+        f();
+
+        r.iterations = 0;
+        do {
+            counters.start();
+            f();
+            auto values = counters.stop();
+
+            if (r.iterations++ == 0)
+                r.total = values;
+            else
+                r.total += values;
+        } while (r.total.seconds < options.min_time);
+    }
+
+    // The built-in parsers and the skipper, each on its own.
+    void run_parser_benchmarks(counter_options const &options,
+                               perf_counters &counters,
+                               std::vector<counter_result> &results);
+
+    // Whole grammars through parse().
+    void run_grammar_benchmarks(counter_options const &options,
+                                perf_counters &counters,
+                                std::vector<counter_result> &results);
+
+} // namespace sk::config::bench
+
+#endif // SK_CONFIG_BENCH_COUNTERS_HXX_INCLUDED
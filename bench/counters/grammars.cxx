@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Whole grammars through parse(), for comparison with the parsers on
+ * their own.
+ */
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sk/config.hxx>
+
+#include "counters.hxx"
+#include "generator.hxx"
+#include "grammar.hxx"
+
+namespace sk::config::bench {
+
+    namespace {
+
+        template <typename T> struct value_config {
+            T v{};
+        };
+
+        template <typename Config>
+        void bench_grammar(counter_options const &options,
+                           perf_counters &counters, std::string name,
+                           auto const &grammar, auto &&generate,
+                           std::vector<counter_result> &results) {
+            if (!selected(options, name))
+                return;
+
+            generator_options gen;
+            gen.seed = options.seed;
+            gen.size = options.size;
+
+            std::ostringstream strm;
+            auto generated = generate(gen, strm);
+            std::string const text = std::move(strm).str();
+
+            counter_result r;
+            r.name = std::move(name);
+            r.bytes = generated.bytes;
+            r.statements = generated.statements;
+
+            measure(options, counters, r, [&] {
+                Config c;
+                sk::config::parse(std::string_view(text), grammar, c);
+            });
+
+            results.push_back(std::move(r));
+        }
+
+        template <typename T>
+        void bench_value(counter_options const &options,
+                         perf_counters &counters, std::string name,
+                         value_kind kind,
+                         std::vector<counter_result> &results) {
+            auto const grammar = sk::config::config<value_config<T>>(
+                sk::config::option("v", &value_config<T>::v));
+
+            bench_grammar<value_config<T>>(
+                options, counters, std::move(name), grammar,
+                [&](auto const &gen, auto &strm) {
+                    return generate_values(kind, gen, strm);
+                },
+                results);
+        }
+
+        void bench_server(counter_options const &options,
+                          perf_counters &counters, std::string name,
+                          int depth, std::vector<counter_result> &results) {
+            bench_grammar<bench_config>(
+                options, counters, std::move(name), server_grammar(),
+                [&](auto gen, auto &strm) {
+                    gen.depth = depth;
+                    return generate_config(gen, strm);
+                },
+                results);
+        }
+
+    } // namespace
+
+    void run_grammar_benchmarks(counter_options const &options,
+                                perf_counters &counters,
+                                std::vector<counter_result> &results) {
+        bench_value<int>(options, counters, "grammar/int",
+                         value_kind::integer, results);
+        bench_value<std::string>(options, counters, "grammar/qstring",
+                                 value_kind::qstring, results);
+        bench_value<std::vector<int>>(options, counters,
+                                      "grammar/vector<int>",
+                                      value_kind::int_list, results);
+        bench_server(options, counters, "grammar/server-flat", 1, results);
+        bench_server(options, counters, "grammar/server", 3, results);
+    }
+
+} // namespace sk::config::bench
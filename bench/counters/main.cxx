@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * bench_counters: cycles, instructions, branch misses and L1D/LLC misses
+ * per input byte and per statement, for each built-in parser, the
+ * comment skipper and whole grammars.
+ *
+ *   bench_counters [--size N] [--seed N] [--min-time S] [--filter NAME]
+ *                  [--no-counters] [--json FILE]
+ *
+ * Without hardware counters (not Linux, no PMU, or perf_event_paranoid
+ * above 2) only the time is reported.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "counters.hxx"
+#include "generator.hxx"
+
+namespace sk::config::bench {
+
+    namespace {
+
+        void print_value(std::optional<double> v, int precision) {
+            if (v)
+                std::printf(" %10.*f", precision, *v);
+            else
+                std::printf(" %10s", "-");
+        }
+
+        void print_table(std::vector<counter_result> const &results,
+                         bool per_byte) {
+            std::printf("\nper %s:\n", per_byte ? "byte" : "statement");
+            std::printf("%-22s %10s %10s %10s %10s %10s %10s %10s\n",
+                        "benchmark", per_byte ? "bytes" : "statements", "ns",
+                        "cycles", "instrs", "br-misses", "L1D-misses",
+                        "LLC-misses");
+
+            for (auto const &r : results) {
+                auto n = per_byte ? r.bytes : r.statements;
+                auto per = [&](counter c) {
+                    return per_byte ? r.per_byte(c) : r.per_statement(c);
+                };
+
+                std::printf("%-22s %10llu", r.name.c_str(),
+                            static_cast<unsigned long long>(n));
+                print_value(r.ns_per(n), per_byte ? 3 : 1);
+                print_value(per(counter::cycles), per_byte ? 3 : 1);
+                print_value(per(counter::instructions), per_byte ? 3 : 1);
+                print_value(per(counter::branch_misses), 4);
+                print_value(per(counter::l1d_misses), 4);
+                print_value(per(counter::llc_misses), 4);
+                std::printf("\n");
+            }
+        }
+
+        void write_json(std::ostream &out,
+                        std::vector<counter_result> const &results,
+                        counter_options const &options) {
+            auto value = [&](std::optional<double> v) {
+                if (v)
+                    out << *v;
+                else
+                    out << "null";
+            };
+
+            for (auto const &r : results) {
+                out << "{\"name\":\"" << r.name << "\""
+                    << ",\"seed\":" << options.seed
+                    << ",\"bytes\":" << r.bytes
+                    << ",\"statements\":" << r.statements
+                    << ",\"iterations\":" << r.iterations
+                    << ",\"ns_per_byte\":" << r.ns_per(r.bytes)
+                    << ",\"ns_per_statement\":" << r.ns_per(r.statements);
+
+                for (std::size_t i = 0; i < ncounters; ++i) {
+                    auto c = static_cast<counter>(i);
+                    out << ",\"" << counter_names[i] << "_per_byte\":";
+                    value(r.per_byte(c));
+                    out << ",\"" << counter_names[i] << "_per_statement\":";
+                    value(r.per_statement(c));
+                }
+
+                out << "}\n";
+            }
+        }
+
+        [[noreturn]] void usage() {
+            std::cerr << "usage: bench_counters [--size N] [--seed N] "
+                         "[--min-time S] [--filter NAME]\n"
+                         "                      [--no-counters] "
+                         "[--json FILE]\n";
+            std::exit(2);
+        }
+
+    } // namespace
+
+} // namespace sk::config::bench
+
+int main(int argc, char **argv) try {
+    namespace bench = sk::config::bench;
+
+    bench::counter_options options;
+    bool use_counters = true;
+    std::string json;
+
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        auto value = [&]() -> std::string {
+            if (i + 1 == args.size())
+                bench::usage();
+            return std::string(args[++i]);
+        };
+
+        if (args[i] == "--size")
+            options.size = bench::parse_size(value());
+        else if (args[i] == "--seed")
+            options.seed = std::stoull(value());
+        else if (args[i] == "--min-time")
+            options.min_time = std::stod(value());
+        else if (args[i] == "--filter")
+            options.filter = value();
+        else if (args[i] == "--no-counters")
+            use_counters = false;
+        else if (args[i] == "--json")
+            json = value();
+        else
+            bench::usage();
+    }
+
+    bench::perf_counters counters(use_counters);
+    if (!counters.available())
+        std::cerr << "bench_counters: hardware counters are not available; "
+                     "reporting time only\n";
+
+    std::vector<bench::counter_result> results;
+    bench::run_parser_benchmarks(options, counters, results);
+    bench::run_grammar_benchmarks(options, counters, results);
+
+    bench::print_table(results, true);
+    bench::print_table(results, false);
+
+    if (!json.empty()) {
+        std::ofstream out(json);
+        bench::write_json(out, results, options);
+        if (!out.flush()) {
+            std::cerr << "cannot write " << json << "\n";
+            return 1;
+        }
+    }
+
+    return 0;
+} catch (std::exception const &e) {
+    std::cerr << "bench_counters: " << e.what() << "\n";
+    return 1;
+}
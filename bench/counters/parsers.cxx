@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * The built-in parsers on their own, driven the way parse() drives them:
+ * the same context (the comment skipper and parser_policy) and the same
+ * char const * iterators, one item at a time.
+ */
+
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/parser/bool.hxx>
+#include <sk/config/detail/parser/comment.hxx>
+#include <sk/config/detail/parser/heredoc.hxx>
+#include <sk/config/detail/parser/identifier.hxx>
+#include <sk/config/detail/parser/map.hxx>
+#include <sk/config/detail/parser/number.hxx>
+#include <sk/config/detail/parser/qstring.hxx>
+#include <sk/config/detail/parser/vector.hxx>
+#include <sk/config/parser/string.hxx>
+#include <sk/config/parser_policy.hxx>
+
+#include "counters.hxx"
+#include "generator.hxx"
+
+namespace sk::config::bench {
+
+    namespace {
+
+        namespace x3 = boost::spirit::x3;
+
+        auto make_input(counter_options const &options, auto &&generate)
+            -> std::pair<std::string, generator_result> {
+            generator_options gen;
+            gen.seed = options.seed;
+            gen.size = options.size;
+
+            std::ostringstream strm;
+            auto generated = generate(gen, strm);
+            return {std::move(strm).str(), generated};
+        }
+
+        // Call f with the context parse() creates for char const * input.
+        auto with_context(auto &&f) {
+            parser_policy policy;
+            auto policy_ref = std::ref(policy);
+            auto const skipper_context =
+                x3::make_context<x3::skipper_tag>(detail::parser::comment);
+            auto const context = x3::make_context<parser_policy_tag>(
+                policy_ref, skipper_context);
+            return f(context);
+        }
+
+        // Parse each item in text with Parser, which must parse all of it.
+        template <typename Parser>
+        void parse_items(std::string const &text) {
+            static Parser const parser;
+
+            with_context([&](auto const &context) {
+                char const *first = text.data();
+                char const *const last = first + text.size();
+
+                x3::skip_over(first, last, context);
+                while (first != last) {
+                    typename Parser::attribute_type attr;
+                    if (!parser.parse(first, last, context, x3::unused, attr))
+                        throw std::runtime_error(
+                            "parse failed at offset " +
+                            std::to_string(first - text.data()));
+                    x3::skip_over(first, last, context);
+                }
+            });
+        }
+
+        template <typename Parser>
+        void bench_parser(counter_options const &options,
+                          perf_counters &counters, std::string name,
+                          value_kind kind,
+                          std::vector<counter_result> &results) {
+            if (!selected(options, name))
+                return;
+
+            auto const input =
+                make_input(options, [&](auto const &gen, auto &strm) {
+                    return generate_items(kind, gen, strm);
+                });
+            auto const &text = input.first;
+            auto const &generated = input.second;
+
+            counter_result r;
+            r.name = std::move(name);
+            r.bytes = generated.bytes;
+            r.statements = generated.statements;
+
+            measure(options, counters, r, [&] { parse_items<Parser>(text); });
+
+            results.push_back(std::move(r));
+        }
+
+        // The skipper, over whitespace and comments.
+        void bench_comment(counter_options const &options,
+                           perf_counters &counters,
+                           std::vector<counter_result> &results) {
+            if (!selected(options, "comment"))
+                return;
+
+            auto const input = make_input(
+                options, [&](auto const &gen, auto &strm) {
+                    return generate_comments(gen, strm);
+                });
+            auto const &text = input.first;
+            auto const &generated = input.second;
+
+            counter_result r;
+            r.name = "comment";
+            r.bytes = generated.bytes;
+            r.statements = generated.statements;
+
+            measure(options, counters, r, [&] {
+                with_context([&](auto const &context) {
+                    char const *first = text.data();
+                    char const *const last = first + text.size();
+                    x3::skip_over(first, last, context);
+                    if (first != last)
+                        throw std::runtime_error("comment: input not skipped");
+                });
+            });
+
+            results.push_back(std::move(r));
+        }
+
+    } // namespace
+
+    void run_parser_benchmarks(counter_options const &options,
+                               perf_counters &counters,
+                               std::vector<counter_result> &results) {
+        namespace p = detail::parser;
+        using string_parser = sk::config::parser::any_string_parser<char>;
+
+        bench_comment(options, counters, results);
+        bench_parser<p::identifier<char>>(options, counters, "identifier",
+                                          value_kind::identifier, results);
+        bench_parser<p::qstring<char>>(options, counters, "qstring",
+                                       value_kind::qstring, results);
+        bench_parser<p::heredoc<char>>(options, counters, "heredoc",
+                                       value_kind::heredoc, results);
+        bench_parser<string_parser>(options, counters, "any_string",
+                                    value_kind::qstring, results);
+        bench_parser<p::number_parser<int>>(options, counters, "number<int>",
+                                            value_kind::integer, results);
+        bench_parser<p::number_parser<double>>(options, counters,
+                                               "number<double>",
+                                               value_kind::real, results);
+        bench_parser<p::bool_parser>(options, counters, "bool",
+                                     value_kind::flag, results);
+        bench_parser<p::vector<p::number_parser<int>>>(
+            options, counters, "vector<int>", value_kind::int_list, results);
+        bench_parser<p::vector<string_parser>>(options, counters,
+                                               "vector<string>",
+                                               value_kind::string_list,
+                                               results);
+        bench_parser<p::map<string_parser, p::number_parser<int>>>(
+            options, counters, "map<string,int>", value_kind::int_map,
+            results);
+    }
+
+} // namespace sk::config::bench
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "perf_counters.hxx"
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#    define SK_CONFIG_HAVE_PERF_EVENT 1
+#    include <cstdint>
+#    include <cstring>
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+namespace sk::config::bench {
+
+#ifdef SK_CONFIG_HAVE_PERF_EVENT
+
+    namespace {
+
+        constexpr auto cache_event(std::uint64_t cache, std::uint64_t result)
+            -> std::uint64_t {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                   (result << 16);
+        }
+
+        struct event {
+            std::uint32_t type;
+            std::uint64_t config;
+        };
+
+        // In the same order as enum counter.
+        constexpr std::array<event, ncounters> events{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D,
+                                             PERF_COUNT_HW_CACHE_RESULT_MISS)},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL,
+                                             PERF_COUNT_HW_CACHE_RESULT_MISS)},
+        }};
+
+        auto open_event(event const &e) -> int {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = e.type;
+            attr.config = e.config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            return static_cast<int>(
+                syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+
+    } // namespace
+
+    perf_counters::perf_counters(bool enabled) {
+        for (std::size_t i = 0; i < ncounters; ++i)
+            fds[i] = enabled ? open_event(events[i]) : -1;
+    }
+
+    perf_counters::~perf_counters() {
+        for (int fd : fds)
+            if (fd >= 0)
+                close(fd);
+    }
+
+    void perf_counters::start() {
+        for (int fd : fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+        started = std::chrono::steady_clock::now();
+    }
+
+    auto perf_counters::stop() -> counter_values {
+        auto const stopped = std::chrono::steady_clock::now();
+
+        for (int fd : fds)
+            if (fd >= 0)
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+        counter_values values;
+        values.seconds =
+            std::chrono::duration<double>(stopped - started).count();
+
+        for (std::size_t i = 0; i < ncounters; ++i) {
+            if (fds[i] < 0)
+                continue;
+
+            // value, time enabled, time running
+            std::uint64_t data[3];
+            if (read(fds[i], data, sizeof(data)) != sizeof(data))
+                continue;
+
+            // If the PMU was shared with other events, the counter only
+            // ran for part of the time; scale it up.
+            if (data[2] == 0)
+                continue;
+            double value = static_cast<double>(data[0]);
+            if (data[2] < data[1])
+                value *= static_cast<double>(data[1]) /
+                         static_cast<double>(data[2]);
+            values.counts[i] = value;
+        }
+
+        return values;
+    }
+
+#else
+
+    perf_counters::perf_counters(bool) { fds.fill(-1); }
+
+    perf_counters::~perf_counters() = default;
+
+    void perf_counters::start() {
+        started = std::chrono::steady_clock::now();
+    }
+
+    auto perf_counters::stop() -> counter_values {
+        counter_values values;
+        values.seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - started)
+                             .count();
+        return values;
+    }
+
+#endif
+
+    auto perf_counters::available() const -> bool {
+        for (int fd : fds)
+            if (fd >= 0)
+                return true;
+        return false;
+    }
+
+} // namespace sk::config::bench
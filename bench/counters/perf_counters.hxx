@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_BENCH_PERF_COUNTERS_HXX_INCLUDED
+#define SK_CONFIG_BENCH_PERF_COUNTERS_HXX_INCLUDED
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace sk::config::bench {
+
+    enum struct counter {
+        cycles,
+        instructions,
+        branch_misses,
+        l1d_misses,
+        llc_misses,
+    };
+
+    inline constexpr std::size_t ncounters = 5;
+
+    inline constexpr std::array<std::string_view, ncounters> counter_names{
+        "cycles", "instructions", "branch_misses", "l1d_misses",
+        "llc_misses"};
+
+    /*
+     * Counter values for a measured interval.  A counter which couldn't
+     * be opened is nullopt; seconds is always set.
+     */
+    struct counter_values {
+        std::array<std::optional<double>, ncounters> counts;
+        double seconds = 0;
+
+        auto operator[](counter c) const -> std::optional<double> const & {
+            return counts[static_cast<std::size_t>(c)];
+        }
+
+        auto operator+=(counter_values const &other) -> counter_values & {
+            for (std::size_t i = 0; i < ncounters; ++i) {
+                if (counts[i] && other.counts[i])
+                    *counts[i] += *other.counts[i];
+                else
+                    counts[i].reset();
+            }
+            seconds += other.seconds;
+            return *this;
+        }
+    };
+
+    /*
+     * Hardware counters for the calling thread, in user space only, using
+     * perf_event_open().  Each counter is opened separately, so a PMU
+     * which lacks one still provides the others.  If none can be opened
+     * (not Linux, no PMU in a VM, or perf_event_paranoid too high), only
+     * the time is measured.
+     */
+    class perf_counters {
+      public:
+        // Open the counters, unless enabled is false.
+        explicit perf_counters(bool enabled = true);
+        ~perf_counters();
+
+        perf_counters(perf_counters const &) = delete;
+        auto operator=(perf_counters const &) -> perf_counters & = delete;
+
+        // True if at least one hardware counter is open.
+        auto available() const -> bool;
+
+        void start();
+        auto stop() -> counter_values;
+
+      private:
+        std::array<int, ncounters> fds;
+        std::chrono::steady_clock::time_point started;
+    };
+
+} // namespace sk::config::bench
+
+#endif // SK_CONFIG_BENCH_PERF_COUNTERS_HXX_INCLUDED
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * bench_lookup: compare find() on a frozen_map with std::map,
+ * std::unordered_map and the flat maps.  Each map is filled by parsing
+ * the same config of `user` blocks, then searched with std::string keys,
+ * half of which are not in the map.
+ *
+ *   bench_lookup [--keys N] [--lookups N] [--seed N] [--runs N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <sk/config.hxx>
+#include <sk/config/parser/flat_map.hxx>
+
+#if __has_include(<boost/unordered/unordered_flat_map.hpp>)
+#    include <sk/config/parser/unordered_flat_map.hxx>
+#    define SK_CONFIG_BENCH_UNORDERED_FLAT_MAP
+#endif
+
+namespace sk::config::bench {
+
+    namespace {
+
+        struct lookup_options {
+            std::size_t keys = 100000;
+            std::size_t lookups = 10000000;
+            std::uint64_t seed = 1;
+
+            // Time each benchmark this many times and keep the fastest.
+            int runs = 3;
+        };
+
+        struct user {
+            std::string name;
+            int uid = 0;
+        };
+
+        template <typename Map> struct users_config {
+            Map users;
+        };
+
+        using clock = std::chrono::steady_clock;
+
+        auto seconds_since(clock::time_point start) -> double {
+            return std::chrono::duration<double>(clock::now() - start)
+                .count();
+        }
+
+        auto user_name(std::size_t i) -> std::string {
+            return "user" + std::to_string(i);
+        }
+
+        auto make_config(lookup_options const &options) -> std::string {
+            std::string text;
+            for (std::size_t i = 0; i < options.keys; ++i)
+                text += "user " + user_name(i) + " { uid " +
+                        std::to_string(i) + "; };\n";
+            return text;
+        }
+
+        // The keys to search for, in random order; every other key misses.
+        auto make_queries(lookup_options const &options)
+            -> std::vector<std::string> {
+            std::mt19937_64 rng(options.seed);
+            std::uniform_int_distribution<std::size_t> pick(0,
+                                                            options.keys - 1);
+
+            std::vector<std::string> queries;
+            queries.reserve(options.lookups);
+            for (std::size_t i = 0; i < options.lookups; ++i) {
+                if (i % 2 == 0)
+                    queries.push_back(user_name(pick(rng)));
+                else
+                    queries.push_back("nobody" + std::to_string(pick(rng)));
+            }
+            return queries;
+        }
+
+        template <typename Map>
+        void bench_map(lookup_options const &options, char const *name,
+                       std::string const &text,
+                       std::vector<std::string> const &queries) {
+            namespace cfg = sk::config;
+
+            auto const grammar = cfg::config<users_config<Map>>(
+                cfg::block<user>("user", &user::name,
+                                 &users_config<Map>::users,
+                                 cfg::option("uid", &user::uid)));
+
+            double parse_time = 0, lookup_time = 0;
+            std::uint64_t found = 0;
+
+            for (int run = 0; run < options.runs; ++run) {
+                users_config<Map> c;
+
+                auto start = clock::now();
+                cfg::parse(std::string_view(text), grammar, c);
+                auto t = seconds_since(start);
+                if (run == 0 || t < parse_time)
+                    parse_time = t;
+
+                // Sum the uids so the lookups can't be optimised away.
+                std::uint64_t sum = 0;
+                found = 0;
+
+                start = clock::now();
+                for (auto const &key : queries) {
+                    auto it = c.users.find(key);
+                    if (it != c.users.end()) {
+                        sum += static_cast<std::uint64_t>(it->second.uid);
+                        ++found;
+                    }
+                }
+                t = seconds_since(start);
+                if (run == 0 || t < lookup_time)
+                    lookup_time = t;
+
+                if (sum == 0 && found != 0)
+                    std::abort();
+            }
+
+            std::printf("%-26s %10.3f %12.3f %10.1f %10llu\n", name,
+                        parse_time, lookup_time,
+                        lookup_time * 1e9 /
+                            static_cast<double>(queries.size()),
+                        static_cast<unsigned long long>(found));
+        }
+
+        [[noreturn]] void usage() {
+            std::cerr << "usage: bench_lookup [--keys N] [--lookups N] "
+                         "[--seed N] [--runs N]\n";
+            std::exit(2);
+        }
+
+    } // namespace
+
+} // namespace sk::config::bench
+
+int main(int argc, char **argv) try {
+    namespace bench = sk::config::bench;
+
+    bench::lookup_options options;
+
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        auto value = [&]() -> std::string {
+            if (i + 1 == args.size())
+                bench::usage();
+            return std::string(args[++i]);
+        };
+
+        if (args[i] == "--keys")
+            options.keys = std::stoull(value());
+        else if (args[i] == "--lookups")
+            options.lookups = std::stoull(value());
+        else if (args[i] == "--seed")
+            options.seed = std::stoull(value());
+        else if (args[i] == "--runs")
+            options.runs = std::max(1, std::stoi(value()));
+        else
+            bench::usage();
+    }
+
+    if (options.keys == 0)
+        bench::usage();
+
+    auto const text = bench::make_config(options);
+    auto const queries = bench::make_queries(options);
+
+    std::printf("%zu keys, %zu lookups, fastest of %d runs\n\n",
+                options.keys, options.lookups, options.runs);
+    std::printf("%-26s %10s %12s %10s %10s\n", "map", "parse s",
+                "lookups s", "ns/find", "found");
+
+    using user = bench::user;
+    bench::bench_map<std::map<std::string, user>>(options, "std::map",
+                                                  text, queries);
+    bench::bench_map<std::unordered_map<std::string, user>>(
+        options, "std::unordered_map", text, queries);
+    bench::bench_map<boost::container::flat_map<std::string, user>>(
+        options, "boost::flat_map", text, queries);
+#if defined(__cpp_lib_flat_map)
+    bench::bench_map<std::flat_map<std::string, user>>(
+        options, "std::flat_map", text, queries);
+#endif
+#if defined(SK_CONFIG_BENCH_UNORDERED_FLAT_MAP)
+    bench::bench_map<boost::unordered_flat_map<std::string, user>>(
+        options, "boost::unordered_flat_map", text, queries);
+#endif
+    bench::bench_map<sk::config::frozen_map<std::string, user>>(
+        options, "frozen_map", text, queries);
+
+    return 0;
+} catch (std::exception const &e) {
+    std::cerr << "bench_lookup: " << e.what() << "\n";
+    return 1;
+}
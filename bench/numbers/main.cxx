@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * bench_numbers: compare number_parser, which uses std::from_chars, with
+ * the Spirit X3 parsers it replaced, on inputs of whitespace-separated
+ * random numbers.
+ *
+ *   bench_numbers [--count N] [--seed N] [--runs N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/parser/number.hxx>
+
+namespace sk::config::bench {
+
+    namespace {
+
+        namespace x3 = boost::spirit::x3;
+
+        struct number_options {
+            std::size_t count = 10000000;
+            std::uint64_t seed = 1;
+
+            // Time each benchmark this many times and keep the fastest.
+            int runs = 3;
+        };
+
+        template <typename T>
+        auto make_input(number_options const &options) -> std::string {
+            std::mt19937_64 rng(options.seed);
+            std::string text;
+            char buf[64];
+
+            for (std::size_t i = 0; i < options.count; ++i) {
+                int n;
+                if constexpr (std::is_integral_v<T>) {
+                    std::uniform_int_distribution<T> dist(
+                        std::numeric_limits<T>::min(),
+                        std::numeric_limits<T>::max());
+                    n = std::snprintf(buf, sizeof(buf), "%lld",
+                                      static_cast<long long>(dist(rng)));
+                } else {
+                    // Spread the values over a wide range of exponents.
+                    std::uniform_real_distribution<double> mantissa(-10, 10);
+                    std::uniform_int_distribution<int> exponent(-30, 30);
+                    auto v = static_cast<T>(mantissa(rng) *
+                                            std::pow(10.0, exponent(rng)));
+                    n = std::snprintf(buf, sizeof(buf), "%.*g",
+                                      std::numeric_limits<T>::max_digits10,
+                                      static_cast<double>(v));
+                }
+
+                text.append(buf, static_cast<std::size_t>(n));
+                text += ' ';
+            }
+            return text;
+        }
+
+        /*
+         * Parse every number in text with parser, and return the time
+         * taken by the fastest run.  The numbers are summed so the parse
+         * can't be optimised away, and the sum is returned in sum.
+         */
+        template <typename T, typename Parser>
+        auto time_parser(number_options const &options, std::string const &text,
+                         Parser const &parser, double &sum) -> double {
+            double best = 0;
+
+            for (int run = 0; run < options.runs; ++run) {
+                double total = 0;
+                std::size_t n = 0;
+
+                auto add = [&](auto &ctx) {
+                    total += static_cast<double>(x3::_attr(ctx));
+                    ++n;
+                };
+
+                char const *first = text.data();
+                char const *const last = text.data() + text.size();
+
+                auto const start = std::chrono::steady_clock::now();
+                bool ok = x3::phrase_parse(first, last, *parser[add],
+                                           x3::ascii::space);
+                auto const t = std::chrono::duration<double>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+
+                if (!ok || first != last || n != options.count) {
+                    std::cerr << "bench_numbers: parse failed\n";
+                    std::exit(1);
+                }
+
+                if (run == 0 || t < best)
+                    best = t;
+                sum = total;
+            }
+
+            return best;
+        }
+
+        void print(char const *name, std::string const &text,
+                   number_options const &options, double seconds,
+                   double sum) {
+            std::printf("%-32s %10.3f %10.1f %10.1f %14.6g\n", name, seconds,
+                        static_cast<double>(text.size()) / seconds / 1e6,
+                        seconds * 1e9 / static_cast<double>(options.count),
+                        sum);
+        }
+
+        template <typename T, typename X3Parser>
+        void bench_type(number_options const &options, char const *x3_name,
+                        char const *sk_name) {
+            auto const text = make_input<T>(options);
+
+            double x3_sum = 0, sk_sum = 0;
+            auto x3_time = time_parser<T>(options, text, X3Parser(), x3_sum);
+            auto sk_time = time_parser<T>(
+                options, text, detail::parser::number_parser<T>(), sk_sum);
+
+            print(x3_name, text, options, x3_time, x3_sum);
+            print(sk_name, text, options, sk_time, sk_sum);
+        }
+
+        [[noreturn]] void usage() {
+            std::cerr
+                << "usage: bench_numbers [--count N] [--seed N] [--runs N]\n";
+            std::exit(2);
+        }
+
+    } // namespace
+
+} // namespace sk::config::bench
+
+int main(int argc, char **argv) try {
+    namespace bench = sk::config::bench;
+    namespace x3 = boost::spirit::x3;
+
+    bench::number_options options;
+
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        auto value = [&]() -> std::string {
+            if (i + 1 == args.size())
+                bench::usage();
+            return std::string(args[++i]);
+        };
+
+        if (args[i] == "--count")
+            options.count = std::stoull(value());
+        else if (args[i] == "--seed")
+            options.seed = std::stoull(value());
+        else if (args[i] == "--runs")
+            options.runs = std::max(1, std::stoi(value()));
+        else
+            bench::usage();
+    }
+
+    std::printf("%zu numbers, fastest of %d runs\n\n", options.count,
+                options.runs);
+    std::printf("%-32s %10s %10s %10s %14s\n", "parser", "seconds", "MB/s",
+                "ns/number", "sum");
+
+    bench::bench_type<int, x3::int_parser<int>>(options, "x3::int_parser<int>",
+                                                "number_parser<int>");
+    bench::bench_type<long long, x3::int_parser<long long>>(
+        options, "x3::int_parser<long long>", "number_parser<long long>");
+    bench::bench_type<unsigned, x3::uint_parser<unsigned>>(
+        options, "x3::uint_parser<unsigned>", "number_parser<unsigned>");
+    bench::bench_type<float, x3::real_parser<float>>(
+        options, "x3::real_parser<float>", "number_parser<float>");
+    bench::bench_type<double, x3::real_parser<double>>(
+        options, "x3::real_parser<double>", "number_parser<double>");
+
+    return 0;
+} catch (std::exception const &e) {
+    std::cerr << "bench_numbers: " << e.what() << "\n";
+    return 1;
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_BENCH_BENCH_HXX_INCLUDED
+#define SK_CONFIG_BENCH_BENCH_HXX_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sk::config::bench {
+
+    struct bench_options {
+        // Size of the input for each parser_for type.
+        std::uint64_t size = 8 * 1024 * 1024;
+
+        // Size of the file for the parse_file() benchmarks.
+        std::uint64_t file_size = 64 * 1024 * 1024;
+
+        std::uint64_t seed = 1;
+
+        // Run each benchmark for at least this long.
+        double min_time = 1.0;
+
+        // Only run benchmarks whose name contains this.
+        std::string filter;
+
+        // Where to write the generated files.
+        std::filesystem::path directory;
+    };
+
+    struct result {
+        std::string name;
+        std::uint64_t bytes = 0;
+        std::uint64_t statements = 0;
+        std::uint64_t iterations = 0;
+
+        // The fastest iteration.
+        double seconds = 0;
+
+        // Peak resident set size in bytes, including the input, or 0 if
+        // it couldn't be measured.
+        std::uint64_t peak_rss = 0;
+
+        auto mb_per_s() const -> double {
+            return static_cast<double>(bytes) / seconds / 1e6;
+        }
+
+        auto statements_per_s() const -> double {
+            return static_cast<double>(statements) / seconds;
+        }
+    };
+
+    // Start measuring the peak RSS from now, if the platform allows it.
+    void reset_peak_rss();
+
+    // The peak RSS since reset_peak_rss(), or since the process started.
+    auto peak_rss() -> std::uint64_t;
+
+    inline auto selected(bench_options const &options, std::string_view name)
+        -> bool {
+        return name.find(options.filter) != std::string_view::npos;
+    }
+
+    /*
+     * Call f repeatedly for at least options.min_time, and at least
+     * once, and record the fastest call in r.
+     */
+    template <typename F>
+    void measure(bench_options const &options, result &r, F &&f) {
+        using clock = std::chrono::steady_clock;
+
+        auto const start = clock::now();
+        auto const until =
+            start + std::chrono::duration<double>(options.min_time);
+
+        r.iterations = 0;
+        r.seconds = 0;
+
+        do {
+            auto const t0 = clock::now();
+            f();
+            auto const t1 = clock::now();
+
+            double secs = std::chrono::duration<double>(t1 - t0).count();
+            if (r.iterations == 0 || secs < r.seconds)
+                r.seconds = secs;
+            ++r.iterations;
+        } while (clock::now() < until);
+    }
+
+    // One benchmark for each parser_for type, on generate_values() input.
+    void run_value_benchmarks(bench_options const &options,
+                              std::vector<result> &results);
+
+    // parse_file() on generate_config() files.
+    void run_file_benchmarks(bench_options const &options,
+                             std::vector<result> &results);
+
+} // namespace sk::config::bench
+
+#endif // SK_CONFIG_BENCH_BENCH_HXX_INCLUDED
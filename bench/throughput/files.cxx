@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * End-to-end throughput: parse_file() on generate_config() files, which
+ * mix nested blocks, comments, strings, heredocs, lists and maps.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sk/config.hxx>
+
+#include "bench.hxx"
+#include "generator.hxx"
+#include "grammar.hxx"
+
+namespace sk::config::bench {
+
+    namespace {
+
+        void bench_file(bench_options const &options, std::string name,
+                        generator_options gen, std::vector<result> &results) {
+            if (!selected(options, name))
+                return;
+
+            gen.seed = options.seed;
+            gen.size = options.file_size;
+
+            auto file_name = name;
+            std::ranges::replace(file_name, '/', '-');
+            auto const path = options.directory /
+                              ("sk-config-bench-" + file_name + ".conf");
+
+            generator_result generated;
+            {
+                std::ofstream out(path, std::ios::binary);
+                if (!out)
+                    throw std::runtime_error("cannot create " +
+                                             path.string());
+                generated = generate_config(gen, out);
+                if (!out.flush())
+                    throw std::runtime_error("cannot write " + path.string());
+            }
+
+            auto const grammar = server_grammar();
+
+            reset_peak_rss();
+
+            result r;
+            r.name = std::move(name);
+            r.bytes = generated.bytes;
+            r.statements = generated.statements;
+
+            try {
+                measure(options, r, [&] {
+                    bench_config c;
+                    sk::config::parse_file(path, grammar, c);
+                });
+            } catch (...) {
+                std::filesystem::remove(path);
+                throw;
+            }
+
+            r.peak_rss = peak_rss();
+            std::filesystem::remove(path);
+            results.push_back(std::move(r));
+        }
+
+    } // namespace
+
+    void run_file_benchmarks(bench_options const &options,
+                             std::vector<result> &results) {
+        generator_options gen;
+        bench_file(options, "parse_file", gen, results);
+
+        generator_options flat;
+        flat.depth = 1;
+        bench_file(options, "parse_file/flat", flat, results);
+
+        generator_options comments;
+        comments.comment_density = 0.5;
+        bench_file(options, "parse_file/comments", comments, results);
+
+        generator_options heredocs;
+        heredocs.heredoc_ratio = 0.5;
+        heredocs.string_length = 256;
+        bench_file(options, "parse_file/heredocs", heredocs, results);
+
+        generator_options large_maps;
+        large_maps.map_size = 64;
+        large_maps.list_length = 64;
+        bench_file(options, "parse_file/large-maps", large_maps, results);
+    }
+
+} // namespace sk::config::bench
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * generate_config: write a deterministic synthetic config for the
+ * end-to-end benchmark grammar.
+ *
+ *   generate_config [--seed N] [--size N] [--depth 1-3] [--blocks N]
+ *                   [--comments P] [--string-length N] [--heredocs P]
+ *                   [--list-length N] [--map-size N] OUTPUT
+ *
+ * Sizes accept K, M and G suffixes; OUTPUT may be - for stdout.  The
+ * same options always produce the same file.
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "generator.hxx"
+
+namespace {
+
+    [[noreturn]] void usage() {
+        std::cerr << "usage: generate_config [--seed N] [--size N] "
+                     "[--depth 1-3] [--blocks N]\n"
+                     "                       [--comments P] "
+                     "[--string-length N] [--heredocs P]\n"
+                     "                       [--list-length N] "
+                     "[--map-size N] OUTPUT\n";
+        std::exit(2);
+    }
+
+} // namespace
+
+int main(int argc, char **argv) try {
+    namespace bench = sk::config::bench;
+
+    bench::generator_options options;
+    std::string output;
+
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        auto value = [&]() -> std::string {
+            if (i + 1 == args.size())
+                usage();
+            return std::string(args[++i]);
+        };
+
+        if (args[i] == "--seed")
+            options.seed = std::stoull(value());
+        else if (args[i] == "--size")
+            options.size = bench::parse_size(value());
+        else if (args[i] == "--depth")
+            options.depth = std::stoi(value());
+        else if (args[i] == "--blocks")
+            options.blocks = std::stoull(value());
+        else if (args[i] == "--comments")
+            options.comment_density = std::stod(value());
+        else if (args[i] == "--string-length")
+            options.string_length = std::stoull(value());
+        else if (args[i] == "--heredocs")
+            options.heredoc_ratio = std::stod(value());
+        else if (args[i] == "--list-length")
+            options.list_length = std::stoull(value());
+        else if (args[i] == "--map-size")
+            options.map_size = std::stoull(value());
+        else if (output.empty() && !args[i].starts_with("--"))
+            output = args[i];
+        else
+            usage();
+    }
+
+    if (output.empty())
+        usage();
+
+    bench::generator_result result;
+    if (output == "-") {
+        result = bench::generate_config(options, std::cout);
+    } else {
+        std::ofstream out(output, std::ios::binary);
+        if (!out) {
+            std::cerr << "generate_config: cannot create " << output << "\n";
+            return 1;
+        }
+        result = bench::generate_config(options, out);
+        if (!out.flush()) {
+            std::cerr << "generate_config: cannot write " << output << "\n";
+            return 1;
+        }
+    }
+
+    std::cerr << result.bytes << " bytes, " << result.statements
+              << " statements\n";
+    return 0;
+} catch (std::exception const &e) {
+    std::cerr << "generate_config: " << e.what() << "\n";
+    return 1;
+}
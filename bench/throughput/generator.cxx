@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+
+#include "generator.hxx"
+
+namespace sk::config::bench {
+
+    namespace {
+
+        constexpr std::array<std::string_view, 16> words{
+            "alpha", "bravo",  "charlie", "delta", "echo",    "foxtrot",
+            "golf",  "hotel",  "india",   "juliet", "kilo",   "lima",
+            "mike",  "november", "oscar", "papa"};
+
+        /*
+         * Buffers the output and counts bytes and statements.  Writing
+         * to the ostream in large chunks keeps multi-gigabyte configs
+         * from being limited by the stream.
+         */
+        class writer {
+          public:
+            writer(generator_options const &options, std::ostream &out)
+                : options(options), rng(options.seed), out(out) {
+                buffer.reserve(flush_size + 4096);
+            }
+
+            ~writer() { flush(); }
+
+            auto result() -> generator_result {
+                return {bytes + buffer.size(), statements};
+            }
+
+            auto written() const -> std::uint64_t {
+                return bytes + buffer.size();
+            }
+
+            void flush() {
+                out.write(buffer.data(),
+                          static_cast<std::streamsize>(buffer.size()));
+                bytes += buffer.size();
+                buffer.clear();
+            }
+
+            void put(std::string_view s) {
+                buffer.append(s);
+                if (buffer.size() >= flush_size)
+                    flush();
+            }
+
+            void put(char c) { buffer.push_back(c); }
+
+            void put_number(auto n) {
+                char buf[32];
+                auto r = std::to_chars(buf, buf + sizeof(buf), n);
+                buffer.append(buf, r.ptr);
+            }
+
+            void indent(int level) { buffer.append(4 * level, ' '); }
+
+            // End a statement.
+            void end() {
+                put(";\n");
+                ++statements;
+            }
+
+            // End an item written by generate_items().
+            void end_item() {
+                put('\n');
+                ++statements;
+            }
+
+            void maybe_comment(int level) {
+                if (!rng.chance(options.comment_density))
+                    return;
+
+                indent(level);
+                if (rng.below(2) == 0) {
+                    put("# ");
+                    put_words(options.string_length, false);
+                    put('\n');
+                } else {
+                    put("/* ");
+                    put_words(options.string_length, false);
+                    put(" */\n");
+                }
+            }
+
+            void put_word() { put(words[rng.below(words.size())]); }
+
+            // Words separated by spaces, about length characters long.
+            void put_words(std::size_t length, bool escapes) {
+                auto target = rng.around(length);
+                std::size_t n = 0;
+                do {
+                    if (n)
+                        put(' ');
+                    auto w = words[rng.below(words.size())];
+                    put(w);
+                    n += w.size() + 1;
+                    if (escapes && rng.below(16) == 0) {
+                        put("\\\"");
+                        n += 2;
+                    }
+                } while (n < target);
+            }
+
+            void put_qstring() {
+                put('"');
+                put_words(options.string_length, true);
+                put('"');
+            }
+
+            void put_heredoc() {
+                put("<<<EOT\n");
+                auto lines = 1 + rng.below(4);
+                for (std::uint64_t i = 0; i < lines; ++i) {
+                    put_words(options.string_length * 2, false);
+                    put('\n');
+                }
+                put("EOT");
+            }
+
+            void put_int_list() {
+                auto n = std::max<std::uint64_t>(1, rng.around(
+                                                        options.list_length));
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    if (i)
+                        put(", ");
+                    put_number(rng.below(65536));
+                }
+            }
+
+            void put_string_list() {
+                auto n = std::max<std::uint64_t>(1, rng.around(
+                                                        options.list_length));
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    if (i)
+                        put(", ");
+                    if (rng.below(4) == 0)
+                        put_qstring();
+                    else
+                        put_word();
+                }
+            }
+
+            void put_value(value_kind kind) {
+                switch (kind) {
+                case value_kind::identifier:
+                    put_word();
+                    break;
+                case value_kind::qstring:
+                    put_qstring();
+                    break;
+                case value_kind::heredoc:
+                    put_heredoc();
+                    break;
+                case value_kind::integer:
+                    put_number(static_cast<int>(rng.below(2000000)) - 1000000);
+                    break;
+                case value_kind::real:
+                    put_number(static_cast<int>(rng.below(2000)) - 1000);
+                    put('.');
+                    put_number(rng.below(10000));
+                    break;
+                case value_kind::flag:
+                    // In a statement a flag has no value.
+                    break;
+                case value_kind::int_list:
+                    put_int_list();
+                    break;
+                case value_kind::string_list:
+                    put_string_list();
+                    break;
+                case value_kind::int_map:
+                    put_map(0, false);
+                    break;
+                case value_kind::string_map:
+                    put_map(0, true);
+                    break;
+                }
+            }
+
+            // A map body with keys unique across the output.
+            void put_map(int level, bool string_values) {
+                put("{\n");
+                auto n = std::max<std::uint64_t>(1,
+                                                 rng.around(options.map_size));
+                for (std::uint64_t i = 0; i < n; ++i) {
+                    indent(level + 1);
+                    put('k');
+                    put_number(next_key++);
+                    put(' ');
+                    if (string_values)
+                        put_qstring();
+                    else
+                        put_number(static_cast<int>(rng.below(2000000)) -
+                                   1000000);
+                    end();
+                }
+                indent(level);
+                put('}');
+            }
+
+            generator_options const &options;
+            random rng;
+
+          private:
+            static constexpr std::size_t flush_size = 1024 * 1024;
+
+            std::ostream &out;
+            std::string buffer;
+            std::uint64_t bytes = 0;
+            std::uint64_t statements = 0;
+            std::uint64_t next_key = 0;
+        };
+
+        // An option inside a block, preceded by an optional comment.
+        void option(writer &w, int level, std::string_view name) {
+            w.maybe_comment(level);
+            w.indent(level);
+            w.put(name);
+            w.put(' ');
+        }
+
+        void rule_block(writer &w, int level, std::uint64_t n) {
+            option(w, level, "rule");
+            w.put("\"r");
+            w.put_number(n);
+            w.put("\" {\n");
+
+            option(w, level + 1, "action");
+            w.put(w.rng.below(2) ? "allow" : "deny");
+            w.end();
+
+            option(w, level + 1, "ports");
+            w.put_int_list();
+            w.end();
+
+            w.indent(level);
+            w.put('}');
+            w.end();
+        }
+
+        void location_block(writer &w, int level, std::uint64_t n) {
+            option(w, level, "location");
+            w.put("\"/l");
+            w.put_number(n);
+            w.put("\" {\n");
+
+            option(w, level + 1, "root");
+            w.put_qstring();
+            w.end();
+
+            option(w, level + 1, "methods");
+            w.put_string_list();
+            w.end();
+
+            if (w.options.depth >= 3) {
+                auto rules = w.rng.around(w.options.blocks);
+                for (std::uint64_t i = 0; i < rules; ++i)
+                    rule_block(w, level + 1, i);
+            }
+
+            w.indent(level);
+            w.put('}');
+            w.end();
+        }
+
+        void server_block(writer &w, std::uint64_t n) {
+            option(w, 0, "server");
+            w.put("\"srv-");
+            w.put_number(n);
+            w.put("\" {\n");
+
+            option(w, 1, "port");
+            w.put_number(1024 + w.rng.below(60000));
+            w.end();
+
+            option(w, 1, "weight");
+            w.put_number(w.rng.below(1000));
+            w.put('.');
+            w.put_number(w.rng.below(100));
+            w.end();
+
+            option(w, 1, "description");
+            if (w.rng.chance(w.options.heredoc_ratio))
+                w.put_heredoc();
+            else
+                w.put_qstring();
+            w.end();
+
+            option(w, 1, "tags");
+            w.put_string_list();
+            w.end();
+
+            option(w, 1, "ports");
+            w.put_int_list();
+            w.end();
+
+            option(w, 1, "limits");
+            w.put_map(1, false);
+            w.end();
+
+            option(w, 1, "headers");
+            w.put_map(1, true);
+            w.end();
+
+            if (w.options.depth >= 2) {
+                auto locations = w.rng.around(w.options.blocks);
+                for (std::uint64_t i = 0; i < locations; ++i)
+                    location_block(w, 1, i);
+            }
+
+            w.put('}');
+            w.end();
+        }
+
+    } // namespace
+
+    auto generate_config(generator_options const &options, std::ostream &out)
+        -> generator_result {
+        writer w(options, out);
+
+        w.put("# Generated by generate_config, seed ");
+        w.put_number(options.seed);
+        w.put("\n\n");
+
+        for (std::uint64_t n = 0; w.written() < options.size; ++n)
+            server_block(w, n);
+
+        w.flush();
+        return w.result();
+    }
+
+    auto generate_values(value_kind kind, generator_options const &options,
+                         std::ostream &out) -> generator_result {
+        writer w(options, out);
+
+        while (w.written() < options.size) {
+            w.maybe_comment(0);
+            w.put('v');
+
+            if (kind != value_kind::flag)
+                w.put(' ');
+
+            w.put_value(kind);
+
+            w.end();
+        }
+
+        w.flush();
+        return w.result();
+    }
+
+    auto generate_items(value_kind kind, generator_options const &options,
+                        std::ostream &out) -> generator_result {
+        writer w(options, out);
+
+        while (w.written() < options.size) {
+            if (kind == value_kind::flag)
+                w.put(w.rng.below(2) ? "true" : "false");
+            else
+                w.put_value(kind);
+            w.end_item();
+        }
+
+        w.flush();
+        return w.result();
+    }
+
+    auto generate_comments(generator_options const &options,
+                           std::ostream &out) -> generator_result {
+        auto always = options;
+        always.comment_density = 1;
+
+        writer w(always, out);
+
+        while (w.written() < options.size) {
+            w.indent(static_cast<int>(w.rng.below(3)));
+            w.maybe_comment(0);
+            w.end_item();
+        }
+
+        w.flush();
+        return w.result();
+    }
+
+    auto parse_size(std::string_view s) -> std::uint64_t {
+        std::uint64_t n = 0;
+        auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), n);
+        if (ec != std::errc() || ptr == s.data())
+            throw std::invalid_argument("invalid size: " + std::string(s));
+
+        std::string_view suffix(ptr, s.data() + s.size() - ptr);
+        if (suffix.empty() || suffix == "B")
+            return n;
+        if (suffix == "K" || suffix == "KB")
+            return n << 10;
+        if (suffix == "M" || suffix == "MB")
+            return n << 20;
+        if (suffix == "G" || suffix == "GB")
+            return n << 30;
+
+        throw std::invalid_argument("invalid size: " + std::string(s));
+    }
+
+} // namespace sk::config::bench
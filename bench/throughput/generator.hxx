@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_BENCH_GENERATOR_HXX_INCLUDED
+#define SK_CONFIG_BENCH_GENERATOR_HXX_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace sk::config::bench {
+
+    /*
+     * splitmix64.  The <random> distributions are not specified exactly,
+     * so they can produce different configs on different standard
+     * libraries; this is the same everywhere.
+     */
+    class random {
+      public:
+        explicit random(std::uint64_t seed) : state(seed) {}
+
+        auto next() -> std::uint64_t {
+            std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        // A value in [0, n).
+        auto below(std::uint64_t n) -> std::uint64_t {
+            return n ? next() % n : 0;
+        }
+
+        // A value in [n/2, n + n/2], so the mean is n.
+        auto around(std::uint64_t n) -> std::uint64_t {
+            return n / 2 + below(n + 1);
+        }
+
+        // True with probability p.
+        auto chance(double p) -> bool {
+            return static_cast<double>(next() >> 11) * 0x1.0p-53 < p;
+        }
+
+      private:
+        std::uint64_t state;
+    };
+
+    struct generator_options {
+        std::uint64_t seed = 1;
+
+        // Stop after the top-level block which reaches this many bytes.
+        std::uint64_t size = 1024 * 1024;
+
+        // 1: server blocks only; 2: with location blocks; 3: with rule
+        // blocks inside locations.
+        int depth = 3;
+
+        // Mean number of blocks inside each block.
+        std::size_t blocks = 4;
+
+        // Chance of a comment before each statement.
+        double comment_density = 0.1;
+
+        // Mean length of strings.
+        std::size_t string_length = 24;
+
+        // Chance that a description is a heredoc instead of a string.
+        double heredoc_ratio = 0.05;
+
+        // Mean length of numeric and string lists.
+        std::size_t list_length = 8;
+
+        // Mean number of entries in each map.
+        std::size_t map_size = 4;
+    };
+
+    struct generator_result {
+        std::uint64_t bytes = 0;
+        std::uint64_t statements = 0;
+    };
+
+    /*
+     * Write a config for the end-to-end benchmark grammar (see
+     * server_grammar() in grammar.hxx, and files.cxx) to out:
+     *
+     *   server "srv-0" {
+     *       port 8080;
+     *       weight 1.5;
+     *       description "...";
+     *       tags alpha, beta;
+     *       ports 80, 443;
+     *       limits { k0 10; k1 20; };
+     *       headers { h0 "..."; };
+     *       location "/l0" {
+     *           root "...";
+     *           methods get, post;
+     *           rule "r0" { action allow; ports 1, 2; };
+     *       };
+     *   };
+     *
+     * The output depends only on the options.
+     */
+    auto generate_config(generator_options const &options, std::ostream &out)
+        -> generator_result;
+
+    // The values generate_values() can produce.
+    enum struct value_kind {
+        identifier,  // std::string: abc
+        qstring,     // std::string: "abc def"
+        heredoc,     // std::string: <<<EOT ... EOT
+        integer,     // int: -42
+        real,        // double: 4.25
+        flag,        // bool: no value, or true/false in generate_items()
+        int_list,    // std::vector<int>: 1, 2, 3
+        string_list, // std::vector<std::string>: a, "b c"
+        int_map,     // std::map<std::string, int>: { k0 1; k1 2; }
+        string_map,  // std::map<std::string, std::string>: { k0 "a"; }
+    };
+
+    /*
+     * Write `v <value>;` statements of one kind until options.size bytes
+     * have been written.  Map keys are unique across the whole output.
+     */
+    auto generate_values(value_kind kind, generator_options const &options,
+                         std::ostream &out) -> generator_result;
+
+    /*
+     * Write values of one kind, one per line and without option names,
+     * for driving a single parser directly.
+     */
+    auto generate_items(value_kind kind, generator_options const &options,
+                        std::ostream &out) -> generator_result;
+
+    // Write lines containing only whitespace and comments.
+    auto generate_comments(generator_options const &options,
+                           std::ostream &out) -> generator_result;
+
+    // Parse a size such as 4096, 64K, 16M or 2G.
+    auto parse_size(std::string_view s) -> std::uint64_t;
+
+} // namespace sk::config::bench
+
+#endif // SK_CONFIG_BENCH_GENERATOR_HXX_INCLUDED
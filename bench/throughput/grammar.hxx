@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_BENCH_GRAMMAR_HXX_INCLUDED
+#define SK_CONFIG_BENCH_GRAMMAR_HXX_INCLUDED
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace sk::config::bench {
+
+    /*
+     * The grammar for generate_config() output, used by the end-to-end
+     * benchmarks.
+     */
+
+    struct rule_config {
+        std::string name;
+        std::string action;
+        std::vector<int> ports;
+    };
+
+    struct location_config {
+        std::string name;
+        std::string root;
+        std::vector<std::string> methods;
+        std::vector<rule_config> rules;
+    };
+
+    struct server_config {
+        std::string name;
+        int port = 0;
+        double weight = 0;
+        std::string description;
+        std::vector<std::string> tags;
+        std::vector<int> ports;
+        std::map<std::string, int> limits;
+        std::map<std::string, std::string> headers;
+        std::vector<location_config> locations;
+    };
+
+    struct bench_config {
+        std::vector<server_config> servers;
+    };
+
+    inline auto server_grammar() {
+        namespace cfg = sk::config;
+
+        return cfg::config<bench_config>(cfg::block<server_config>(
+            "server", &server_config::name, &bench_config::servers,
+            cfg::option("port", &server_config::port),
+            cfg::option("weight", &server_config::weight),
+            cfg::option("description", &server_config::description),
+            cfg::option("tags", &server_config::tags),
+            cfg::option("ports", &server_config::ports),
+            cfg::option("limits", &server_config::limits),
+            cfg::option("headers", &server_config::headers),
+            cfg::block<location_config>(
+                "location", &location_config::name,
+                &server_config::locations,
+                cfg::option("root", &location_config::root),
+                cfg::option("methods", &location_config::methods),
+                cfg::block<rule_config>(
+                    "rule", &rule_config::name, &location_config::rules,
+                    cfg::option("action", &rule_config::action),
+                    cfg::option("ports", &rule_config::ports)))));
+    }
+
+} // namespace sk::config::bench
+
+#endif // SK_CONFIG_BENCH_GRAMMAR_HXX_INCLUDED
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * bench_throughput: measure MB/s, statements/s and peak RSS for each
+ * parser_for type and for parse_file().
+ *
+ *   bench_throughput [--size N] [--file-size N] [--seed N] [--min-time S]
+ *                    [--filter NAME] [--directory DIR] [--json FILE]
+ *   bench_throughput --compare BASE.json NEW.json
+ *
+ * --json writes one JSON object per benchmark per line, which --compare
+ * reads to show the change between two runs.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_WIN32)
+#    define WIN32_LEAN_AND_MEAN
+#    define NOMINMAX
+#    include <windows.h>
+#    include <psapi.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#    include <sys/resource.h>
+#endif
+
+#include "bench.hxx"
+#include "generator.hxx"
+
+namespace sk::config::bench {
+
+#if defined(__linux__)
+
+    // Writing 5 to clear_refs resets VmHWM (Linux 4.0 and later).
+    void reset_peak_rss() {
+        std::ofstream("/proc/self/clear_refs") << "5";
+    }
+
+    auto peak_rss() -> std::uint64_t {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.starts_with("VmHWM:"))
+                return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+        }
+        return 0;
+    }
+
+#elif defined(_WIN32)
+
+    // The peak working set can't be reset, so this is the process peak.
+    void reset_peak_rss() {}
+
+    auto peak_rss() -> std::uint64_t {
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+            return 0;
+        return pmc.PeakWorkingSetSize;
+    }
+
+#elif defined(__unix__) || defined(__APPLE__)
+
+    // ru_maxrss can't be reset, so this is the process peak.
+    void reset_peak_rss() {}
+
+    auto peak_rss() -> std::uint64_t {
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#    if defined(__APPLE__)
+        return usage.ru_maxrss;
+#    else
+        return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#    endif
+    }
+
+#else
+
+    void reset_peak_rss() {}
+    auto peak_rss() -> std::uint64_t { return 0; }
+
+#endif
+
+    namespace {
+
+        void print_results(std::vector<result> const &results) {
+            std::printf("%-28s %12s %10s %14s %12s\n", "benchmark", "bytes",
+                        "MB/s", "statements/s", "peak RSS MB");
+            for (auto const &r : results)
+                std::printf("%-28s %12llu %10.1f %14.0f %12.1f\n",
+                            r.name.c_str(),
+                            static_cast<unsigned long long>(r.bytes),
+                            r.mb_per_s(), r.statements_per_s(),
+                            static_cast<double>(r.peak_rss) / 1e6);
+        }
+
+        void write_json(std::ostream &out, std::vector<result> const &results,
+                        bench_options const &options) {
+            for (auto const &r : results) {
+                out << "{\"name\":\"" << r.name << "\""
+                    << ",\"seed\":" << options.seed
+                    << ",\"bytes\":" << r.bytes
+                    << ",\"statements\":" << r.statements
+                    << ",\"iterations\":" << r.iterations
+                    << ",\"seconds\":" << r.seconds
+                    << ",\"mb_per_s\":" << r.mb_per_s()
+                    << ",\"statements_per_s\":" << r.statements_per_s()
+                    << ",\"peak_rss\":" << r.peak_rss << "}\n";
+            }
+        }
+
+        // Read the fields we need back from write_json() output.
+        auto read_json(std::string const &filename)
+            -> std::map<std::string, result> {
+            std::ifstream in(filename);
+            if (!in)
+                throw std::runtime_error("cannot open " + filename);
+
+            auto field = [](std::string const &line, std::string_view name)
+                -> std::string {
+                auto key = "\"" + std::string(name) + "\":";
+                auto pos = line.find(key);
+                if (pos == std::string::npos)
+                    return {};
+                pos += key.size();
+                if (line[pos] == '"') {
+                    auto end = line.find('"', pos + 1);
+                    return line.substr(pos + 1, end - pos - 1);
+                }
+                auto end = line.find_first_of(",}", pos);
+                return line.substr(pos, end - pos);
+            };
+
+            std::map<std::string, result> results;
+            std::string line;
+            while (std::getline(in, line)) {
+                result r;
+                r.name = field(line, "name");
+                if (r.name.empty())
+                    continue;
+                r.bytes = std::strtoull(field(line, "bytes").c_str(),
+                                        nullptr, 10);
+                r.statements = std::strtoull(
+                    field(line, "statements").c_str(), nullptr, 10);
+                r.seconds = std::strtod(field(line, "seconds").c_str(),
+                                        nullptr);
+                r.peak_rss = std::strtoull(field(line, "peak_rss").c_str(),
+                                           nullptr, 10);
+                results[r.name] = r;
+            }
+            return results;
+        }
+
+        auto compare(std::string const &base_file, std::string const &new_file)
+            -> int {
+            auto base = read_json(base_file);
+            auto current = read_json(new_file);
+
+            std::printf("%-28s %10s %10s %8s %12s %12s\n", "benchmark",
+                        "base MB/s", "new MB/s", "change", "base RSS MB",
+                        "new RSS MB");
+            for (auto const &[name, r] : current) {
+                auto it = base.find(name);
+                if (it == base.end()) {
+                    std::printf("%-28s %10s %10.1f\n", name.c_str(), "-",
+                                r.mb_per_s());
+                    continue;
+                }
+
+                auto const &b = it->second;
+                std::printf("%-28s %10.1f %10.1f %+7.1f%% %12.1f %12.1f\n",
+                            name.c_str(), b.mb_per_s(), r.mb_per_s(),
+                            (r.mb_per_s() / b.mb_per_s() - 1) * 100,
+                            static_cast<double>(b.peak_rss) / 1e6,
+                            static_cast<double>(r.peak_rss) / 1e6);
+            }
+            return 0;
+        }
+
+        [[noreturn]] void usage() {
+            std::cerr
+                << "usage: bench_throughput [--size N] [--file-size N] "
+                   "[--seed N] [--min-time S]\n"
+                   "                        [--filter NAME] "
+                   "[--directory DIR] [--json FILE]\n"
+                   "       bench_throughput --compare BASE.json NEW.json\n";
+            std::exit(2);
+        }
+
+    } // namespace
+
+} // namespace sk::config::bench
+
+int main(int argc, char **argv) try {
+    namespace bench = sk::config::bench;
+
+    bench::bench_options options;
+    options.directory = std::filesystem::temp_directory_path();
+    std::string json;
+
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        auto value = [&]() -> std::string {
+            if (i + 1 == args.size())
+                bench::usage();
+            return std::string(args[++i]);
+        };
+
+        if (args[i] == "--size")
+            options.size = bench::parse_size(value());
+        else if (args[i] == "--file-size")
+            options.file_size = bench::parse_size(value());
+        else if (args[i] == "--seed")
+            options.seed = std::stoull(value());
+        else if (args[i] == "--min-time")
+            options.min_time = std::stod(value());
+        else if (args[i] == "--filter")
+            options.filter = value();
+        else if (args[i] == "--directory")
+            options.directory = value();
+        else if (args[i] == "--json")
+            json = value();
+        else if (args[i] == "--compare" && args.size() == 3)
+            return bench::compare(std::string(args[1]), std::string(args[2]));
+        else
+            bench::usage();
+    }
+
+    std::vector<bench::result> results;
+    bench::run_value_benchmarks(options, results);
+    bench::run_file_benchmarks(options, results);
+
+    bench::print_results(results);
+
+    if (!json.empty()) {
+        std::ofstream out(json);
+        bench::write_json(out, results, options);
+        if (!out.flush()) {
+            std::cerr << "cannot write " << json << "\n";
+            return 1;
+        }
+    }
+
+    return 0;
+} catch (std::exception const &e) {
+    std::cerr << "bench_throughput: " << e.what() << "\n";
+    return 1;
+}
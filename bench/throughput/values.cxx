@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Throughput of each parser_for type on its own: a config containing
+ * nothing but `v <value>;` statements.
+ */
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sk/config.hxx>
+
+#include "bench.hxx"
+#include "generator.hxx"
+
+namespace sk::config::bench {
+
+    namespace {
+
+        template <typename T> struct value_config {
+            T v{};
+        };
+
+        template <typename T>
+        void bench_value(bench_options const &options, std::string name,
+                         value_kind kind, std::vector<result> &results) {
+            if (!selected(options, name))
+                return;
+
+            generator_options gen;
+            gen.seed = options.seed;
+            gen.size = options.size;
+
+            std::ostringstream strm;
+            auto generated = generate_values(kind, gen, strm);
+            std::string const text = std::move(strm).str();
+
+            auto const grammar = sk::config::config<value_config<T>>(
+                sk::config::option("v", &value_config<T>::v));
+
+            reset_peak_rss();
+
+            result r;
+            r.name = std::move(name);
+            r.bytes = generated.bytes;
+            r.statements = generated.statements;
+
+            // Parse a string_view, which is what parse_file() parses.
+            measure(options, r, [&] {
+                value_config<T> c;
+                sk::config::parse(std::string_view(text), grammar, c);
+            });
+
+            r.peak_rss = peak_rss();
+            results.push_back(std::move(r));
+        }
+
+    } // namespace
+
+    void run_value_benchmarks(bench_options const &options,
+                              std::vector<result> &results) {
+        using string_int_map = std::map<std::string, int>;
+        using string_string_map = std::map<std::string, std::string>;
+        using string_int_umap = std::unordered_map<std::string, int>;
+        using string_int_fmap = frozen_map<std::string, int>;
+
+        bench_value<std::string>(options, "string/identifier",
+                                 value_kind::identifier, results);
+        bench_value<std::string>(options, "string/qstring",
+                                 value_kind::qstring, results);
+        bench_value<std::string>(options, "string/heredoc",
+                                 value_kind::heredoc, results);
+        bench_value<int>(options, "int", value_kind::integer, results);
+        bench_value<double>(options, "double", value_kind::real, results);
+        bench_value<bool>(options, "bool", value_kind::flag, results);
+        bench_value<std::vector<int>>(options, "vector<int>",
+                                      value_kind::int_list, results);
+        bench_value<std::vector<std::string>>(options, "vector<string>",
+                                              value_kind::string_list,
+                                              results);
+        bench_value<string_int_map>(options, "map<string,int>",
+                                    value_kind::int_map, results);
+        bench_value<string_string_map>(options, "map<string,string>",
+                                       value_kind::string_map, results);
+        bench_value<string_int_umap>(options, "unordered_map<string,int>",
+                                     value_kind::int_map, results);
+        bench_value<string_int_fmap>(options, "frozen_map<string,int>",
+                                     value_kind::int_map, results);
+    }
+
+} // namespace sk::config::bench
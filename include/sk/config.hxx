@@ -32,12 +32,15 @@
 // Include all supported parser types.
 
 #include <sk/config/parser/deque.hxx>
+#include <sk/config/parser/frozen_map.hxx>
+#include <sk/config/parser/interned_string.hxx>
 #include <sk/config/parser/list.hxx>
 #include <sk/config/parser/map.hxx>
 #include <sk/config/parser/numeric.hxx>
 #include <sk/config/parser/pair.hxx>
 #include <sk/config/parser/set.hxx>
 #include <sk/config/parser/string.hxx>
+#include <sk/config/parser/string_view.hxx>
 #include <sk/config/parser/tuple.hxx>
 #include <sk/config/parser/unordered_set.hxx>
 #include <sk/config/parser/unordered_map.hxx>
@@ -48,7 +51,16 @@
 #include <sk/config/block.hxx>
 #include <sk/config/config.hxx>
 
-#include <sk/config/parse.hxx> 
+#include <sk/config/parse.hxx>
+#include <sk/config/try_parse.hxx>
+#include <sk/config/include_cache.hxx>
+#include <sk/config/incremental_parser.hxx>
+#include <sk/config/parse_files.hxx>
+#include <sk/config/parse_parallel.hxx>
+#include <sk/config/reparser.hxx>
+#include <sk/config/live.hxx>
+#include <sk/config/snapshot.hxx>
+#include <sk/config/parse_file_cached.hxx>
 
 
 #endif // SK_CONFIG_HXX_INCLUDED
@@ -33,8 +33,12 @@
 
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/described.hxx>
+#include <sk/config/detail/freeze.hxx>
 #include <sk/config/detail/make_member_parser.hxx>
 #include <sk/config/detail/parser/braced.hxx>
+#include <sk/config/detail/parser/expect.hxx>
+#include <sk/config/detail/parser/keywords.hxx>
 #include <sk/config/detail/parser/option_terminator.hxx>
 #include <sk/config/detail/propagate.hxx>
 #include <sk/config/detail/rule.hxx>
@@ -50,16 +54,24 @@ namespace sk::config {
     auto block(auto label, ParentValueType ParentType::*mm,
                Members &&...members) {
         namespace x3 = boost::spirit::x3;
+        using detail::parser::expect;
 
-        auto member_parser = *(... | std::forward<Members>(members));
+        auto codec =
+            detail::make_struct_codec<BlockType>(detail::entry_of(members)...);
+        auto member_parser = *detail::parser::make_keywords(
+            std::forward<Members>(members)...);
         auto braced_members = detail::parser::braced_parser(member_parser);
 
         auto do_nothing = [&](auto &) {};
 
-        auto parser = x3::as_parser(label)            //
-                      > -(braced_members[do_nothing]) //
-                      > x3::no_skip[detail::parser::option_terminator];
-        return detail::rule<BlockType>(label, parser)[detail::propagate(mm)];
+        auto parser = detail::parser::freeze_scope(
+            x3::as_parser(label)                                    //
+            >> expect[-(braced_members[do_nothing])]                //
+            >> expect[x3::no_skip[detail::parser::option_terminator]]);
+        return detail::described(
+            detail::rule<BlockType>(label, parser)[detail::propagate(mm)],
+            detail::member_entry<ParentType, ParentValueType, decltype(codec)>{
+                mm, codec, detail::label_string(label)});
     }
 
     template <typename BlockType, typename NameType, typename ParentType,
@@ -67,17 +79,26 @@ namespace sk::config {
     auto block(auto label, NameType BlockType::*name,
                ParentValueType ParentType::*mm, Members &&...members) {
         namespace x3 = boost::spirit::x3;
+        using detail::parser::expect;
 
-        auto member_parser = *(... | std::forward<Members>(members));
+        auto codec = detail::make_struct_codec<BlockType>(
+            detail::member_entry<BlockType, NameType>{name, {}, ""},
+            detail::entry_of(members)...);
+        auto member_parser = *detail::parser::make_keywords(
+            std::forward<Members>(members)...);
         auto braced_members = detail::parser::braced_parser(member_parser);
 
         auto do_nothing = [&](auto &) {};
-        auto parser = x3::as_parser(label)               //
-                      > detail::make_member_parser(name) //
-                      > -(braced_members[do_nothing])    //
-                      > x3::no_skip[detail::parser::option_terminator];
-        return detail::rule<BlockType>(
-            label, parser)[detail::propagate_named(mm, name)];
+        auto parser = detail::parser::freeze_scope(
+            x3::as_parser(label)                                    //
+            >> expect[detail::make_member_parser(name)]             //
+            >> expect[-(braced_members[do_nothing])]                //
+            >> expect[x3::no_skip[detail::parser::option_terminator]]);
+        return detail::described(
+            detail::rule<BlockType>(label,
+                                    parser)[detail::propagate_named(mm, name)],
+            detail::member_entry<ParentType, ParentValueType, decltype(codec)>{
+                mm, codec, detail::label_string(label)});
     }
 
 } // namespace sk::config
@@ -33,7 +33,15 @@
 
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/described.hxx>
+#include <sk/config/detail/freeze.hxx>
 #include <sk/config/detail/make_member_parser.hxx>
+#include <sk/config/detail/parser/expect.hxx>
+#ifndef BOOST_NO_EXCEPTIONS
+#    include <sk/config/detail/parser/include.hxx>
+#endif
+#include <sk/config/detail/parser/intern_scope.hxx>
+#include <sk/config/detail/parser/keywords.hxx>
 #include <sk/config/detail/rule.hxx>
 
 namespace sk::config {
@@ -46,13 +54,32 @@ namespace sk::config {
     template <typename T, typename... Members>
     auto config(Members &&...members) {
         namespace x3 = boost::spirit::x3;
+        using detail::parser::expect;
 
-        auto member_parser = *(... | std::forward<Members>(members));
-
+        auto codec = detail::make_struct_codec<T>(detail::entry_of(members)...);
+        auto members_ =
+            detail::parser::make_keywords(std::forward<Members>(members)...);
         auto do_nothing = [&](auto &) {};
-        auto parser = x3::eps > member_parser[do_nothing] > x3::eoi;
 
-        return detail::rule<T>("config", parser);
+#ifdef BOOST_NO_EXCEPTIONS
+        // Include statements report errors by throwing, so they're not
+        // available without exceptions.
+        auto member_parser = *members_;
+        auto parser =
+            x3::eps >> expect[member_parser[do_nothing]] >> expect[x3::eoi];
+#else
+        auto include =
+            detail::parser::include_parser<T, decltype(members_)>(members_);
+        auto member_parser = *(include | members_);
+        auto parser = detail::parser::include_scope(
+            x3::eps >> expect[member_parser[do_nothing]] >> expect[x3::eoi]);
+#endif
+
+        return detail::described(
+            detail::rule<T>("config",
+                            detail::parser::intern_scope(
+                                detail::parser::freeze_scope(parser))),
+            codec);
     }
 
 } // namespace sk::config::parser
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_DESCRIBED_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_DESCRIBED_HXX_INCLUDED
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/snapshot.hxx>
+
+namespace sk::config::detail {
+
+    /*
+     * described<Subject, Info>: a parser which behaves exactly like
+     * Subject, but also carries a description of what it parses.  This is
+     * used by option(), block() and config() to record which struct
+     * members they set, so that a parsed configuration can be stored.
+     */
+    template <typename Subject, typename Info>
+    struct described
+        : boost::spirit::x3::unary_parser<Subject, described<Subject, Info>> {
+        using base_type =
+            boost::spirit::x3::unary_parser<Subject, described<Subject, Info>>;
+        static bool const is_pass_through_unary = true;
+
+        Info info;
+
+        described(Subject const &subject, Info info_)
+            : base_type(subject), info(std::move(info_)) {}
+
+        template <typename Iterator, typename Context, typename RContext,
+                  typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, RContext &rcontext,
+                   Attribute &attr) const {
+            return this->subject.parse(first, last, context, rcontext, attr);
+        }
+    };
+
+    template <typename T> struct is_described : std::false_type {};
+    template <typename Subject, typename Info>
+    struct is_described<described<Subject, Info>> : std::true_type {};
+
+    // Return the member_entry for a member parser.
+    template <typename Member> auto entry_of(Member const &member) {
+        if constexpr (is_described<std::remove_cvref_t<Member>>::value)
+            return member.info;
+        else
+            return unknown_entry{};
+    }
+
+    // Return the label of a member parser, or "" if it doesn't have one.
+    template <typename Member>
+    auto label_of(Member const &member) -> std::string {
+        if constexpr (is_described<std::remove_cvref_t<Member>>::value)
+            return member.info.label;
+        else
+            return {};
+    }
+
+    // Create the struct_codec for a struct with the given member entries.
+    template <typename T, typename... Entries>
+    auto make_struct_codec(Entries... entries) {
+        return struct_codec<T, Entries...>{{std::move(entries)...}};
+    }
+
+} // namespace sk::config::detail
+
+namespace boost::spirit::x3 {
+
+    template <typename Subject, typename Info>
+    struct get_info<sk::config::detail::described<Subject, Info>> {
+        typedef std::string result_type;
+        result_type operator()(
+            sk::config::detail::described<Subject, Info> const &p) const {
+            return what(p.subject);
+        }
+    };
+
+} // namespace boost::spirit::x3
+
+#endif // SK_CONFIG_DETAIL_DESCRIBED_HXX_INCLUDED
@@ -43,7 +43,10 @@
 
 #include <boost/spirit/home/x3/support/ast/position_tagged.hpp>
 #include <boost/spirit/home/x3/support/utility/utf8.hpp>
+#include <algorithm>
+#include <iterator>
 #include <ostream>
+#include <vector>
 
 #include <sk/config/error_detail.hxx>
 
@@ -56,14 +59,31 @@ namespace sk::config::detail {
       public:
         typedef Iterator iterator_type;
 
+        /*
+         * first_line_ is the line number of first in the original input;
+         * this is used when the input is only part of a larger file.
+         */
         error_formatter(Iterator first, Iterator last, OutputIterator err_out_,
-                        std::string file_ = "", int tabs_ = 4)
+                        std::string file_ = "", int tabs_ = 4,
+                        std::size_t first_line_ = 1)
             : err_out(err_out_), file(file_), tabs(tabs_),
-              pos_cache(first, last) {}
+              first_line(first_line_), pos_cache(first, last) {}
 
         typedef void result_type;
 
-        void operator()(Iterator err_pos, std::string const &error_message);
+        // Create an error_detail for an error at err_pos.
+        auto format(Iterator err_pos, std::string const &error_message) const
+            -> error_detail;
+
+        void operator()(Iterator err_pos, std::string const &error_message) {
+            *err_out++ = format(err_pos, error_message);
+        }
+
+        // Report an error which was already formatted, such as one from
+        // an included file.
+        void report(error_detail detail) {
+            *err_out++ = std::move(detail);
+        }
         void operator()(Iterator err_first, Iterator err_last,
                         std::string const &error_message);
         void operator()(boost::spirit::x3::position_tagged pos,
@@ -87,17 +107,23 @@ namespace sk::config::detail {
             return pos_cache;
         }
 
+        auto filename() const -> std::string const & { return file; }
+
       private:
         auto get_line(Iterator line_start, Iterator last) const -> std::string;
         void skip_whitespace(Iterator &err_pos, Iterator last) const;
         void skip_non_whitespace(Iterator &err_pos, Iterator last) const;
-        Iterator get_line_start(Iterator first, Iterator pos) const;
-        std::size_t position(Iterator i) const;
+        auto line_index() const -> std::vector<std::size_t> const &;
 
         OutputIterator err_out;
         std::string file;
         int tabs;
+        std::size_t first_line;
         boost::spirit::x3::position_cache<std::vector<Iterator>> pos_cache;
+
+        // The offset of the start of each line, built the first time an
+        // error is formatted.
+        mutable std::vector<std::size_t> line_starts;
     };
 
     template <typename Iterator, typename OutputIterator>
@@ -145,31 +171,34 @@ namespace sk::config::detail {
         }
     }
 
-    template <class Iterator, typename OutputIterator>
-    inline Iterator error_formatter<Iterator, OutputIterator>::get_line_start(
-        Iterator first, Iterator pos) const {
-        Iterator latest = first;
-        for (Iterator i = first; i != pos; ++i)
-            if (*i == '\r' || *i == '\n')
-                latest = i;
-        return latest;
-    }
-
+    /*
+     * Return the offsets of the start of each line.  A line ends with
+     * "\r\n", "\r" or "\n".
+     */
     template <typename Iterator, typename OutputIterator>
-    std::size_t
-    error_formatter<Iterator, OutputIterator>::position(Iterator i) const {
-        std::size_t line{1};
+    auto error_formatter<Iterator, OutputIterator>::line_index() const
+        -> std::vector<std::size_t> const & {
+        if (!line_starts.empty())
+            return line_starts;
+
+        line_starts.push_back(0);
+
+        std::size_t offset = 0;
         typename std::iterator_traits<Iterator>::value_type prev{0};
 
-        for (Iterator pos = pos_cache.first(); pos != i; ++pos) {
+        for (Iterator pos = pos_cache.first(); pos != pos_cache.last();
+             ++pos, ++offset) {
             auto c = *pos;
             switch (c) {
             case '\n':
-                if (prev != '\r')
-                    ++line;
+                if (prev == '\r')
+                    // Move the start of the line past the \n.
+                    ++line_starts.back();
+                else
+                    line_starts.push_back(offset + 1);
                 break;
             case '\r':
-                ++line;
+                line_starts.push_back(offset + 1);
                 break;
             default:
                 break;
@@ -177,12 +206,13 @@ namespace sk::config::detail {
             prev = c;
         }
 
-        return line;
+        return line_starts;
     }
 
     template <typename Iterator, typename OutputIterator>
-    void error_formatter<Iterator, OutputIterator>::operator()(
-        Iterator err_pos, std::string const &error_message) {
+    auto error_formatter<Iterator, OutputIterator>::format(
+        Iterator err_pos, std::string const &error_message) const
+        -> error_detail {
         Iterator first = pos_cache.first();
         Iterator last = pos_cache.last();
 
@@ -191,43 +221,29 @@ namespace sk::config::detail {
         // make sure err_pos does not point to white space
         skip_whitespace(err_pos, last);
 
-        err.file = file;
-        err.line = position(err_pos);
-        err.message = error_message;
+        // Find the line containing err_pos.  Since err_pos isn't
+        // whitespace, it can't be the \n of a \r\n.
+        auto const &lines = line_index();
+        auto offset = static_cast<std::size_t>(std::distance(first, err_pos));
+        auto line = std::upper_bound(lines.begin(), lines.end(), offset) - 1;
+        auto nline = static_cast<std::size_t>(line - lines.begin());
 
-        Iterator start = get_line_start(first, err_pos);
-        if (start != first)
-            ++start;
+        Iterator start = std::next(first, static_cast<std::ptrdiff_t>(*line));
 
+        err.file = file;
+        err.line = first_line + nline;
+        err.message = error_message;
         err.context = get_line(start, last);
-        err.column = static_cast<std::size_t>(std::distance(start, err_pos));
+        err.column = offset - *line;
 
-        *err_out++ = err;
+        return err;
     }
 
     template <typename Iterator, typename OutputIterator>
     void error_formatter<Iterator, OutputIterator>::operator()(
-        Iterator err_first, Iterator err_last,
+        Iterator err_first, Iterator /*err_last*/,
         std::string const &error_message) {
-        Iterator first = pos_cache.first();
-        Iterator last = pos_cache.last();
-
-        error_detail err;
-
-        // make sure err_pos does not point to white space
-        skip_whitespace(err_first, last);
-
-        err.file = file;
-        err.line = position(err_first);
-        err.message = error_message;
-
-        Iterator start = get_line_start(first, err_first);
-        if (start != first)
-            ++start;
-        err.context = get_line(start, last);
-        err.column = std::distance(start, err_first);
-
-        *err_out++ = err;
+        *err_out++ = format(err_first, error_message);
     }
 
     template <typename Iterator, typename OutputIterator>
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_FILE_WATCHER_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_FILE_WATCHER_HXX_INCLUDED
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <system_error>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<sys/inotify.h>)
+#    define SK_CONFIG_HAVE_INOTIFY 1
+#endif
+
+#ifdef SK_CONFIG_HAVE_INOTIFY
+#    include <fcntl.h>
+#    include <poll.h>
+#    include <sys/inotify.h>
+#    include <unistd.h>
+#endif
+
+namespace sk::config::detail {
+
+    /*
+     * file_watcher: wait for a set of files to change.
+     *
+     * On Linux this uses inotify to watch the directories containing the
+     * files, so files which are replaced by renaming a new file over them
+     * (as most editors do) are noticed.  Elsewhere, wait() just waits
+     * for the timeout and the caller is expected to check the files
+     * itself.
+     *
+     * watch() and stop() may be called from any thread; wait() should
+     * only be called from one thread.
+     */
+    class file_watcher {
+      public:
+        file_watcher();
+        ~file_watcher();
+
+        file_watcher(file_watcher const &) = delete;
+        file_watcher &operator=(file_watcher const &) = delete;
+
+        // Replace the set of watched files.
+        void watch(std::vector<std::filesystem::path> const &files);
+
+        /*
+         * Wait until a watched file might have changed, the timeout
+         * expires, or stop() is called.  Returns true if a file changed.
+         */
+        auto wait(std::chrono::milliseconds timeout) -> bool;
+
+        // Wake up wait().
+        void stop();
+
+      private:
+        std::mutex mutex;
+        std::set<std::filesystem::path> names;
+
+#ifdef SK_CONFIG_HAVE_INOTIFY
+        int fd = -1;
+        int wake[2] = {-1, -1};
+        std::map<int, std::filesystem::path> directories;
+#else
+        std::condition_variable cv;
+        bool stopped = false;
+#endif
+    };
+
+#ifdef SK_CONFIG_HAVE_INOTIFY
+
+    inline file_watcher::file_watcher() {
+        fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd == -1)
+            throw std::system_error(errno, std::system_category(),
+                                    "inotify_init1");
+
+        if (::pipe2(wake, O_NONBLOCK | O_CLOEXEC) == -1) {
+            auto err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::system_category(), "pipe2");
+        }
+    }
+
+    inline file_watcher::~file_watcher() {
+        ::close(fd);
+        ::close(wake[0]);
+        ::close(wake[1]);
+    }
+
+    inline void
+    file_watcher::watch(std::vector<std::filesystem::path> const &files) {
+        constexpr auto mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+                              IN_CREATE | IN_DELETE | IN_ATTRIB;
+
+        std::lock_guard lock(mutex);
+
+        names.clear();
+        std::set<std::filesystem::path> wanted;
+
+        for (auto &&file : files) {
+            names.insert(file);
+            wanted.insert(file.parent_path());
+        }
+
+        // Stop watching directories we don't need any more.
+        for (auto it = directories.begin(); it != directories.end();) {
+            if (wanted.erase(it->second) == 0) {
+                ::inotify_rm_watch(fd, it->first);
+                it = directories.erase(it);
+            } else
+                ++it;
+        }
+
+        // Watch any new ones.  A directory which doesn't exist can't be
+        // watched, but we'll try again after the next reload.
+        for (auto &&dir : wanted) {
+            int wd = ::inotify_add_watch(fd, dir.c_str(), mask);
+            if (wd != -1)
+                directories[wd] = dir;
+        }
+    }
+
+    inline auto file_watcher::wait(std::chrono::milliseconds timeout) -> bool {
+        ::pollfd fds[2] = {{fd, POLLIN, 0}, {wake[0], POLLIN, 0}};
+
+        if (::poll(fds, 2, static_cast<int>(timeout.count())) <= 0)
+            return false;
+
+        if (fds[1].revents != 0) {
+            char buf[64];
+            while (::read(wake[0], buf, sizeof(buf)) > 0)
+                ;
+            return false;
+        }
+
+        std::lock_guard lock(mutex);
+        bool changed = false;
+
+        alignas(::inotify_event) char buf[4096];
+        for (;;) {
+            auto n = ::read(fd, buf, sizeof(buf));
+            if (n <= 0)
+                break;
+
+            for (char *p = buf; p < buf + n;) {
+                auto *event = reinterpret_cast<::inotify_event *>(p);
+                p += sizeof(::inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    changed = true;
+                    continue;
+                }
+
+                auto dir = directories.find(event->wd);
+                if (dir == directories.end() || event->len == 0)
+                    continue;
+
+                if (names.contains(dir->second / event->name))
+                    changed = true;
+            }
+        }
+
+        return changed;
+    }
+
+    inline void file_watcher::stop() {
+        char c = 0;
+        [[maybe_unused]] auto n = ::write(wake[1], &c, 1);
+    }
+
+#else
+
+    inline file_watcher::file_watcher() = default;
+    inline file_watcher::~file_watcher() = default;
+
+    inline void
+    file_watcher::watch(std::vector<std::filesystem::path> const &files) {
+        std::lock_guard lock(mutex);
+        names = {files.begin(), files.end()};
+    }
+
+    inline auto file_watcher::wait(std::chrono::milliseconds timeout) -> bool {
+        std::unique_lock lock(mutex);
+        cv.wait_for(lock, timeout, [&] { return stopped; });
+        stopped = false;
+        return false;
+    }
+
+    inline void file_watcher::stop() {
+        {
+            std::lock_guard lock(mutex);
+            stopped = true;
+        }
+        cv.notify_all();
+    }
+
+#endif
+
+} // namespace sk::config::detail
+
+#endif // SK_CONFIG_DETAIL_FILE_WATCHER_HXX_INCLUDED
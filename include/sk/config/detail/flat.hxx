@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_FLAT_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_FLAT_HXX_INCLUDED
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/freeze.hxx>
+#include <sk/config/detail/memory_resource.hxx>
+#include <sk/config/detail/parser/expect.hxx>
+#include <sk/config/detail/propagate.hxx>
+
+namespace sk::config::detail {
+
+    /*
+     * Flat containers keep their elements in one sorted array, so
+     * inserting them one at a time moves every later element each time.
+     * Instead, the parsed values are sorted once and checked for
+     * duplicates, then inserted as a single sorted range: the container
+     * appends the range and merges it with whatever it already holds.
+     *
+     * Tag is the container's "sorted and unique" tag type, e.g.
+     * boost::container::ordered_unique_range or std::sorted_unique.
+     */
+    template <typename Container, typename T>
+    void flat_insert_sorted(auto &ctx, Container &to, std::vector<T> &from,
+                            auto tag, auto proj, char const *what) {
+        namespace x3 = boost::spirit::x3;
+
+        use_resource(ctx, to);
+
+        if (from.empty())
+            return;
+
+        std::ranges::sort(from, std::less<>(), proj);
+
+        // Since from is sorted, two values are equal if the first one
+        // isn't less than the second.
+        auto dup = std::ranges::adjacent_find(
+            from,
+            [](auto const &a, auto const &b) { return !(a < b); }, proj);
+
+        auto size = to.size();
+        if (dup == from.end()) {
+            // Values which are already in the container are not inserted,
+            // which the size check below reports as duplicates.
+            to.insert(tag, std::make_move_iterator(from.begin()),
+                      std::make_move_iterator(from.end()));
+
+            if (to.size() == size + from.size())
+                return;
+        }
+
+        auto it = x3::_where(ctx).begin();
+        detail::parser::action_failed(it, what, ctx);
+    }
+
+    // flat_set<T> <- vector<T>
+    template <typename Set, typename U>
+    void flat_set_propagate(auto &ctx, Set &to, std::vector<U> &from,
+                            auto tag) {
+        flat_insert_sorted(ctx, to, from, tag, std::identity(),
+                           "unique value");
+    }
+
+    /*
+     * flat_map<T, U> <- vector<pair<K, V>>
+     *
+     * As for std::map, the parsed items might not have the map's own key
+     * and value types, in which case they're converted into a vector of
+     * the map's value_type first.
+     */
+    template <typename Map, typename K, typename V>
+    void flat_map_propagate(auto &ctx, Map &to,
+                            std::vector<std::pair<K, V>> &from, auto tag) {
+        using value_type = typename Map::value_type;
+
+        if constexpr (std::is_same_v<std::pair<K, V>, value_type>) {
+            flat_insert_sorted(ctx, to, from, tag, &value_type::first,
+                               "a block");
+        } else {
+            std::vector<value_type> items;
+            items.reserve(from.size());
+
+            for (auto &&item : from) {
+                auto &v = items.emplace_back(
+                    std::piecewise_construct,
+                    std::forward_as_tuple(std::move(item.first)),
+                    std::tuple<>());
+                propagate_value(ctx, v.second, item.second);
+            }
+
+            flat_insert_sorted(ctx, to, items, tag, &value_type::first,
+                               "a block");
+        }
+    }
+
+    /*
+     * The named blocks for a flat map, kept in key order until the object
+     * containing the map has been parsed, then inserted as a single sorted
+     * range.
+     */
+    template <typename Map, typename Tag> struct flat_map_blocks {
+        std::map<typename Map::key_type, typename Map::mapped_type,
+                 typename Map::key_compare>
+            blocks;
+
+        void finish(Map &to) {
+            to.insert(Tag(), std::make_move_iterator(blocks.begin()),
+                      std::make_move_iterator(blocks.end()));
+            blocks.clear();
+        }
+    };
+
+    /*
+     * flat_map<T, U> <- U, for named blocks.
+     *
+     * Each block is a separate insertion, which would move every later
+     * block in the map.  If the map is a member of the object being
+     * parsed, the blocks are collected in flat_map_blocks instead (see
+     * freeze_list), which still finds duplicates as they're parsed.
+     * Otherwise, the block is inserted straight away; blocks are often
+     * written in key order, so try the end of the map first.
+     */
+    template <typename Map, typename U, typename Tag>
+    void flat_map_propagate_block(auto &ctx, Map &to, U &from, auto &name,
+                                  Tag) {
+        namespace x3 = boost::spirit::x3;
+
+        use_resource(ctx, to);
+
+        bool inserted;
+        if (auto *pending = state_later<flat_map_blocks<Map, Tag>>(ctx, to)) {
+            // The key is copied before from is moved into the value.
+            typename Map::key_type key(from.*name);
+            inserted = to.find(key) == to.end() &&
+                       pending->blocks
+                           .try_emplace(std::move(key), std::move(from))
+                           .second;
+        } else {
+            auto size = to.size();
+            to.emplace_hint(to.end(), std::piecewise_construct,
+                            std::forward_as_tuple(from.*name),
+                            std::forward_as_tuple(std::move(from)));
+            inserted = to.size() != size;
+        }
+
+        if (!inserted) {
+            auto it = x3::_where(ctx).begin();
+            detail::parser::action_failed(it, "unique value", ctx);
+        }
+    }
+
+} // namespace sk::config::detail
+
+#endif // SK_CONFIG_DETAIL_FLAT_HXX_INCLUDED
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_FREEZE_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_FREEZE_HXX_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+
+namespace sk::config::detail {
+
+    // The context holds the freeze_list for the object being parsed.
+    struct freeze_list_tag {};
+
+    /*
+     * The context can also hold a freeze_list which outlives the parse,
+     * for callers which parse one statement at a time into the same
+     * object, such as incremental_parser.  The object's members are
+     * added to that list instead of being frozen after every statement,
+     * and the caller freezes the list once at the end.
+     */
+    struct pending_freeze_tag {};
+
+    /*
+     * freeze_list: the members of an object which should be frozen (see
+     * frozen_map) once the object has been parsed.  A container is
+     * frozen once at the end, rather than after every insertion.
+     *
+     * A member can also keep some state in the list until the end, such
+     * as the values to be inserted into a flat map (see flat.hxx); the
+     * state's finish() is called by freeze().
+     *
+     * Only members of the object itself are recorded, since anything
+     * else (such as an element of a vector) might move or be destroyed
+     * before the end of the parse.
+     */
+    class freeze_list {
+      public:
+        template <typename Owner>
+        explicit freeze_list(Owner &owner)
+            : first(reinterpret_cast<char const *>(std::addressof(owner))),
+              last(first + sizeof(Owner)) {}
+
+        freeze_list(freeze_list const &) = delete;
+        auto operator=(freeze_list const &) -> freeze_list & = delete;
+        freeze_list(freeze_list &&) = default;
+        auto operator=(freeze_list &&) -> freeze_list & = default;
+
+        // Returns true if this is the list for owner.
+        template <typename Owner>
+        auto is_for(Owner const &owner) const -> bool {
+            return reinterpret_cast<char const *>(std::addressof(owner)) ==
+                       first &&
+                   static_cast<std::size_t>(last - first) == sizeof(Owner);
+        }
+
+        /*
+         * Arrange for to.freeze() to be called by freeze().  Returns false
+         * if to isn't part of the owner, in which case the caller should
+         * freeze it straight away.
+         */
+        template <typename T> auto add(T &to) -> bool {
+            if (!owns(to))
+                return false;
+
+            finish_fn finish = [](void *o, void *) {
+                static_cast<T *>(o)->freeze();
+            };
+            if (!find(to, finish))
+                entries.push_back({std::addressof(to), finish, nullptr});
+            return true;
+        }
+
+        /*
+         * Return the State kept for to, creating it the first time, and
+         * arrange for state.finish(to) to be called by freeze().  Returns
+         * nullptr if to isn't part of the owner, in which case the caller
+         * should update it straight away.
+         */
+        template <typename State, typename T>
+        auto state_for(T &to) -> State * {
+            if (!owns(to))
+                return nullptr;
+
+            finish_fn finish = [](void *o, void *s) {
+                static_cast<State *>(s)->finish(*static_cast<T *>(o));
+            };
+            if (auto *e = find(to, finish))
+                return static_cast<State *>(e->state.get());
+
+            auto state = std::make_shared<State>();
+            entries.push_back({std::addressof(to), finish, state});
+            return state.get();
+        }
+
+        void freeze() {
+            for (auto &&e : entries)
+                e.finish(e.object, e.state.get());
+            entries.clear();
+        }
+
+      private:
+        using finish_fn = void (*)(void *object, void *state);
+
+        struct entry {
+            void *object;
+            finish_fn finish;
+            std::shared_ptr<void> state;
+        };
+
+        template <typename T> auto owns(T &to) const -> bool {
+            auto const *p = reinterpret_cast<char const *>(std::addressof(to));
+            std::less<char const *> less;
+            return !less(p, first) && less(p, last);
+        }
+
+        template <typename T> auto find(T &to, finish_fn finish) -> entry * {
+            void *object = std::addressof(to);
+            auto it = std::ranges::find_if(entries, [&](entry const &e) {
+                return e.object == object && e.finish == finish;
+            });
+            return it == entries.end() ? nullptr : &*it;
+        }
+
+        char const *first;
+        char const *last;
+        std::vector<entry> entries;
+    };
+
+    /*
+     * Freeze to once the current object has been parsed, or now if
+     * there's no freeze_list for it.
+     */
+    template <typename Context, typename T>
+    void freeze_later(Context const &ctx, T &to) {
+        namespace x3 = boost::spirit::x3;
+
+        using list_ref =
+            std::remove_cvref_t<decltype(x3::get<freeze_list_tag>(ctx))>;
+        if constexpr (!std::is_same_v<list_ref, x3::unused_type>) {
+            if (x3::get<freeze_list_tag>(ctx).add(to))
+                return;
+        }
+
+        to.freeze();
+    }
+
+    /*
+     * Return the State kept for to until the current object has been
+     * parsed (see freeze_list::state_for), or nullptr if there's no
+     * freeze_list for it.
+     */
+    template <typename State, typename Context, typename T>
+    auto state_later(Context const &ctx, T &to) -> State * {
+        namespace x3 = boost::spirit::x3;
+
+        using list_ref =
+            std::remove_cvref_t<decltype(x3::get<freeze_list_tag>(ctx))>;
+        if constexpr (!std::is_same_v<list_ref, x3::unused_type>)
+            return x3::get<freeze_list_tag>(ctx).template state_for<State>(
+                to);
+        else
+            return nullptr;
+    }
+
+} // namespace sk::config::detail
+
+namespace sk::config::detail::parser {
+
+    /*
+     * freeze_scope: parse the subject with a freeze_list for the rule's
+     * value, and freeze everything in the list afterwards.  If the
+     * context has a pending freeze_list for the rule's value, that list is
+     * used instead, and left for the caller to freeze.
+     */
+    template <typename Subject>
+    struct freeze_scope
+        : boost::spirit::x3::unary_parser<Subject, freeze_scope<Subject>> {
+        using base_type =
+            boost::spirit::x3::unary_parser<Subject, freeze_scope<Subject>>;
+        static bool const is_pass_through_unary = true;
+
+        constexpr freeze_scope(Subject const &subject) : base_type(subject) {}
+
+        template <typename Iterator, typename Context, typename RContext,
+                  typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, RContext &rcontext,
+                   Attribute &attr) const {
+            namespace x3 = boost::spirit::x3;
+
+            // The rule's value is rcontext (which _val() refers to); attr
+            // is unused, since the rule's members are set by actions.
+            using pending_ref = std::remove_cvref_t<decltype(
+                x3::get<pending_freeze_tag>(context))>;
+            if constexpr (!std::is_same_v<pending_ref, x3::unused_type>) {
+                freeze_list &pending =
+                    x3::get<pending_freeze_tag>(context).get();
+                if (pending.is_for(rcontext)) {
+                    auto const ctx =
+                        x3::make_context<freeze_list_tag>(pending, context);
+                    return this->subject.parse(first, last, ctx, rcontext,
+                                               attr);
+                }
+            }
+
+            // If the parse throws, the list is still finished so that the
+            // values parsed before the error aren't lost.
+            freeze_list list(rcontext);
+            auto const ctx = x3::make_context<freeze_list_tag>(list, context);
+            bool r;
+            try {
+                r = this->subject.parse(first, last, ctx, rcontext, attr);
+            } catch (...) {
+                list.freeze();
+                throw;
+            }
+            list.freeze();
+            return r;
+        }
+    };
+
+    template <typename Subject>
+    freeze_scope(Subject const &) -> freeze_scope<Subject>;
+
+} // namespace sk::config::detail::parser
+
+#endif // SK_CONFIG_DETAIL_FREEZE_HXX_INCLUDED
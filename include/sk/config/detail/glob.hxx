@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_GLOB_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_GLOB_HXX_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace sk::config::detail {
+
+    // Returns true if s contains any glob wildcards.
+    inline auto has_wildcards(std::string_view s) -> bool {
+        return s.find_first_of("*?[") != std::string_view::npos;
+    }
+
+    /*
+     * Match one character against a bracket expression starting at
+     * pattern[p] (just after the '['), such as "abc]", "a-z]" or "!0-9]".
+     * On success, p is set to the character after the closing ']'.
+     */
+    inline auto glob_match_bracket(std::string_view pattern, std::size_t &p,
+                                   char c) -> bool {
+        bool negate = false;
+        if (p < pattern.size() && (pattern[p] == '!' || pattern[p] == '^')) {
+            negate = true;
+            ++p;
+        }
+
+        bool matched = false;
+        bool first = true;
+
+        while (p < pattern.size() && (first || pattern[p] != ']')) {
+            first = false;
+
+            char lo = pattern[p++];
+            char hi = lo;
+
+            if (p + 1 < pattern.size() && pattern[p] == '-' &&
+                pattern[p + 1] != ']') {
+                hi = pattern[p + 1];
+                p += 2;
+            }
+
+            if (lo <= c && c <= hi)
+                matched = true;
+        }
+
+        // Skip the ']'.
+        if (p < pattern.size())
+            ++p;
+
+        return matched != negate;
+    }
+
+    /*
+     * Match a filename against a glob pattern.  '*' matches any sequence
+     * of characters, '?' matches any character and [...] matches a set
+     * of characters.  A leading '.' must be matched explicitly.
+     */
+    inline auto glob_match(std::string_view pattern, std::string_view name)
+        -> bool {
+        if (!name.empty() && name[0] == '.' &&
+            (pattern.empty() || pattern[0] != '.'))
+            return false;
+
+        std::size_t p = 0, n = 0;
+
+        // Where to restart after the last '*', if a match fails.
+        std::size_t star_p = std::string_view::npos, star_n = 0;
+
+        while (n < name.size()) {
+            if (p < pattern.size()) {
+                char pc = pattern[p];
+
+                if (pc == '*') {
+                    star_p = ++p;
+                    star_n = n;
+                    continue;
+                }
+
+                if (pc == '?') {
+                    ++p;
+                    ++n;
+                    continue;
+                }
+
+                if (pc == '[') {
+                    auto q = p + 1;
+                    if (glob_match_bracket(pattern, q, name[n])) {
+                        p = q;
+                        ++n;
+                        continue;
+                    }
+                } else if (pc == name[n]) {
+                    ++p;
+                    ++n;
+                    continue;
+                }
+            }
+
+            // Mismatch: let the last '*' match one more character.
+            if (star_p == std::string_view::npos)
+                return false;
+
+            p = star_p;
+            n = ++star_n;
+        }
+
+        while (p < pattern.size() && pattern[p] == '*')
+            ++p;
+
+        return p == pattern.size();
+    }
+
+    /*
+     * Expand a glob pattern into a sorted list of regular files.  Only
+     * the last component of the path may contain wildcards.  If the pattern
+     * has no wildcards, it's returned unchanged even if it doesn't exist.
+     */
+    inline auto expand_glob(std::filesystem::path const &pattern)
+        -> std::vector<std::filesystem::path> {
+        auto filename = pattern.filename().string();
+        if (!has_wildcards(filename))
+            return {pattern};
+
+        auto directory = pattern.parent_path();
+        if (directory.empty())
+            directory = ".";
+
+        std::vector<std::filesystem::path> paths;
+        std::error_code ec;
+
+        for (auto it = std::filesystem::directory_iterator(directory, ec);
+             !ec && it != std::filesystem::directory_iterator();
+             it.increment(ec)) {
+            std::error_code type_ec;
+            if (!it->is_regular_file(type_ec))
+                continue;
+
+            auto name = it->path().filename().string();
+            if (glob_match(filename, name))
+                paths.push_back(pattern.parent_path() / name);
+        }
+
+        std::ranges::sort(paths);
+        return paths;
+    }
+
+} // namespace sk::config::detail
+
+#endif // SK_CONFIG_DETAIL_GLOB_HXX_INCLUDED
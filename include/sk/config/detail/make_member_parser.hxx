@@ -38,17 +38,23 @@
 
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/parser/compiled.hxx>
+#include <sk/config/detail/parser/expect.hxx>
 #include <sk/config/detail/propagate.hxx>
 #include <sk/config/error.hxx>
 #include <sk/config/parser_for.hxx>
 
 namespace sk::config::detail {
 
+#ifdef BOOST_NO_EXCEPTIONS
+    struct member_tag {};
+#else
     struct member_tag : parser_error_handler {};
+#endif
 
     template <typename T, typename P> auto member_rule(const char *debug, P p) {
         namespace x3 = boost::spirit::x3;
-        return x3::rule<member_tag, T>{debug} = p;
+        return x3::rule<member_tag, T>{debug} = parser::error_boundary(p);
     };
 
     template <typename T, typename V>
@@ -58,10 +64,10 @@ namespace sk::config::detail {
         using rule_type = typename parser_for<V>::rule_type;
         using parser_type = typename parser_for<V>::parser_type;
 
-        static parser_type parser;
+        static parser::compiled<parser_type> parser;
         static auto rule = member_rule<rule_type>(parser_for<V>::name, parser);
 
-        return x3::expect[rule][propagate(member)];
+        return parser::expect[rule][propagate(member)];
     }
 
 } // namespace sk::config::detail
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_MAPPED_FILE_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_MAPPED_FILE_HXX_INCLUDED
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <boost/throw_exception.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    define SK_CONFIG_HAVE_MMAP 1
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace sk::config::detail {
+
+    /*
+     * mapped_file: the contents of a file as a contiguous range of chars.
+     *
+     * Where possible the file is mapped into memory with mmap(); if the
+     * file can't be mapped (for example, it's a pipe, or the platform
+     * doesn't support mmap) it's loaded into a buffer instead, using a
+     * single read when the size is known in advance.
+     *
+     * Errors are reported by throwing std::system_error.
+     */
+    class mapped_file {
+      public:
+        explicit mapped_file(std::filesystem::path const &path) {
+#ifdef SK_CONFIG_HAVE_MMAP
+            open_posix(path);
+#else
+            open_stream(path);
+#endif
+        }
+
+        mapped_file(mapped_file const &) = delete;
+        mapped_file &operator=(mapped_file const &) = delete;
+
+        ~mapped_file() {
+#ifdef SK_CONFIG_HAVE_MMAP
+            if (mapped_)
+                ::munmap(const_cast<char *>(data_), size_);
+#endif
+        }
+
+        auto data() const -> char const * {
+            return data_;
+        }
+
+        auto size() const -> std::size_t {
+            return size_;
+        }
+
+        auto begin() const -> char const * {
+            return data_;
+        }
+
+        auto end() const -> char const * {
+            return data_ + size_;
+        }
+
+        /*
+         * Tell the OS we'll need the contents soon, so it can start reading
+         * the file in the background.  This does nothing if the file was
+         * read into a buffer, since the contents are already in memory.
+         */
+        void prefetch() const {
+#if defined(SK_CONFIG_HAVE_MMAP) && defined(POSIX_MADV_WILLNEED)
+            if (mapped_)
+                ::posix_madvise(const_cast<char *>(data_), size_,
+                                POSIX_MADV_WILLNEED);
+#endif
+        }
+
+        // True if the file was mapped, false if it was read into a buffer.
+        auto is_mapped() const -> bool {
+            return mapped_;
+        }
+
+      private:
+        char const *data_ = nullptr;
+        std::size_t size_ = 0;
+        bool mapped_ = false;
+        std::string buffer_;
+
+        void use_buffer() {
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+        }
+
+#ifdef SK_CONFIG_HAVE_MMAP
+        [[noreturn]] static void throw_errno() {
+            boost::throw_exception(
+                std::system_error(errno, std::generic_category()));
+        }
+
+        void open_posix(std::filesystem::path const &path) {
+            int fd;
+            do {
+                fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            } while (fd == -1 && errno == EINTR);
+
+            if (fd == -1)
+                throw_errno();
+
+            struct closer {
+                int fd;
+                ~closer() { ::close(fd); }
+            } close_fd{fd};
+
+            load_fd(fd);
+        }
+
+        void load_fd(int fd) {
+            struct stat sb;
+            if (::fstat(fd, &sb) == -1)
+                throw_errno();
+
+            if (S_ISDIR(sb.st_mode))
+                boost::throw_exception(
+                    std::system_error(EISDIR, std::generic_category()));
+
+            if (S_ISREG(sb.st_mode)) {
+                auto size = static_cast<std::size_t>(sb.st_size);
+
+                // mmap() can't map an empty file.
+                if (size == 0) {
+                    use_buffer();
+                    return;
+                }
+
+                void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+#    ifdef POSIX_MADV_SEQUENTIAL
+                    ::posix_madvise(p, size, POSIX_MADV_SEQUENTIAL);
+#    endif
+                    data_ = static_cast<char const *>(p);
+                    size_ = size;
+                    mapped_ = true;
+                    return;
+                }
+
+                // Some filesystems don't support mmap; read the whole file
+                // in one go instead.
+                buffer_.resize(size);
+                read_fd(fd, buffer_.data(), size);
+                use_buffer();
+                return;
+            }
+
+            // Not a regular file, so we don't know the size in advance;
+            // read until end of file.
+            std::size_t used = 0;
+            for (;;) {
+                if (buffer_.size() - used < 4096)
+                    buffer_.resize(buffer_.size() + 65536);
+
+                auto n = ::read(fd, buffer_.data() + used,
+                                buffer_.size() - used);
+                if (n == -1) {
+                    if (errno == EINTR)
+                        continue;
+                    throw_errno();
+                }
+
+                if (n == 0)
+                    break;
+
+                used += static_cast<std::size_t>(n);
+            }
+
+            buffer_.resize(used);
+            use_buffer();
+        }
+
+        static void read_fd(int fd, char *buf, std::size_t size) {
+            while (size > 0) {
+                auto n = ::read(fd, buf, size);
+                if (n == -1) {
+                    if (errno == EINTR)
+                        continue;
+                    throw_errno();
+                }
+
+                // The file was truncated while we were reading it.
+                if (n == 0)
+                    boost::throw_exception(
+                        std::system_error(EIO, std::generic_category()));
+
+                buf += n;
+                size -= static_cast<std::size_t>(n);
+            }
+        }
+#else
+        void open_stream(std::filesystem::path const &path) {
+            std::ifstream fs;
+            fs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+            fs.open(path, std::ios::binary | std::ios::ate);
+
+            auto size = static_cast<std::size_t>(fs.tellg());
+            fs.seekg(0);
+
+            buffer_.resize(size);
+            if (size > 0)
+                fs.read(buffer_.data(), static_cast<std::streamsize>(size));
+            use_buffer();
+        }
+#endif
+    };
+
+} // namespace sk::config::detail
+
+#endif // SK_CONFIG_DETAIL_MAPPED_FILE_HXX_INCLUDED
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_MEMORY_RESOURCE_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_MEMORY_RESOURCE_HXX_INCLUDED
+
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include <boost/spirit/home/x3.hpp>
+
+namespace sk::config::detail {
+
+    // The context holds the std::pmr::memory_resource * passed to parse().
+    struct memory_resource_tag {};
+
+    template <typename T>
+    concept pmr_container = requires {
+        typename T::allocator_type;
+        typename T::value_type;
+    } && std::is_same_v<typename T::allocator_type,
+                        std::pmr::polymorphic_allocator<
+                            typename T::value_type>>;
+
+    /*
+     * Called by propagate_value() before it modifies to.  If parse() was
+     * given a memory resource and to is a pmr container which uses a
+     * different resource, replace to with a copy of itself which uses the
+     * parse's resource, so anything put in it afterwards is allocated
+     * from there as well.  Otherwise, do nothing.
+     *
+     * A pmr container's allocator can't be changed by assignment, so the
+     * old object is destroyed and a new one is constructed in its place.
+     */
+    template <typename Context, typename T>
+    void use_resource(Context const &ctx, T &to) {
+        namespace x3 = boost::spirit::x3;
+
+        if constexpr (pmr_container<T>) {
+            using resource_ref = std::remove_cvref_t<decltype(
+                x3::get<memory_resource_tag>(ctx))>;
+
+            if constexpr (!std::is_same_v<resource_ref, x3::unused_type>) {
+                std::pmr::memory_resource *resource =
+                    x3::get<memory_resource_tag>(ctx);
+
+                if (to.get_allocator().resource() == resource)
+                    return;
+
+                T copy(std::move(to), typename T::allocator_type(resource));
+                std::destroy_at(&to);
+                std::construct_at(&to, std::move(copy));
+            }
+        }
+    }
+
+} // namespace sk::config::detail
+
+#endif // SK_CONFIG_DETAIL_MEMORY_RESOURCE_HXX_INCLUDED
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_PARALLEL_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_PARALLEL_HXX_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/error_formatter.hxx>
+#include <sk/config/detail/propagate.hxx>
+#include <sk/config/error.hxx>
+
+namespace sk::config::detail {
+
+    /*
+     * Run fn(i) for each i in [0, n) on a pool of threads.  fn must not
+     * throw.
+     */
+    inline void parallel_for(std::size_t n,
+                             std::function<void(std::size_t)> const &fn) {
+        if (n == 0)
+            return;
+
+        std::size_t nthreads = std::thread::hardware_concurrency();
+        nthreads = std::clamp<std::size_t>(nthreads, 1, n);
+
+        std::atomic<std::size_t> next{0};
+        auto worker = [&] {
+            for (;;) {
+                auto i = next.fetch_add(1, std::memory_order_relaxed);
+                if (i >= n)
+                    break;
+                fn(i);
+            }
+        };
+
+        std::vector<std::jthread> threads;
+        for (std::size_t i = 1; i < nthreads; ++i)
+            threads.emplace_back(worker);
+
+        worker();
+    }
+
+    /*
+     * Convert an error raised while applying a deferred_log which was
+     * recorded while parsing [first, last) into a parse_error.
+     */
+    inline auto
+    make_replay_error(boost::spirit::x3::expectation_failure<char const *> const &x,
+                      char const *first, char const *last,
+                      std::string const &filename) -> parse_error {
+        std::vector<error_detail> errors;
+        auto error_handler =
+            error_formatter(first, last, std::back_inserter(errors), filename);
+        error_handler(x.where(), "expected " + x.which());
+        return parse_error("could not parse the entire input", errors);
+    }
+
+    /*
+     * Apply a deferred_log which was recorded while parsing [first, last)
+     * to ret, adding members to be frozen to list.  Errors are reported as
+     * a parse_error against that input.
+     */
+    template <typename T>
+    void replay_log(deferred_log<T> &log, T &ret, freeze_list &list,
+                    char const *first, char const *last,
+                    std::string const &filename) {
+        namespace x3 = boost::spirit::x3;
+
+        try {
+            log.replay(ret, list);
+        } catch (x3::expectation_failure<char const *> const &x) {
+            throw make_replay_error(x, first, last, filename);
+        }
+    }
+
+} // namespace sk::config::detail
+
+#endif // SK_CONFIG_DETAIL_PARALLEL_HXX_INCLUDED
@@ -29,6 +29,9 @@
 #ifndef SK_CONFIG_DETAIL_COMMENT_PARSER_HXX_INCLUDED
 #define SK_CONFIG_DETAIL_COMMENT_PARSER_HXX_INCLUDED
 
+#include <cstring>
+#include <iterator>
+#include <memory>
 #include <string>
 
 #include <boost/spirit/home/x3.hpp>
@@ -36,18 +39,129 @@
 namespace sk::config::detail::parser {
 
     /*
-     * Parse a comment, which is either a C-style comment or a '#'
-     * comment.
+     * Skip whitespace and comments, which are either C-style comments or
+     * '#' comments which run to the end of the line.
      *
      * This parser is not used directly, but is the config skip parser.
+     * Rather than being called once per character, it skips a whole run of
+     * whitespace and comments in one call and uses memchr() to find the end
+     * of a comment.  An unterminated comment is not skipped.
      */
+    struct comment_parser : boost::spirit::x3::parser<comment_parser> {
+        using attribute_type = boost::spirit::x3::unused_type;
+        static bool const has_attribute = false;
 
-    auto const comment =                                     //
-        boost::spirit::x3::space                             //
-        | "/*" >> *(boost::spirit::x3::char_ - "*/") >> "*/" //
-        | "#" >> *(boost::spirit::x3::char_ - boost::spirit::x3::eol) >>
-              boost::spirit::x3::eol;
+        static constexpr auto is_space(char c) -> bool {
+            return c == ' ' || (c >= '\t' && c <= '\r');
+        }
+
+        // Skip from first, returning the new position.
+        static auto skip(char const *first, char const *last)
+            -> char const * {
+            for (;;) {
+                while (first != last && is_space(*first))
+                    ++first;
+
+                if (last - first < 2)
+                    return first;
+
+                if (*first == '#') {
+                    auto p = first + 1;
+                    auto n = static_cast<std::size_t>(last - p);
+                    auto nl = static_cast<char const *>(std::memchr(p, '\n', n));
+                    auto end = nl ? nl : last;
+                    auto cr = static_cast<char const *>(
+                        std::memchr(p, '\r', static_cast<std::size_t>(end - p)));
+                    if (cr)
+                        end = cr;
+                    else if (!nl)
+                        // An unterminated '#' comment isn't a comment.
+                        return first;
+                    first = end;
+                } else if (first[0] == '/' && first[1] == '*') {
+                    auto p = first + 2;
+                    for (;;) {
+                        p = static_cast<char const *>(std::memchr(
+                            p, '*', static_cast<std::size_t>(last - p)));
+                        if (!p || p + 1 == last)
+                            // An unterminated C comment isn't a comment.
+                            return first;
+                        if (p[1] == '/')
+                            break;
+                        ++p;
+                    }
+                    first = p + 2;
+                } else
+                    return first;
+            }
+        }
+
+        // The same as skip(), for iterators which aren't contiguous.
+        template <typename Iterator>
+        static auto skip(Iterator first, Iterator const &last) -> Iterator {
+            for (;;) {
+                while (first != last && is_space(*first))
+                    ++first;
+
+                if (first == last)
+                    return first;
+
+                auto p = first;
+                if (*p == '#') {
+                    while (++p != last && *p != '\n' && *p != '\r')
+                        ;
+                    if (p == last)
+                        return first;
+                    first = p;
+                } else if (*p == '/') {
+                    if (++p == last || *p != '*')
+                        return first;
+
+                    char prev = 0;
+                    while (++p != last && !(prev == '*' && *p == '/'))
+                        prev = *p;
+                    if (p == last)
+                        return first;
+                    first = ++p;
+                } else
+                    return first;
+            }
+        }
+
+        template <typename Iterator, typename Context, typename RContext,
+                  typename Attribute>
+        bool parse(Iterator &first, Iterator const &last, Context const &,
+                   RContext &, Attribute &) const {
+            auto start = first;
+
+            if constexpr (std::contiguous_iterator<Iterator>) {
+                if (first == last)
+                    return false;
+                auto begin = std::to_address(first);
+                auto end = skip(begin, begin + (last - first));
+                first += end - begin;
+            } else
+                first = skip(first, last);
+
+            return first != start;
+        }
+    };
+
+    auto constexpr comment = comment_parser{};
 
 } // namespace sk::config::detail::parser
 
+namespace boost::spirit::x3 {
+
+    template <>
+    struct get_info<sk::config::detail::parser::comment_parser> {
+        typedef std::string result_type;
+        result_type
+        operator()(sk::config::detail::parser::comment_parser const &) const {
+            return "comment";
+        }
+    };
+
+} // namespace boost::spirit::x3
+
 #endif // SK_CONFIG_DETAIL_COMMENT_PARSER_HXX_INCLUDED
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_PARSER_COMPILED_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_PARSER_COMPILED_HXX_INCLUDED
+
+#include <concepts>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/parser/comment.hxx>
+#include <sk/config/detail/parser/expect.hxx>
+#include <sk/config/parser_policy.hxx>
+
+#ifdef SK_CONFIG_SEPARATE_COMPILATION
+#    include <sk/config/detail/parser/bool.hxx>
+#    include <sk/config/detail/parser/map.hxx>
+#    include <sk/config/detail/parser/number.hxx>
+#    include <sk/config/detail/parser/vector.hxx>
+#    include <sk/config/parser/string.hxx>
+#endif
+
+namespace sk::config::detail::parser {
+
+    /*
+     * Parsers which have been compiled into sk-config-core.  This is only
+     * specialised when SK_CONFIG_SEPARATE_COMPILATION is defined.
+     */
+    template <typename Parser> inline constexpr bool is_compiled = false;
+
+    /*
+     * Run Parser in the context that parse() creates for char const *
+     * input with the default policy: the comment skipper, parser_policy
+     * and errors reported by throwing.  The context type is fixed, so
+     * this can be instantiated once in sk-config-core instead of once
+     * per grammar in every translation unit that uses the parser.
+     */
+    template <typename Parser>
+    bool parse_compiled(char const *&first, char const *last,
+                        parser_policy const &policy,
+                        typename Parser::attribute_type &attr) {
+        namespace x3 = boost::spirit::x3;
+
+        static Parser const parser;
+
+        auto policy_ref = std::cref(policy);
+        auto const skipper_context = x3::make_context<x3::skipper_tag>(comment);
+        auto const context = x3::make_context<parser_policy_tag>(
+            policy_ref, skipper_context);
+
+        return parser.parse(first, last, context, attr, attr);
+    }
+
+    // True if Context is one parse_compiled() can stand in for.
+    template <typename Parser, typename Iterator, typename Context>
+    concept compiled_context =
+        is_compiled<Parser> && std::same_as<Iterator, char const *> &&
+        !is_no_throw<Context> &&
+        requires {
+            requires std::same_as<policy_of<Context>, parser_policy>;
+        } &&
+        std::same_as<std::remove_cvref_t<decltype(boost::spirit::x3::get<
+                         boost::spirit::x3::skipper_tag>(
+                         std::declval<Context const &>()))>,
+                     comment_parser>;
+
+    /*
+     * compiled[p]: parse with p, calling the instantiation of p in
+     * sk-config-core if there is one for this context.  Otherwise p is
+     * instantiated here as usual, so this is always safe to use.
+     */
+    template <typename Parser>
+    struct compiled : boost::spirit::x3::parser<compiled<Parser>> {
+        typedef typename Parser::attribute_type attribute_type;
+        static bool const has_attribute = true;
+
+        compiled() = default;
+        compiled(Parser const &subject) : subject(subject) {}
+
+        template <typename Iterator, typename Context, typename RContext,
+                  typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, RContext &rcontext,
+                   Attribute &attr) const {
+            namespace x3 = boost::spirit::x3;
+
+            if constexpr (compiled_context<Parser, Iterator, Context>) {
+                auto const &policy = x3::get<parser_policy_tag>(context).get();
+
+                if constexpr (std::is_same_v<Attribute, attribute_type>) {
+                    return parse_compiled<Parser>(first, last, policy, attr);
+                } else {
+                    attribute_type attr_;
+                    if (!parse_compiled<Parser>(first, last, policy, attr_))
+                        return false;
+                    x3::traits::move_to(attr_, attr);
+                    return true;
+                }
+            } else {
+                return subject.parse(first, last, context, rcontext, attr);
+            }
+        }
+
+        Parser subject;
+    };
+
+#ifdef SK_CONFIG_SEPARATE_COMPILATION
+
+    /*
+     * The parsers instantiated in sk-config-core; see src/parsers.cxx.
+     */
+    using compiled_string = sk::config::parser::any_string_parser<char>;
+    using compiled_string_map = map<compiled_string, compiled_string>;
+    using compiled_int_map = map<compiled_string, number_parser<int>>;
+
+    template <> inline constexpr bool is_compiled<compiled_string> = true;
+    template <> inline constexpr bool is_compiled<bool_parser> = true;
+    template <> inline constexpr bool is_compiled<number_parser<int>> = true;
+    template <>
+    inline constexpr bool is_compiled<number_parser<unsigned>> = true;
+    template <> inline constexpr bool is_compiled<number_parser<long>> = true;
+    template <>
+    inline constexpr bool is_compiled<number_parser<unsigned long>> = true;
+    template <>
+    inline constexpr bool is_compiled<number_parser<long long>> = true;
+    template <>
+    inline constexpr bool is_compiled<number_parser<unsigned long long>> =
+        true;
+    template <> inline constexpr bool is_compiled<number_parser<float>> = true;
+    template <> inline constexpr bool is_compiled<number_parser<double>> = true;
+    template <>
+    inline constexpr bool is_compiled<vector<compiled_string>> = true;
+    template <>
+    inline constexpr bool is_compiled<vector<number_parser<int>>> = true;
+    template <>
+    inline constexpr bool is_compiled<vector<number_parser<unsigned>>> =
+        true;
+    template <>
+    inline constexpr bool is_compiled<vector<number_parser<double>>> = true;
+    template <> inline constexpr bool is_compiled<compiled_string_map> = true;
+    template <> inline constexpr bool is_compiled<compiled_int_map> = true;
+
+    extern template bool parse_compiled<compiled_string>(
+        char const *&, char const *, parser_policy const &,
+        compiled_string::attribute_type &);
+    extern template bool parse_compiled<bool_parser>(
+        char const *&, char const *, parser_policy const &,
+        bool_parser::attribute_type &);
+    extern template bool parse_compiled<number_parser<int>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<int>::attribute_type &);
+    extern template bool parse_compiled<number_parser<unsigned>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<unsigned>::attribute_type &);
+    extern template bool parse_compiled<number_parser<long>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<long>::attribute_type &);
+    extern template bool parse_compiled<number_parser<unsigned long>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<unsigned long>::attribute_type &);
+    extern template bool parse_compiled<number_parser<long long>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<long long>::attribute_type &);
+    extern template bool parse_compiled<number_parser<unsigned long long>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<unsigned long long>::attribute_type &);
+    extern template bool parse_compiled<number_parser<float>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<float>::attribute_type &);
+    extern template bool parse_compiled<number_parser<double>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<double>::attribute_type &);
+    extern template bool parse_compiled<vector<compiled_string>>(
+        char const *&, char const *, parser_policy const &,
+        vector<compiled_string>::attribute_type &);
+    extern template bool parse_compiled<vector<number_parser<int>>>(
+        char const *&, char const *, parser_policy const &,
+        vector<number_parser<int>>::attribute_type &);
+    extern template bool parse_compiled<vector<number_parser<unsigned>>>(
+        char const *&, char const *, parser_policy const &,
+        vector<number_parser<unsigned>>::attribute_type &);
+    extern template bool parse_compiled<vector<number_parser<double>>>(
+        char const *&, char const *, parser_policy const &,
+        vector<number_parser<double>>::attribute_type &);
+    extern template bool parse_compiled<compiled_string_map>(
+        char const *&, char const *, parser_policy const &,
+        compiled_string_map::attribute_type &);
+    extern template bool parse_compiled<compiled_int_map>(
+        char const *&, char const *, parser_policy const &,
+        compiled_int_map::attribute_type &);
+
+#endif // SK_CONFIG_SEPARATE_COMPILATION
+
+} // namespace sk::config::detail::parser
+
+namespace boost::spirit::x3 {
+
+    template <typename Parser>
+    struct get_info<sk::config::detail::parser::compiled<Parser>> {
+        typedef std::string result_type;
+        result_type operator()(
+            sk::config::detail::parser::compiled<Parser> const &p) const {
+            return what(p.subject);
+        }
+    };
+
+} // namespace boost::spirit::x3
+
+#endif // SK_CONFIG_DETAIL_PARSER_COMPILED_HXX_INCLUDED
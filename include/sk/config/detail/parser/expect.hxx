@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_PARSER_EXPECT_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_PARSER_EXPECT_HXX_INCLUDED
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <boost/spirit/home/x3.hpp>
+#include <boost/spirit/home/x3/support/utility/error_reporting.hpp>
+#include <boost/throw_exception.hpp>
+
+namespace sk::config::detail::parser {
+
+    /*
+     * Expectation failures are normally reported by throwing
+     * x3::expectation_failure, which is caught by the nearest rule with an
+     * error handler.  If the context contains a no_throw_tag, they are
+     * reported to the error handler directly instead, and the parse fails
+     * back to the same rule without throwing: no_throw_state::unwinding is
+     * set until an error_boundary (which wraps each rule) sees it, and
+     * makes the rule fail the same way the error handler would have.
+     */
+    struct no_throw_tag;
+
+    struct no_throw_state {
+        // An error has been reported, and we're returning to the rule
+        // which would have caught it.
+        bool unwinding = false;
+
+        // At least one error has been reported.
+        bool failed = false;
+    };
+
+    template <typename Context>
+    inline constexpr bool is_no_throw = !std::is_same_v<
+        std::remove_cvref_t<decltype(boost::spirit::x3::get<no_throw_tag>(
+            std::declval<Context const &>()))>,
+        boost::spirit::x3::unused_type>;
+
+    /*
+     * Report that which was expected at where, either by throwing or by
+     * recording the error.
+     */
+    template <typename Iterator, typename Context>
+    void expectation_failed(Iterator const &where, std::string const &which,
+                            Context const &context) {
+        namespace x3 = boost::spirit::x3;
+
+        if constexpr (is_no_throw<Context>) {
+            auto &state = x3::get<no_throw_tag>(context).get();
+            if (state.unwinding)
+                return;
+
+            state.unwinding = true;
+            state.failed = true;
+
+            auto &error_handler = x3::get<x3::error_handler_tag>(context).get();
+            error_handler(where, "expected " + which);
+        } else {
+            boost::throw_exception(
+                x3::expectation_failure<Iterator>(where, which));
+        }
+    }
+
+    /*
+     * Report an error from a semantic action, such as a duplicate map key.
+     * If the error was recorded rather than thrown, the action fails.
+     */
+    template <typename Iterator, typename Context>
+    void action_failed(Iterator const &where, std::string const &which,
+                       Context const &context) {
+        namespace x3 = boost::spirit::x3;
+
+        expectation_failed(where, which, context);
+
+        using pass_type = std::remove_cvref_t<decltype(
+            x3::get<x3::parse_pass_context_tag>(context))>;
+        if constexpr (!std::is_same_v<pass_type, x3::unused_type>)
+            x3::_pass(context) = false;
+    }
+
+    /*
+     * expect[p]: the same as x3::expect[p], but reports failures with
+     * expectation_failed().  a > b should be written as a >> expect[b].
+     */
+    template <typename Subject>
+    struct expect_directive
+        : boost::spirit::x3::unary_parser<Subject, expect_directive<Subject>> {
+        using base_type =
+            boost::spirit::x3::unary_parser<Subject,
+                                            expect_directive<Subject>>;
+        static bool const is_pass_through_unary = true;
+
+        constexpr expect_directive(Subject const &subject)
+            : base_type(subject) {}
+
+        template <typename Iterator, typename Context, typename RContext,
+                  typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, RContext &rcontext,
+                   Attribute &attr) const {
+            bool r = this->subject.parse(first, last, context, rcontext, attr);
+
+            if (!r)
+                expectation_failed(first, boost::spirit::x3::what(this->subject),
+                                   context);
+            return r;
+        }
+    };
+
+    struct expect_gen {
+        template <typename Subject>
+        constexpr auto operator[](Subject const &subject) const
+            -> expect_directive<typename boost::spirit::x3::extension::
+                                    as_parser<Subject>::value_type> {
+            return {boost::spirit::x3::as_parser(subject)};
+        }
+    };
+
+    constexpr auto expect = expect_gen{};
+
+    /*
+     * error_boundary[p]: the point where an error handler would catch an
+     * expectation failure thrown by p.  This is used as the body of each
+     * rule, and does nothing unless errors are being recorded.
+     */
+    template <typename Subject>
+    struct error_boundary
+        : boost::spirit::x3::unary_parser<Subject, error_boundary<Subject>> {
+        using base_type =
+            boost::spirit::x3::unary_parser<Subject, error_boundary<Subject>>;
+        static bool const is_pass_through_unary = true;
+
+        constexpr error_boundary(Subject const &subject)
+            : base_type(subject) {}
+
+        template <typename Iterator, typename Context, typename RContext,
+                  typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, RContext &rcontext,
+                   Attribute &attr) const {
+            namespace x3 = boost::spirit::x3;
+
+            if constexpr (is_no_throw<Context>) {
+                auto &state = x3::get<no_throw_tag>(context).get();
+
+                // If we're already unwinding, an exception would never
+                // have reached this rule.
+                if (state.unwinding)
+                    return false;
+
+                bool r =
+                    this->subject.parse(first, last, context, rcontext, attr);
+                if (state.unwinding) {
+                    state.unwinding = false;
+                    return false;
+                }
+                return r;
+            } else {
+                return this->subject.parse(first, last, context, rcontext,
+                                           attr);
+            }
+        }
+    };
+
+    template <typename Subject>
+    error_boundary(Subject) -> error_boundary<Subject>;
+
+} // namespace sk::config::detail::parser
+
+namespace boost::spirit::x3 {
+
+    template <typename Subject>
+    struct get_info<sk::config::detail::parser::expect_directive<Subject>> {
+        typedef std::string result_type;
+        result_type operator()(
+            sk::config::detail::parser::expect_directive<Subject> const &p)
+            const {
+            return what(p.subject);
+        }
+    };
+
+    template <typename Subject>
+    struct get_info<sk::config::detail::parser::error_boundary<Subject>> {
+        typedef std::string result_type;
+        result_type operator()(
+            sk::config::detail::parser::error_boundary<Subject> const &p)
+            const {
+            return what(p.subject);
+        }
+    };
+
+} // namespace boost::spirit::x3
+
+namespace boost::spirit::x3::detail {
+
+    // Parse into a container the same way as x3::expect.
+    template <typename Subject, typename Context, typename RContext>
+    struct parse_into_container_impl<
+        sk::config::detail::parser::expect_directive<Subject>, Context,
+        RContext> {
+        template <typename Iterator, typename Attribute>
+        static bool
+        call(sk::config::detail::parser::expect_directive<Subject> const &parser,
+             Iterator &first, Iterator const &last, Context const &context,
+             RContext &rcontext, Attribute &attr) {
+            bool r = parse_into_container(parser.subject, first, last, context,
+                                          rcontext, attr);
+
+            if (!r)
+                sk::config::detail::parser::expectation_failed(
+                    first, what(parser.subject), context);
+            return r;
+        }
+    };
+
+} // namespace boost::spirit::x3::detail
+
+#endif // SK_CONFIG_DETAIL_PARSER_EXPECT_HXX_INCLUDED
@@ -29,11 +29,16 @@
 #ifndef SK_CONFIG_DETAIL_PARSER_HEREDOC_HXX_INCLUDED
 #define SK_CONFIG_DETAIL_PARSER_HEREDOC_HXX_INCLUDED
 
+#include <cstring>
+#include <iterator>
+#include <memory>
 #include <string>
 
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/parser/expect.hxx>
 #include <sk/config/detail/parser/identifier.hxx>
+#include <sk/config/detail/scan.hxx>
 
 namespace sk::config::detail::parser {
 
@@ -42,12 +47,16 @@ namespace sk::config::detail::parser {
         typedef std::basic_string<Char> attribute_type;
         static bool const has_attribute = true;
 
+        /*
+         * Parse a heredoc and return the part of the input containing its
+         * body, without copying it.
+         */
         template <typename Iterator, typename Context>
-        bool parse(Iterator &first, Iterator const &last,
-                   Context const &context,
-                   boost::spirit::x3::unused_type unused_,
-                   attribute_type &attr) const {
+        bool parse_body(Iterator &first, Iterator const &last,
+                        Context const &context,
+                        boost::iterator_range<Iterator> &body) const {
             namespace x3 = boost::spirit::x3;
+            using parser::expect;
 
             // Run the skip parser.
             x3::skip_over(first, last, context);
@@ -69,20 +78,99 @@ namespace sk::config::detail::parser {
             auto const ident = identifier<Char>();
             std::basic_string<Char> token;
 
-            auto const token_parser = x3::expect[x3::no_skip[ident > x3::eol]];
+            auto const token_parser =
+                expect[x3::no_skip[ident >> expect[x3::eol]]];
 
             if (!token_parser.parse(first, last, context, unused, token))
                 return false;
 
-            // Parse the content into our attribute, terminated by the token.
+            if constexpr (std::contiguous_iterator<Iterator> &&
+                          sizeof(std::iter_value_t<Iterator>) == 1 &&
+                          sizeof(Char) == 1)
+                return find_body(first, last, context, token, body);
+
+            // Find the content, terminated by the token.
             auto lit_token = x3::eol >> x3::lit(token);
-            auto content_parser =                        //
-                x3::expect[                              //
-                    x3::no_skip[+(x3::char_ - lit_token) //
-                                > lit_token]];
-            if (!content_parser.parse(first, last, context, unused, attr))
+            auto content_parser =                                   //
+                expect[                                             //
+                    x3::no_skip[x3::raw[+(x3::char_ - lit_token)]  //
+                                >> expect[lit_token]]];
+            if (!content_parser.parse(first, last, context, unused, body))
+                return false;
+
+            return true;
+        }
+
+        /*
+         * Find the body of a heredoc in a contiguous input, which is
+         * terminated by an end of line followed by the token.  Rather
+         * than trying to match the terminator at every character, only
+         * look at the start of each line, and find line ends with
+         * find_either().  The result is the same as the Spirit parser in
+         * parse_body(), including the errors.
+         */
+        template <typename Iterator, typename Context>
+        static bool find_body(Iterator &first, Iterator const &last,
+                              Context const &context,
+                              std::basic_string<Char> const &token,
+                              boost::iterator_range<Iterator> &body) {
+            namespace x3 = boost::spirit::x3;
+            using parser::expect;
+
+            auto begin = reinterpret_cast<char const *>(std::to_address(first));
+            auto end = begin + (last - first);
+            auto token_data = reinterpret_cast<char const *>(token.data());
+
+            auto const lit_token = x3::eol >> x3::lit(token);
+
+            // The body can't be empty.
+            auto empty_body = [&] {
+                auto content = x3::no_skip[x3::raw[+(x3::char_ - lit_token)] >>
+                                           expect[lit_token]];
+                expectation_failed(first, x3::what(content), context);
+                return false;
+            };
+
+            if (begin == end)
+                return empty_body();
+
+            for (auto p = begin;;) {
+                auto eol = find_either(p, end, '\n', '\r');
+                if (eol == end) {
+                    // No terminator.
+                    expectation_failed(last, x3::what(lit_token), context);
+                    return false;
+                }
+
+                auto line = eol + 1;
+                if (*eol == '\r' && line != end && *line == '\n')
+                    ++line;
+
+                if (static_cast<std::size_t>(end - line) >= token.size() &&
+                    std::memcmp(line, token_data, token.size()) == 0) {
+                    if (eol == begin)
+                        return empty_body();
+
+                    body = {first, first + (eol - begin)};
+                    first += (line - begin) +
+                             static_cast<std::ptrdiff_t>(token.size());
+                    return true;
+                }
+
+                p = line;
+            }
+        }
+
+        template <typename Iterator, typename Context>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context,
+                   boost::spirit::x3::unused_type,
+                   attribute_type &attr) const {
+            boost::iterator_range<Iterator> body;
+            if (!parse_body(first, last, context, body))
                 return false;
 
+            attr.assign(body.begin(), body.end());
             return true;
         }
 
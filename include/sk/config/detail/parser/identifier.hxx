@@ -54,6 +54,21 @@ namespace sk::config::detail::parser {
             return grammar.parse(first, last, context, x3::unused, attr);
         }
 
+        // Match an identifier without creating an attribute; this is used
+        // by x3::raw[].
+        template <typename Iterator, typename Context>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, boost::spirit::x3::unused_type,
+                   boost::spirit::x3::unused_type const &) const {
+            namespace x3 = boost::spirit::x3;
+
+            static auto const grammar =
+                x3::lexeme[x3::ascii::alpha >>
+                           *(x3::ascii::alnum | x3::lit('-') | x3::lit('_'))];
+
+            return grammar.parse(first, last, context, x3::unused, x3::unused);
+        }
+
         template <typename Iterator, typename Context, typename Attribute>
         bool parse(Iterator &first, Iterator const &last,
                    Context const &context, boost::spirit::x3::unused_type,
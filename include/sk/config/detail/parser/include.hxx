@@ -0,0 +1,497 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_PARSER_INCLUDE_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_PARSER_INCLUDE_HXX_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+#include <boost/spirit/home/x3/support/utility/utf8.hpp>
+
+#include <sk/config/detail/glob.hxx>
+#include <sk/config/detail/mapped_file.hxx>
+#include <sk/config/detail/parallel.hxx>
+#include <sk/config/detail/parser/expect.hxx>
+#include <sk/config/detail/parser/intern_scope.hxx>
+#include <sk/config/detail/parser/option_terminator.hxx>
+#include <sk/config/detail/parser/qstring.hxx>
+#include <sk/config/detail/propagate.hxx>
+#include <sk/config/detail/rule.hxx>
+#include <sk/config/error.hxx>
+#include <sk/config/include_cache.hxx>
+#include <sk/config/parse.hxx>
+#include <sk/config/parser_policy.hxx>
+
+namespace sk::config::detail {
+
+    template <typename Policy>
+    constexpr bool allows_include = requires {
+        requires Policy::allow_include;
+    };
+
+    // The file currently being included, and the files which included it.
+    struct include_frame_tag {};
+
+    /*
+     * The identity of a file, used to tell if it's changed.
+     *
+     * File times only have a limited resolution, so a file which is
+     * written twice in quick succession can keep the same time and size.
+     * If the time was too recent to trust when the stamp was made, we also
+     * remember a hash of the contents and check that too.
+     */
+    struct file_stamp {
+        std::filesystem::path path;
+        std::filesystem::file_time_type mtime;
+        std::uintmax_t size;
+        std::optional<std::size_t> hash;
+
+        static auto hash_of(std::string_view contents) -> std::size_t {
+            return std::hash<std::string_view>()(contents);
+        }
+
+        // Create a stamp for a file we've just read.
+        static auto make(std::filesystem::path const &path,
+                         std::filesystem::file_time_type mtime,
+                         std::uintmax_t size, std::string_view contents)
+            -> file_stamp {
+            file_stamp s{path, mtime, size, {}};
+
+            auto now = std::filesystem::file_time_type::clock::now();
+            if (now - mtime < std::chrono::seconds(2))
+                s.hash = hash_of(contents);
+            return s;
+        }
+
+        auto changed() const -> bool {
+            std::error_code ec;
+            auto mtime_ = std::filesystem::last_write_time(path, ec);
+            auto size_ = std::filesystem::file_size(path, ec);
+            if (ec || mtime_ != mtime || size_ != size)
+                return true;
+
+            if (!hash)
+                return false;
+
+            try {
+                mapped_file file(path);
+                return hash_of({file.data(), file.size()}) != *hash;
+            } catch (std::system_error const &) {
+                return true;
+            }
+        }
+    };
+
+    struct include_frame {
+        std::filesystem::path path;
+        include_frame const *parent;
+
+        // The files included by this file, if they should be recorded.
+        std::vector<file_stamp> *includes;
+    };
+
+    /*
+     * include_fragment: a parsed include file.  This is stored in the
+     * include_cache and applied to each configuration which includes it.
+     *
+     * Applying a fragment copies the values in its log.  If any of them
+     * can't be copied, the log isn't kept, and the file is parsed again
+     * each time the fragment is applied.
+     */
+    template <typename T> struct include_fragment {
+        file_stamp stamp;
+        std::string name;
+        std::unique_ptr<mapped_file> file;
+        std::optional<deferred_log<T>> log;
+
+        // Parse the file again and apply it, if the log can't be copied.
+        std::function<void(T &)> reparse;
+
+        // Every file included by this one, directly or indirectly.
+        std::vector<file_stamp> includes;
+
+        // Returns true if none of our included files have changed.
+        auto is_current() const -> bool {
+            return std::ranges::none_of(includes, &file_stamp::changed);
+        }
+
+        void apply(T &ret) const {
+            namespace x3 = boost::spirit::x3;
+
+            try {
+                if (reparse)
+                    reparse(ret);
+                else
+                    log->replay_copy(ret);
+            } catch (x3::expectation_failure<char const *> const &x) {
+                throw make_replay_error(x, file->begin(), file->end(), name);
+            }
+        }
+    };
+
+} // namespace sk::config::detail
+
+namespace sk::config::detail::parser {
+
+    /*
+     * include_parser: parse `include "pattern";` and apply the matching
+     * files to the configuration.  Members is the parser for the other
+     * statements allowed in the configuration, which is used to parse the
+     * included files.
+     *
+     * This does nothing unless the parser policy sets allow_include.
+     */
+    template <typename T, typename Members>
+    struct include_parser
+        : boost::spirit::x3::parser<include_parser<T, Members>> {
+        using attribute_type = boost::spirit::x3::unused_type;
+        static bool const has_attribute = false;
+
+        using fragment_type = include_fragment<T>;
+        using fragment_ptr = std::shared_ptr<fragment_type const>;
+
+        Members members;
+
+        explicit include_parser(Members const &members_) : members(members_) {}
+
+        template <typename Iterator, typename Context, typename RContext,
+                  typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, RContext &rcontext,
+                   Attribute &) const {
+            namespace x3 = boost::spirit::x3;
+
+            if constexpr (!allows_include<policy_of<Context>>) {
+                return false;
+            } else {
+                static auto const keyword = x3::lexeme
+                    [x3::lit("include") >>
+                     !(x3::ascii::alnum | x3::lit('-') | x3::lit('_'))];
+                static auto const filename = expect[qstring<char>()];
+                static auto const terminator =
+                    expect[x3::no_skip[option_terminator]];
+
+                if (!keyword.parse(first, last, context, x3::unused,
+                                   x3::unused))
+                    return false;
+
+                x3::skip_over(first, last, context);
+                auto where = first;
+
+                std::string pattern;
+                if (!filename.parse(first, last, context, x3::unused,
+                                    pattern) ||
+                    !terminator.parse(first, last, context, x3::unused,
+                                      x3::unused))
+                    return false;
+
+                // Make the rule's value available as _val(), as it would
+                // be in a semantic action.
+                auto const val_context =
+                    x3::make_context<x3::rule_val_context_tag>(rcontext,
+                                                               context);
+                return include(where, pattern, val_context);
+            }
+        }
+
+      private:
+        /*
+         * Apply the files matching pattern.  Returns false if an error was
+         * recorded rather than thrown.
+         */
+        template <typename Iterator, typename Context>
+        bool include(Iterator where, std::string const &pattern,
+                     Context const &context) const {
+            namespace x3 = boost::spirit::x3;
+            namespace fs = std::filesystem;
+
+            auto &error_handler = x3::get<x3::error_handler_tag>(context).get();
+            auto error_at = [&](std::string const &message) {
+                return parse_error(message, std::vector<error_detail>{
+                                                error_handler.format(
+                                                    where, message)});
+            };
+
+            // Throw an error, or record it if errors aren't being thrown.
+            auto fail = [&](parse_error x) -> bool {
+                if constexpr (is_no_throw<Context>) {
+                    auto &state = x3::get<no_throw_tag>(context).get();
+                    state.unwinding = true;
+                    state.failed = true;
+
+                    for (auto &&e : x.errors)
+                        error_handler.report(std::move(e));
+                    return false;
+                } else {
+                    throw x;
+                }
+            };
+
+            // Relative paths are relative to the including file.
+            include_frame const *parent = nullptr;
+            fs::path directory =
+                fs::path(error_handler.filename()).parent_path();
+
+            using frame_ref = std::remove_cvref_t<decltype(x3::get<
+                                                           include_frame_tag>(
+                context))>;
+            std::optional<include_frame> root;
+
+            if constexpr (!std::is_same_v<frame_ref, x3::unused_type>) {
+                parent = &x3::get<include_frame_tag>(context).get();
+                directory = parent->path.parent_path();
+            } else if (!error_handler.filename().empty()) {
+                // The top-level file, so it can't include itself.
+                std::error_code ec;
+                auto canonical = fs::canonical(error_handler.filename(), ec);
+                if (!ec) {
+                    root.emplace(canonical, nullptr, nullptr);
+                    parent = &*root;
+                }
+            }
+
+            auto &cache = x3::get<include_cache_tag>(context).get();
+            auto const glob = directory / fs::path(pattern);
+            auto paths = expand_glob(glob);
+
+            // Remember what the pattern matched, so a snapshot can tell
+            // if a file has been added or removed since.
+            if (has_wildcards(glob.filename().string()))
+                cache.record_glob(glob, paths);
+
+            for (auto &&path : paths) {
+                std::error_code ec;
+                auto canonical = fs::canonical(path, ec);
+
+                for (auto *f = parent; !ec && f; f = f->parent)
+                    if (f->path == canonical)
+                        return fail(error_at("include file \"" + pattern +
+                                             "\" includes itself"));
+            }
+
+            // Files included by the same statement are loaded at the same
+            // time.
+            std::vector<fragment_ptr> fragments(paths.size());
+            std::vector<std::exception_ptr> errors(paths.size());
+
+            parallel_for(paths.size(), [&](std::size_t i) {
+                try {
+                    fragments[i] = load<policy_of<Context>>(paths[i], cache,
+                                                            parent);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+
+            for (auto &&e : errors) {
+                if (!e)
+                    continue;
+
+                try {
+                    std::rethrow_exception(e);
+                } catch (parse_error &x) {
+                    x.errors.push_back(
+                        error_handler.format(where, "included from here"));
+                    return fail(std::move(x));
+                } catch (std::system_error const &x) {
+                    return fail(error_at("cannot read include file \"" +
+                                         pattern +
+                                         "\": " + x.code().message()));
+                }
+            }
+
+            if (parent && parent->includes) {
+                for (auto &&f : fragments) {
+                    parent->includes->push_back(f->stamp);
+                    parent->includes->insert(parent->includes->end(),
+                                             f->includes.begin(),
+                                             f->includes.end());
+                }
+            }
+
+            propagate_call(context, [fragments](T &ret) {
+                for (auto &&f : fragments)
+                    f->apply(ret);
+            });
+            return true;
+        }
+
+        /*
+         * Return the parsed contents of the file at path, from the cache
+         * if possible.
+         */
+        template <typename Policy>
+        auto load(std::filesystem::path const &path, include_cache &cache,
+                  include_frame const *parent) const -> fragment_ptr {
+            namespace x3 = boost::spirit::x3;
+            namespace fs = std::filesystem;
+
+            auto canonical = fs::canonical(path);
+            auto mtime = fs::last_write_time(canonical);
+            auto size = fs::file_size(canonical);
+
+            auto cached = cache.find<fragment_type>(canonical, mtime, size);
+            if (cached && !cached->stamp.changed() && cached->is_current())
+                return cached;
+
+            auto fragment = std::make_shared<fragment_type>();
+            fragment->name = x3::to_utf8(path.native());
+            fragment->file = std::make_unique<mapped_file>(canonical);
+            fragment->stamp = file_stamp::make(
+                canonical, mtime, size,
+                {fragment->file->data(), fragment->file->size()});
+
+            T placeholder{};
+            fragment->log.emplace(&placeholder);
+
+            include_frame frame{canonical, parent, &fragment->includes};
+            parse_fragment<Policy>(*fragment, *fragment->log, frame, cache,
+                                   placeholder);
+
+            // Values which can't be copied are parsed again each time the
+            // fragment is applied.  The files it includes have already
+            // been checked for cycles, so there are no parent frames.
+            //
+            // The fragment can be applied after the parse which loaded it
+            // has returned (for example by parse_files()), when cache
+            // might no longer exist, so the included files are loaded
+            // into a cache of the reparse's own.
+            if (!fragment->log->copyable()) {
+                fragment->log.reset();
+                fragment->reparse = [self = *this,
+                                     f = fragment.get()](T &ret) {
+                    T placeholder{};
+                    deferred_log<T> log(&placeholder);
+                    include_cache cache;
+                    include_frame frame{f->stamp.path, nullptr, nullptr};
+                    self.template parse_fragment<Policy>(*f, log, frame, cache,
+                                                         placeholder);
+                    log.replay(ret);
+                };
+            }
+
+            cache.insert<fragment_type>(canonical, mtime, size, fragment);
+            return fragment;
+        }
+
+        // Parse the file of a fragment into log.
+        template <typename Policy>
+        void parse_fragment(fragment_type const &fragment, deferred_log<T> &log,
+                            include_frame const &frame, include_cache &cache,
+                            T &placeholder) const {
+            namespace x3 = boost::spirit::x3;
+
+            // A fragment can outlive the parse which loaded it, so its
+            // strings are interned in a table of its own.
+            auto do_nothing = [&](auto &) {};
+            auto const body = rule<T>(
+                "config",
+                intern_scope(x3::eps >>
+                             expect[(*(*this | members))[do_nothing]] >>
+                             expect[x3::eoi]));
+            auto const grammar = x3::with<include_cache_tag>(std::ref(cache))
+                [x3::with<include_frame_tag>(std::cref(frame))
+                     [x3::with<deferred_tag>(std::ref(log))[body]]];
+
+            parse_at<Policy>(fragment.file->begin(), fragment.file->begin(),
+                             fragment.file->end(), grammar, placeholder,
+                             fragment.name, 1);
+        }
+    };
+
+    /*
+     * include_scope: provide an include_cache for the subject, unless one
+     * was already provided.
+     */
+    template <typename Subject>
+    struct include_scope
+        : boost::spirit::x3::unary_parser<Subject, include_scope<Subject>> {
+        using base_type =
+            boost::spirit::x3::unary_parser<Subject, include_scope<Subject>>;
+        static bool const is_pass_through_unary = true;
+
+        constexpr include_scope(Subject const &subject) : base_type(subject) {}
+
+        template <typename Iterator, typename Context, typename RContext,
+                  typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, RContext &rcontext,
+                   Attribute &attr) const {
+            namespace x3 = boost::spirit::x3;
+
+            using cache_ref = std::remove_cvref_t<decltype(x3::get<
+                                                           include_cache_tag>(
+                context))>;
+
+            if constexpr (allows_include<policy_of<Context>> &&
+                          std::is_same_v<cache_ref, x3::unused_type>) {
+                include_cache cache;
+                auto const subject =
+                    x3::with<include_cache_tag>(std::ref(cache))[this->subject];
+                return subject.parse(first, last, context, rcontext, attr);
+            } else {
+                return this->subject.parse(first, last, context, rcontext,
+                                           attr);
+            }
+        }
+    };
+
+    template <typename Subject>
+    include_scope(Subject const &) -> include_scope<Subject>;
+
+} // namespace sk::config::detail::parser
+
+namespace boost::spirit::x3 {
+
+    template <typename T, typename Members>
+    struct get_info<sk::config::detail::parser::include_parser<T, Members>> {
+        typedef std::string result_type;
+        result_type
+        operator()(sk::config::detail::parser::include_parser<T, Members> const &)
+            const {
+            return "include statement";
+        }
+    };
+
+} // namespace boost::spirit::x3
+
+#endif // SK_CONFIG_DETAIL_PARSER_INCLUDE_HXX_INCLUDED
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_PARSER_INTERN_SCOPE_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_PARSER_INTERN_SCOPE_HXX_INCLUDED
+
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/interned_string.hxx>
+
+namespace sk::config {
+
+    // The context holds the table to intern strings in.
+    struct intern_table_tag {};
+
+} // namespace sk::config
+
+namespace sk::config::detail {
+
+    /*
+     * lazy_intern_table: the default table for a parse.  The table is
+     * only created if a string is interned, and is kept alive afterwards
+     * by the strings which refer to it.
+     */
+    class lazy_intern_table {
+      public:
+        auto intern(std::string_view s) -> interned_string {
+            if (s.empty())
+                return interned_string();
+
+            // Included files can be parsed on several threads.
+            std::call_once(created, [&] { table.emplace(); });
+            return table->intern(s);
+        }
+
+      private:
+        std::once_flag created;
+        std::optional<shared_intern_table> table;
+    };
+
+} // namespace sk::config::detail
+
+namespace sk::config::detail::parser {
+
+    /*
+     * intern_scope: provide a table of its own for the strings interned
+     * by the subject, unless a table was already provided.
+     */
+    template <typename Subject>
+    struct intern_scope
+        : boost::spirit::x3::unary_parser<Subject, intern_scope<Subject>> {
+        using base_type =
+            boost::spirit::x3::unary_parser<Subject, intern_scope<Subject>>;
+        static bool const is_pass_through_unary = true;
+
+        constexpr intern_scope(Subject const &subject) : base_type(subject) {}
+
+        template <typename Iterator, typename Context, typename RContext,
+                  typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, RContext &rcontext,
+                   Attribute &attr) const {
+            namespace x3 = boost::spirit::x3;
+
+            using table_ref = std::remove_cvref_t<decltype(x3::get<
+                                                           intern_table_tag>(
+                context))>;
+
+            if constexpr (std::is_same_v<table_ref, x3::unused_type>) {
+                lazy_intern_table table;
+                auto const subject =
+                    x3::with<intern_table_tag>(std::ref(table))[this->subject];
+                return subject.parse(first, last, context, rcontext, attr);
+            } else {
+                return this->subject.parse(first, last, context, rcontext,
+                                           attr);
+            }
+        }
+    };
+
+    template <typename Subject>
+    intern_scope(Subject const &) -> intern_scope<Subject>;
+
+} // namespace sk::config::detail::parser
+
+#endif // SK_CONFIG_DETAIL_PARSER_INTERN_SCOPE_HXX_INCLUDED
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_PARSER_KEYWORDS_HXX_INCLUDED
+#define SK_CONFIG_PARSER_KEYWORDS_HXX_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/described.hxx>
+
+namespace sk::config::detail::parser {
+
+    // Characters which can appear in a keyword; see identifier.
+    constexpr auto is_keyword_char(char c) -> bool {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+               (c >= '0' && c <= '9') || c == '-' || c == '_';
+    }
+
+    /*
+     * keyword_table: a perfect hash from keywords to member indices,
+     * built with hash-and-displace.  Keywords are hashed once; each
+     * bucket of keywords has a displacement which moves them to free
+     * slots, so a lookup is one hash, one displacement and one string
+     * comparison.
+     */
+    class keyword_table {
+    public:
+        static constexpr std::uint32_t npos = ~std::uint32_t(0);
+
+        keyword_table() = default;
+
+        // Add a keyword.  Throws std::logic_error if it's a duplicate.
+        void add(std::string keyword, std::uint32_t index) {
+            for (auto &&e : entries)
+                if (e.keyword == keyword)
+                    boost::throw_exception(std::logic_error(
+                        "duplicate keyword \"" + keyword + "\""));
+            entries.push_back({std::move(keyword), index});
+        }
+
+        // Build the hash table once all the keywords have been added.
+        void build() {
+            if (entries.empty())
+                return;
+
+            auto nslots = std::bit_ceil(entries.size() * 2);
+            auto nbuckets = std::max<std::size_t>(1, entries.size() / 2);
+
+            for (;;) {
+                if (try_build(nslots, nbuckets))
+                    return;
+                // Displacement failed; this is very unlikely, but a
+                // larger table will always succeed eventually.
+                nslots *= 2;
+            }
+        }
+
+        // Return the index of keyword, or npos.
+        auto find(std::string_view keyword) const -> std::uint32_t {
+            if (slots.empty())
+                return npos;
+
+            auto h = hash(keyword);
+            auto d = displacements[bucket(h)];
+            auto &slot = slots[this->slot(h, d)];
+            if (slot.index == npos || slot.keyword != keyword)
+                return npos;
+            return slot.index;
+        }
+
+    private:
+        struct entry {
+            std::string keyword;
+            std::uint32_t index = npos;
+        };
+
+        std::vector<entry> entries;
+        std::vector<entry> slots;
+        std::vector<std::uint32_t> displacements;
+
+        static auto hash(std::string_view s) -> std::uint64_t {
+            // FNV-1a; keywords are short, so this is fast enough.
+            std::uint64_t h = 0xcbf29ce484222325ULL;
+            for (unsigned char c : s)
+                h = (h ^ c) * 0x100000001b3ULL;
+            return h;
+        }
+
+        static auto mix(std::uint64_t h) -> std::uint64_t {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        auto bucket(std::uint64_t h) const -> std::size_t {
+            return (h >> 32) % displacements.size();
+        }
+
+        auto slot(std::uint64_t h, std::uint32_t d) const -> std::size_t {
+            return mix(h + d * 0x9e3779b97f4a7c15ULL) & (slots.size() - 1);
+        }
+
+        auto try_build(std::size_t nslots, std::size_t nbuckets) -> bool {
+            slots.assign(nslots, entry{});
+            displacements.assign(nbuckets, 0);
+
+            std::vector<std::vector<std::size_t>> buckets(nbuckets);
+            for (std::size_t i = 0; i < entries.size(); ++i)
+                buckets[bucket(hash(entries[i].keyword))].push_back(i);
+
+            // Place the largest buckets first, while the table is empty.
+            std::vector<std::size_t> order(nbuckets);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(),
+                             [&](auto a, auto b) {
+                                 return buckets[a].size() > buckets[b].size();
+                             });
+
+            std::vector<std::size_t> placed;
+            for (auto b : order) {
+                if (buckets[b].empty())
+                    break;
+
+                for (std::uint32_t d = 0;; ++d) {
+                    if (d == 1024 * nslots)
+                        return false;
+
+                    placed.clear();
+                    for (auto i : buckets[b]) {
+                        auto s = slot(hash(entries[i].keyword), d);
+                        if (slots[s].index != npos ||
+                            std::ranges::find(placed, s) != placed.end())
+                            break;
+                        placed.push_back(s);
+                    }
+
+                    if (placed.size() != buckets[b].size())
+                        continue;
+
+                    displacements[b] = d;
+                    for (std::size_t j = 0; j < placed.size(); ++j)
+                        slots[placed[j]] = entries[buckets[b][j]];
+                    break;
+                }
+            }
+
+            return true;
+        }
+    };
+
+    /*
+     * keywords<Members...>: parse one of the members, which are options or
+     * blocks.  This is equivalent to (members | ...), except that the
+     * keyword at the start of the statement is read once and looked up in
+     * a hash table, rather than trying each member in turn, and a member
+     * only matches if its label is followed by a keyword boundary.
+     *
+     * Members whose label isn't a plain keyword (for example, a custom
+     * Spirit parser) are tried in order if no keyword matches.
+     */
+    template <typename... Members>
+    struct keywords : boost::spirit::x3::parser<keywords<Members...>> {
+        using attribute_type = boost::spirit::x3::unused_type;
+        static bool const has_attribute = false;
+
+        std::tuple<Members...> members;
+        std::shared_ptr<keyword_table const> table;
+        std::vector<std::uint32_t> fallback;
+
+        explicit keywords(Members... members_)
+            : members(std::move(members_)...) {
+            auto table_ = std::make_shared<keyword_table>();
+
+            std::uint32_t i = 0;
+            std::apply(
+                [&](auto const &...m) {
+                    (add_member(*table_, label_of(m), i++), ...);
+                },
+                members);
+
+            table_->build();
+            table = std::move(table_);
+        }
+
+        template <typename Iterator, typename Context, typename RContext,
+                  typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, RContext &rcontext,
+                   Attribute &) const {
+            namespace x3 = boost::spirit::x3;
+
+            x3::skip_over(first, last, context);
+
+            auto end = first;
+            while (end != last && is_keyword_char(*end))
+                ++end;
+
+            if (end != first) {
+                auto index = lookup(first, end);
+                if (index != keyword_table::npos)
+                    return call(index, first, last, context, rcontext);
+            }
+
+            for (auto index : fallback)
+                if (call(index, first, last, context, rcontext))
+                    return true;
+
+            return false;
+        }
+
+    private:
+        void add_member(keyword_table &t, std::string const &label,
+                        std::uint32_t index) {
+            if (!label.empty() &&
+                std::ranges::all_of(label, [](char c) {
+                    return is_keyword_char(c);
+                }))
+                t.add(label, index);
+            else
+                fallback.push_back(index);
+        }
+
+        template <typename Iterator>
+        auto lookup(Iterator first, Iterator end) const -> std::uint32_t {
+            if constexpr (std::contiguous_iterator<Iterator>)
+                return table->find(std::string_view(
+                    std::to_address(first),
+                    static_cast<std::size_t>(end - first)));
+            else
+                return table->find(std::string(first, end));
+        }
+
+        template <std::size_t I, typename Iterator, typename Context,
+                  typename RContext>
+        static bool call_member(keywords const &self, Iterator &first,
+                                Iterator const &last, Context const &context,
+                                RContext &rcontext) {
+            return std::get<I>(self.members)
+                .parse(first, last, context, rcontext,
+                       boost::spirit::x3::unused);
+        }
+
+        template <typename Iterator, typename Context, typename RContext>
+        bool call(std::uint32_t index, Iterator &first, Iterator const &last,
+                  Context const &context, RContext &rcontext) const {
+            using fn = bool (*)(keywords const &, Iterator &,
+                                Iterator const &, Context const &, RContext &);
+
+            static constexpr auto calls =
+                []<std::size_t... Is>(std::index_sequence<Is...>) {
+                    return std::array<fn, sizeof...(Is)>{
+                        &call_member<Is, Iterator, Context, RContext>...};
+                }(std::index_sequence_for<Members...>{});
+
+            return calls[index](*this, first, last, context, rcontext);
+        }
+    };
+
+    template <typename... Members> auto make_keywords(Members &&...members) {
+        return keywords<std::remove_cvref_t<Members>...>(
+            std::forward<Members>(members)...);
+    }
+
+} // namespace sk::config::detail::parser
+
+namespace boost::spirit::x3 {
+
+    template <typename... Members>
+    struct get_info<sk::config::detail::parser::keywords<Members...>> {
+        typedef std::string result_type;
+        result_type operator()(
+            sk::config::detail::parser::keywords<Members...> const &) const {
+            return "option";
+        }
+    };
+
+} // namespace boost::spirit::x3
+
+#endif // SK_CONFIG_PARSER_KEYWORDS_HXX_INCLUDED
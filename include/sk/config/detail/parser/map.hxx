@@ -37,6 +37,7 @@
 #include <boost/fusion/include/at.hpp>
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/parser/expect.hxx>
 #include <sk/config/parser_policy.hxx>
 
 namespace sk::config::detail::parser {
@@ -48,6 +49,8 @@ namespace sk::config::detail::parser {
      * std::map.
      */
 
+    struct map_item_tag {};
+
     template <typename KeyParser, typename ValueParser>
     struct map : boost::spirit::x3::parser<map<KeyParser, ValueParser>> {
         using key_type = typename KeyParser::attribute_type;
@@ -61,27 +64,23 @@ namespace sk::config::detail::parser {
                    Context const &context, RContext &rcontext,
                    attribute_type &attr) const {
             namespace x3 = boost::spirit::x3;
+            using parser::expect;
 
             auto const &policy = x3::get<parser_policy_tag>(context).get();
 
             static KeyParser key_parser;
             static ValueParser value_parser;
 
-            auto push_back = [&](auto &ctx) {
-                auto const &v = x3::_attr(ctx);
-                attr.push_back(std::make_pair(boost::fusion::at_c<0>(v),
-                                              boost::fusion::at_c<1>(v)));
-            };
-
-            static auto const item_grammar = key_parser                  //
-                                             > policy.option_separator() //
-                                             > value_parser              //
-                                             > policy.option_terminator();
-            static auto const block_grammar =
-                policy.braced(*(item_grammar[push_back]));
-
-            return block_grammar.parse(first, last, context, rcontext,
-                                       x3::unused);
+            static auto const item_grammar =
+                x3::rule<map_item_tag, std::pair<key_type, value_type>>{
+                    "map item"} =
+                    key_parser                                  //
+                    >> expect[policy.option_separator()]        //
+                    >> expect[value_parser]                     //
+                    >> expect[policy.option_terminator()];
+            static auto const block_grammar = policy.braced(*item_grammar);
+
+            return block_grammar.parse(first, last, context, rcontext, attr);
         }
     };
 
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_PARSER_NUMBER_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_PARSER_NUMBER_HXX_INCLUDED
+
+#include <charconv>
+#include <concepts>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <boost/spirit/home/x3.hpp>
+
+// libstdc++ and MSVC have floating-point from_chars, but not every
+// standard library does yet.
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#    define SK_CONFIG_HAVE_FLOAT_FROM_CHARS
+#endif
+
+namespace sk::config::detail::parser {
+
+    template <typename T>
+    struct config_real_policies : boost::spirit::x3::real_policies<T> {};
+
+    // The Spirit parser for T, used for non-contiguous input.
+    template <typename T> struct x3_number_parser;
+
+    template <std::signed_integral T> struct x3_number_parser<T> {
+        using type = boost::spirit::x3::int_parser<T>;
+    };
+
+    template <std::unsigned_integral T> struct x3_number_parser<T> {
+        using type = boost::spirit::x3::uint_parser<T>;
+    };
+
+    template <std::floating_point T> struct x3_number_parser<T> {
+        using type =
+            boost::spirit::x3::real_parser<T, config_real_policies<T>>;
+    };
+
+    template <typename T>
+    concept from_chars_number =
+        std::integral<T>
+#if defined(SK_CONFIG_HAVE_FLOAT_FROM_CHARS)
+        || std::floating_point<T>
+#endif
+        ;
+
+    /*
+     * number_parser<T>: parse a number directly into T with
+     * std::from_chars.  Non-contiguous input is copied into a buffer
+     * first, so every kind of input accepts the same syntax and the same
+     * range: an optional sign (not for unsigned types), and for
+     * floating-point types, an optional fraction and exponent, "inf" or
+     * "nan".  Numbers which are out of range for T are rejected.
+     *
+     * If the standard library has no floating-point from_chars, the
+     * equivalent Spirit parser is used for floating-point types instead.
+     */
+    template <typename T>
+    struct number_parser : boost::spirit::x3::parser<number_parser<T>> {
+        typedef T attribute_type;
+        static bool const has_attribute = true;
+
+        template <typename Iterator, typename Context, typename RContext,
+                  typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, RContext const &rcontext,
+                   Attribute &attr) const {
+            namespace x3 = boost::spirit::x3;
+
+            if constexpr (std::contiguous_iterator<Iterator> &&
+                          sizeof(std::iter_value_t<Iterator>) == 1 &&
+                          from_chars_number<T>) {
+                x3::skip_over(first, last, context);
+
+                T value;
+                if (!parse_contiguous(first, last, value))
+                    return false;
+
+                x3::traits::move_to(value, attr);
+                return true;
+            } else if constexpr (from_chars_number<T>) {
+                x3::skip_over(first, last, context);
+
+                std::string buffer;
+                for (auto it = first; it != last && is_number_char(*it); ++it)
+                    buffer.push_back(static_cast<char>(*it));
+
+                char const *p = buffer.data();
+                char const *const end = p + buffer.size();
+                T value;
+                if (!parse_contiguous(p, end, value))
+                    return false;
+
+                std::advance(first, p - buffer.data());
+                x3::traits::move_to(value, attr);
+                return true;
+            } else {
+                return typename x3_number_parser<T>::type{}.parse(
+                    first, last, context, rcontext, attr);
+            }
+        }
+
+        // Returns true if c can be part of a number.
+        template <typename Char> static bool is_number_char(Char c) {
+            if ((c >= '0' && c <= '9') || c == '+' || c == '-')
+                return true;
+
+            if constexpr (std::floating_point<T>) {
+                // A fraction or exponent, or "inf", "infinity" or "nan".
+                for (char n : std::string_view(".eEinftyaINFTYA"))
+                    if (c == static_cast<Char>(n))
+                        return true;
+            }
+
+            return false;
+        }
+
+        template <typename Iterator>
+        static bool parse_contiguous(Iterator &first, Iterator const &last,
+                                     T &value) {
+            auto begin = reinterpret_cast<char const *>(std::to_address(first));
+            auto end = begin + (last - first);
+            auto p = begin;
+
+            // from_chars doesn't accept a leading '+'.
+            if constexpr (!std::unsigned_integral<T>) {
+                if (p != end && *p == '+') {
+                    if (++p != end && *p == '-')
+                        return false;
+                }
+            }
+
+            std::from_chars_result r;
+            if constexpr (std::floating_point<T>)
+                r = std::from_chars(p, end, value,
+                                    std::chars_format::general);
+            else
+                r = std::from_chars(p, end, value);
+
+            // Out of range values are rejected rather than clamped.
+            if (r.ec != std::errc())
+                return false;
+
+            first += r.ptr - begin;
+            return true;
+        }
+
+        static auto name() -> std::string {
+            if constexpr (std::floating_point<T>)
+                return "a decimal number";
+            else if constexpr (std::unsigned_integral<T>)
+                return "a positive integer";
+            else
+                return "an integer";
+        }
+    };
+
+} // namespace sk::config::detail::parser
+
+namespace boost::spirit::x3 {
+
+    template <typename T>
+    struct get_info<sk::config::detail::parser::number_parser<T>> {
+        typedef std::string result_type;
+        result_type operator()(
+            sk::config::detail::parser::number_parser<T> const &) const {
+            return sk::config::detail::parser::number_parser<T>::name();
+        }
+    };
+
+} // namespace boost::spirit::x3
+
+#endif // SK_CONFIG_DETAIL_PARSER_NUMBER_HXX_INCLUDED
@@ -36,6 +36,7 @@
 #include <boost/fusion/adapted/std_tuple.hpp>
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/parser/expect.hxx>
 #include <sk/config/parser_policy.hxx>
 
 namespace sk::config::detail::parser {
@@ -58,19 +59,21 @@ namespace sk::config::detail::parser {
                    Attribute &attr) const {
 
             namespace x3 = boost::spirit::x3;
+            using parser::expect;
 
             auto const &policy = x3::get<parser_policy_tag>(context).get();
 
             static Parser1 parser1;
             static Parser2 parser2;
-            static auto const inline_grammar = parser1 > ',' > parser2;
-            static auto const braced_grammar = //
-                '{'                            //
-                > parser1                      //
-                > policy.option_terminator()   //
-                > parser2                      //
-                > policy.option_terminator()   //
-                > '}';
+            static auto const inline_grammar =
+                parser1 >> expect[','] >> expect[parser2];
+            static auto const braced_grammar =          //
+                '{'                                     //
+                >> expect[parser1]                      //
+                >> expect[policy.option_terminator()]   //
+                >> expect[parser2]                      //
+                >> expect[policy.option_terminator()]   //
+                >> expect['}'];
 
             if (policy.allow_inline_lists) {
                 if (inline_grammar.parse(first, last, context, x3::unused,
@@ -29,10 +29,14 @@
 #ifndef SK_CONFIG_PARSER_QSTRING_HXX_INCLUDED
 #define SK_CONFIG_PARSER_QSTRING_HXX_INCLUDED
 
+#include <iterator>
+#include <memory>
 #include <string>
 
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/scan.hxx>
+
 namespace sk::config::detail::parser {
 
     template <typename Char>
@@ -60,8 +64,12 @@ namespace sk::config::detail::parser {
 
             ++first;
 
+            if constexpr (std::contiguous_iterator<Iterator> &&
+                          sizeof(std::iter_value_t<Iterator>) == 1)
+                return parse_contiguous(first, last, start, attr);
+
             // Parse the string.
-            attr = "";
+            attr.clear();
             bool in_escape = false;
 
             do {
@@ -111,6 +119,67 @@ namespace sk::config::detail::parser {
             return true;
         }
 
+        /*
+         * The same as parse(), for a contiguous input: rather than looking
+         * at one character at a time, find the next quote or backslash and
+         * append everything before it at once.  first is just after the
+         * opening quote.
+         */
+        template <typename Iterator>
+        static bool parse_contiguous(Iterator &first, Iterator const &last,
+                                     char start, attribute_type &attr) {
+            auto begin = reinterpret_cast<char const *>(std::to_address(first));
+            auto end = begin + (last - first);
+            auto p = begin;
+
+            attr.clear();
+
+            for (;;) {
+                auto q = find_either(p, end, start, '\\');
+                attr.append(p, q);
+
+                if (q == end) {
+                    // Reached end of input and no closing quote.
+                    first = last;
+                    return false;
+                }
+
+                if (*q == start) {
+                    // Got closing quote.
+                    first += (q + 1) - begin;
+                    return true;
+                }
+
+                if (++q == end) {
+                    first = last;
+                    return false;
+                }
+
+                if (*q == start)
+                    // Escaped quote character.
+                    attr += start;
+                else {
+                    switch (*q) {
+                    case 't':
+                        attr += '\t';
+                        break;
+                    case 'n':
+                        attr += '\n';
+                        break;
+                    case '\\':
+                        attr += '\\';
+                        break;
+                    default:
+                        // Unrecognised string escape.
+                        first += q - begin;
+                        return false;
+                    }
+                }
+
+                p = q + 1;
+            }
+        }
+
         template <typename Iterator, typename Context, typename Attribute>
         bool parse(Iterator &first, Iterator const &last,
                    Context const &context, boost::spirit::x3::unused_type,
@@ -34,6 +34,7 @@
 
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/parser/expect.hxx>
 #include <sk/config/parser_policy.hxx>
 
 namespace sk::config::detail::parser {
@@ -63,13 +64,15 @@ namespace sk::config::detail::parser {
                    Context const &context, boost::spirit::x3::unused_type,
                    Attribute &attr) const {
             namespace x3 = boost::spirit::x3;
+            using parser::expect;
 
             auto const &policy = x3::get<parser_policy_tag>(context).get();
 
             static T parser;
             static auto const inline_grammar = parser % ',';
             static auto const braced_grammar =
-                '{' > *(parser > policy.option_terminator()) > '}';
+                '{' >> expect[*(parser >> expect[policy.option_terminator()])] >>
+                expect['}'];
 
             if (policy.allow_inline_lists) {
                 if (inline_grammar.parse(first, last, context, x3::unused,
@@ -29,8 +29,20 @@
 #ifndef SK_CONFIG_DETAIL_PROPAGATE_HXX_INCLUDED
 #define SK_CONFIG_DETAIL_PROPAGATE_HXX_INCLUDED
 
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/freeze.hxx>
+
 namespace sk::config::detail {
 
     // T <- T
@@ -42,6 +54,366 @@ namespace sk::config::detail {
         propagate_value(ctx, to, from);
     }
 
+    struct deferred_tag {};
+
+    /*
+     * Returns true if an A can be copied.  std::is_copy_constructible
+     * isn't enough on its own, since the standard containers claim to be
+     * copyable even when their elements aren't.
+     */
+    template <typename A>
+    inline constexpr bool is_copyable = std::is_copy_constructible_v<A>;
+
+    template <typename A>
+        requires requires { typename A::value_type; }
+    inline constexpr bool is_copyable<A> =
+        std::is_copy_constructible_v<A> &&
+        is_copyable<std::remove_const_t<typename A::value_type>>;
+
+    /*
+     * deferred_log: a record of assignments to the members of a T, which
+     * can be applied to a T later.
+     *
+     * This is used to parse several inputs at the same time: each input
+     * is parsed into its own log, and the logs are applied to the result
+     * afterwards in a fixed order, which gives the same result as parsing
+     * the inputs one at a time.  Only assignments to the top-level object
+     * (the one passed to the constructor) are deferred.
+     *
+     * Errors raised by propagate_value() while applying the log, such as
+     * duplicate map keys, are thrown as x3::expectation_failure with the
+     * position recorded when the assignment was parsed.
+     */
+    template <typename T> class deferred_log {
+      public:
+        using value_type = T;
+
+        explicit deferred_log(T const *target_) : target(target_) {}
+
+        // Returns true if assignments to to should be deferred.
+        auto defers(T const &to) const -> bool {
+            return &to == target;
+        }
+
+        template <typename Context, typename V, typename A, typename... Name>
+        void defer(Context const &ctx, V T::*member, A &attr, Name... name) {
+            namespace x3 = boost::spirit::x3;
+
+            using where_type = std::remove_cvref_t<decltype(x3::_where(ctx))>;
+            using op_type =
+                deferred_op<where_type, V, std::remove_cvref_t<A>, Name...>;
+
+            // The member's offset identifies it for reparser.
+            auto const &to = target->*member;
+            auto offset = static_cast<std::size_t>(
+                reinterpret_cast<char const *>(std::addressof(to)) -
+                reinterpret_cast<char const *>(target));
+
+            ops.push_back(std::make_unique<op_type>(
+                x3::_where(ctx), member, offset, std::move(attr), name...));
+        }
+
+        // Record a call to fn(ret), to be made when the log is applied.
+        void defer_call(std::function<void(T &)> fn) {
+            ops.push_back(std::make_unique<call_op>(std::move(fn)));
+            calls = true;
+        }
+
+        // Returns true if the log contains any calls from defer_call().
+        auto has_calls() const -> bool {
+            return calls;
+        }
+
+        // Returns true if replay_copy() can be used.
+        auto copyable() const -> bool {
+            for (auto &&op : ops)
+                if (!op->copyable())
+                    return false;
+            return true;
+        }
+
+        // Apply the log to ret, in the order it was recorded.
+        void replay(T &ret) {
+            freeze_list list(ret);
+            replay(ret, list);
+            list.freeze();
+        }
+
+        /*
+         * Apply the log to ret, adding the members to be frozen to list
+         * rather than freezing them.  This is used to apply several logs
+         * to the same object and freeze it once at the end.
+         */
+        void replay(T &ret, freeze_list &list) {
+            for (auto &&op : ops)
+                op->apply(ret, list);
+            ops.clear();
+        }
+
+        /*
+         * Apply a copy of the log to ret, leaving the log unchanged.  The
+         * log must be copyable().
+         */
+        void replay_copy(T &ret) const {
+            freeze_list list(ret);
+            replay_copy(ret, list);
+            list.freeze();
+        }
+
+        // As replay_copy(), without freezing the members in list.
+        void replay_copy(T &ret, freeze_list &list) const {
+            for (auto &&op : ops)
+                op->apply_copy(ret, list);
+        }
+
+        /*
+         * How an assignment in the log can be undone, so that reparser
+         * can update a previous result rather than building a new one:
+         *
+         * - keyed: it inserted a named block into a container which can
+         *   erase the block by its name.  The member can also be reset.
+         * - reset: the member can be reset to its default value, and the
+         *   assignments to it applied again.
+         * - fixed: neither.  This includes calls from defer_call().
+         */
+        enum class undo { keyed, reset, fixed };
+
+        // The member of T which an assignment changes.
+        struct assignment {
+            // The offset of the member in T; none for a call.
+            std::size_t member;
+            undo how;
+        };
+
+        static constexpr std::size_t none =
+            std::numeric_limits<std::size_t>::max();
+
+        // Every assignment in the log, in the order it was recorded.
+        auto assignments() const -> std::vector<assignment> {
+            std::vector<assignment> ret;
+            ret.reserve(ops.size());
+            for (auto &&op : ops)
+                ret.push_back({op->member(), op->how()});
+            return ret;
+        }
+
+        /*
+         * As replay_copy(), but only apply the assignments to members for
+         * which pred(member) is true.
+         */
+        template <typename Pred>
+        void replay_copy_if(T &ret, freeze_list &list, Pred pred) const {
+            for (auto &&op : ops)
+                if (pred(op->member()))
+                    op->apply_copy(ret, list);
+        }
+
+        /*
+         * Undo the keyed assignments to members for which pred(member) is
+         * true, by erasing the blocks they inserted.
+         */
+        template <typename Pred> void retract_if(T &ret, Pred pred) const {
+            for (auto &&op : ops)
+                if (op->how() == undo::keyed && pred(op->member()))
+                    op->retract(ret);
+        }
+
+        /*
+         * Reset a member to its default value.  The log must contain a
+         * keyed or reset assignment to the member.
+         */
+        void reset(T &ret, std::size_t member) const {
+            for (auto &&op : ops) {
+                if (op->member() == member && op->how() != undo::fixed) {
+                    op->reset(ret);
+                    return;
+                }
+            }
+
+            throw std::logic_error("sk::config: cannot reset this member");
+        }
+
+      private:
+        struct op_base {
+            virtual ~op_base() = default;
+            virtual void apply(T &ret, freeze_list &list) = 0;
+            virtual void apply_copy(T &ret, freeze_list &list) const = 0;
+            virtual auto copyable() const -> bool = 0;
+            virtual auto member() const -> std::size_t = 0;
+            virtual auto how() const -> undo = 0;
+            virtual void retract(T &ret) const = 0;
+            virtual void reset(T &ret) const = 0;
+        };
+
+        struct call_op final : op_base {
+            std::function<void(T &)> fn;
+
+            explicit call_op(std::function<void(T &)> fn_)
+                : fn(std::move(fn_)) {}
+
+            void apply(T &ret, freeze_list &) override { fn(ret); }
+            void apply_copy(T &ret, freeze_list &) const override {
+                fn(ret);
+            }
+            auto copyable() const -> bool override { return true; }
+            auto member() const -> std::size_t override { return none; }
+            auto how() const -> undo override { return undo::fixed; }
+            void retract(T &) const override {}
+            void reset(T &) const override {}
+        };
+
+        template <typename Where, typename V, typename A, typename... Name>
+        struct deferred_op final : op_base {
+            Where where;
+            V T::*member_ptr;
+            std::size_t offset;
+            A value;
+            std::tuple<Name...> name;
+
+            // The member can be replaced by a default-constructed V.
+            static constexpr bool resettable =
+                std::is_default_constructible_v<V> &&
+                std::is_move_assignable_v<V>;
+
+            // A named block, which can be erased from the member by name.
+            static constexpr bool keyed =
+                resettable && sizeof...(Name) == 1 &&
+                requires(V &to, A const &from, Name... n) {
+                    to.erase((from.*n)...);
+                };
+
+            deferred_op(Where where_, V T::*member_, std::size_t offset_,
+                        A &&value_, Name... name_)
+                : where(where_), member_ptr(member_), offset(offset_),
+                  value(std::move(value_)), name(name_...) {}
+
+            void apply(T &ret, freeze_list &list) override {
+                apply_value(ret, value, list);
+            }
+
+            void apply_copy(T &ret, freeze_list &list) const override {
+                if constexpr (is_copyable<A>) {
+                    A copy(value);
+                    apply_value(ret, copy, list);
+                } else {
+                    throw std::logic_error(
+                        "sk::config: cannot copy a non-copyable value");
+                }
+            }
+
+            auto copyable() const -> bool override {
+                return is_copyable<A>;
+            }
+
+            auto member() const -> std::size_t override {
+                return offset;
+            }
+
+            auto how() const -> undo override {
+                if constexpr (keyed)
+                    return undo::keyed;
+                else if constexpr (resettable)
+                    return undo::reset;
+                else
+                    return undo::fixed;
+            }
+
+            void retract(T &ret) const override {
+                if constexpr (keyed) {
+                    auto &to = ret.*member_ptr;
+                    std::apply([&](auto... n) { to.erase((value.*n)...); },
+                               name);
+                }
+            }
+
+            void reset(T &ret) const override {
+                if constexpr (resettable)
+                    ret.*member_ptr = V();
+            }
+
+            void apply_value(T &ret, A &from, freeze_list &list) const {
+                namespace x3 = boost::spirit::x3;
+
+                // propagate_value() only needs _where() and the
+                // freeze_list from the context.
+                auto const log_ctx = x3::make_context<deferred_tag>(*this);
+                auto const list_ctx =
+                    x3::make_context<freeze_list_tag>(list, log_ctx);
+                auto const ctx =
+                    x3::make_context<x3::where_context_tag>(where, list_ctx);
+
+                std::apply(
+                    [&](auto... n) {
+                        propagate_value(ctx, ret.*member_ptr, from, n...);
+                    },
+                    name);
+            }
+        };
+
+        T const *target;
+        std::vector<std::unique_ptr<op_base>> ops;
+        bool calls = false;
+    };
+
+    /*
+     * Assign attr to the given member of the rule's value, or record the
+     * assignment if we're parsing into a deferred_log.
+     */
+    template <typename Context, typename T, typename V, typename A,
+              typename... Name>
+    void propagate_member(Context &ctx, V T::*member, A &attr, Name... name) {
+        namespace x3 = boost::spirit::x3;
+
+        auto &to = x3::_val(ctx);
+
+        using log_ref =
+            std::remove_cvref_t<decltype(x3::get<deferred_tag>(ctx))>;
+        if constexpr (!std::is_same_v<log_ref, x3::unused_type>) {
+            auto &log = x3::get<deferred_tag>(ctx).get();
+            using log_type = std::remove_cvref_t<decltype(log)>;
+
+            if constexpr (std::is_same_v<
+                              typename log_type::value_type,
+                              std::remove_cvref_t<decltype(to)>>) {
+                if (log.defers(to)) {
+                    log.defer(ctx, member, attr, name...);
+                    return;
+                }
+            }
+        }
+
+        propagate_value(ctx, to.*member, attr, name...);
+    }
+
+    /*
+     * Call fn(_val(ctx)), or record the call if we're parsing into a
+     * deferred_log.
+     */
+    template <typename Context, typename Fn>
+    void propagate_call(Context &ctx, Fn fn) {
+        namespace x3 = boost::spirit::x3;
+
+        auto &to = x3::_val(ctx);
+
+        using log_ref =
+            std::remove_cvref_t<decltype(x3::get<deferred_tag>(ctx))>;
+        if constexpr (!std::is_same_v<log_ref, x3::unused_type>) {
+            auto &log = x3::get<deferred_tag>(ctx).get();
+            using log_type = std::remove_cvref_t<decltype(log)>;
+
+            if constexpr (std::is_same_v<
+                              typename log_type::value_type,
+                              std::remove_cvref_t<decltype(to)>>) {
+                if (log.defers(to)) {
+                    log.defer_call(std::move(fn));
+                    return;
+                }
+            }
+        }
+
+        fn(to);
+    }
+
     template <typename T, typename V> struct propagate {
         V T::*member;
 
@@ -50,7 +422,7 @@ namespace sk::config::detail {
         template <typename Context> void operator()(Context &ctx) {
             namespace x3 = boost::spirit::x3;
 
-            propagate_value(ctx, x3::_val(ctx).*member, x3::_attr(ctx));
+            propagate_member(ctx, member, x3::_attr(ctx));
         }
     };
     template <typename T, typename V> propagate(V T::*) -> propagate<T, V>;
@@ -66,7 +438,7 @@ namespace sk::config::detail {
         template <typename Context> void operator()(Context &ctx) {
             namespace x3 = boost::spirit::x3;
 
-            propagate_value(ctx, x3::_val(ctx).*member, x3::_attr(ctx), name);
+            propagate_member(ctx, member, x3::_attr(ctx), name);
         }
     };
     template <typename T, typename V, typename U, typename W>
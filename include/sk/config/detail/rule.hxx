@@ -31,15 +31,21 @@
 
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/parser/expect.hxx>
 #include <sk/config/error.hxx>
 
 namespace sk::config::detail {
 
+#ifdef BOOST_NO_EXCEPTIONS
+    // Without exceptions, errors are reported by error_boundary instead.
+    struct rule_tag {};
+#else
     struct rule_tag : parser_error_handler {};
+#endif
 
     template <typename T, typename P> auto rule(const char *debug, P p) {
         namespace x3 = boost::spirit::x3;
-        return x3::rule<rule_tag, T>{debug} = p;
+        return x3::rule<rule_tag, T>{debug} = parser::error_boundary(p);
     };
 
 } // namespace sk::config::parser
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_SCAN_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_SCAN_HXX_INCLUDED
+
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define SK_CONFIG_HAVE_SSE2
+#    include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#    define SK_CONFIG_HAVE_AVX2
+#    include <immintrin.h>
+#endif
+
+namespace sk::config::detail {
+
+    /*
+     * find_either(first, last, a, b): return a pointer to the first
+     * character in [first, last) which is either a or b, or last if there
+     * isn't one.  This uses AVX2 or SSE2 if the target supports it.
+     */
+    inline auto find_either(char const *first, char const *last, char a,
+                            char b) -> char const * {
+#if defined(SK_CONFIG_HAVE_AVX2)
+        auto const va = _mm256_set1_epi8(a);
+        auto const vb = _mm256_set1_epi8(b);
+
+        while (last - first >= 32) {
+            auto v = _mm256_loadu_si256(
+                reinterpret_cast<__m256i const *>(first));
+            auto m = static_cast<unsigned>(_mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, va),
+                                _mm256_cmpeq_epi8(v, vb))));
+            if (m)
+                return first + std::countr_zero(m);
+            first += 32;
+        }
+#endif
+
+#if defined(SK_CONFIG_HAVE_SSE2)
+        auto const va16 = _mm_set1_epi8(a);
+        auto const vb16 = _mm_set1_epi8(b);
+
+        while (last - first >= 16) {
+            auto v =
+                _mm_loadu_si128(reinterpret_cast<__m128i const *>(first));
+            auto m = static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, va16),
+                                               _mm_cmpeq_epi8(v, vb16))));
+            if (m)
+                return first + std::countr_zero(m);
+            first += 16;
+        }
+#endif
+
+        while (first != last && *first != a && *first != b)
+            ++first;
+        return first;
+    }
+
+} // namespace sk::config::detail
+
+#endif // SK_CONFIG_DETAIL_SCAN_HXX_INCLUDED
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_DETAIL_STATEMENT_SCANNER_HXX_INCLUDED
+#define SK_CONFIG_DETAIL_STATEMENT_SCANNER_HXX_INCLUDED
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace sk::config::detail {
+
+    /*
+     * statement_scanner: find the ends of top-level statements without
+     * parsing them.
+     *
+     * A top-level statement ends with a ';' which is not inside braces,
+     * a quoted string, a comment or a heredoc.  This is a much simpler
+     * (and faster) job than parsing the statement, and it lets us split
+     * the input into pieces which can each be given to the real parser.
+     *
+     * The scanner is resumable: if the input runs out in the middle of a
+     * statement, the next call to scan() carries on from where the last
+     * one stopped, so the caller only needs to pass new data.
+     *
+     * The scanner only understands the default syntax, where options are
+     * terminated with ';'.  It doesn't validate anything; on invalid input
+     * it will still return some split, and the real parser will report
+     * the error.
+     */
+    class statement_scanner {
+      public:
+        /*
+         * Scan forward from first.  If the end of a top-level statement is
+         * found, return the position just after its terminator; otherwise
+         * consume all the input and return nothing.
+         */
+        template <typename Iterator>
+        auto scan(Iterator first, Iterator last) -> std::optional<Iterator> {
+            while (first != last) {
+                char c = *first++;
+                if (step(c))
+                    return first;
+            }
+
+            return {};
+        }
+
+        // True if the scanner is not in the middle of a statement.
+        auto at_boundary() const -> bool {
+            return state == st_normal && depth == 0 && !in_statement;
+        }
+
+        void reset() {
+            *this = statement_scanner();
+        }
+
+      private:
+        enum scan_state {
+            st_normal,
+            st_line_comment,
+            st_block_comment,
+            st_quoted,
+            st_heredoc_header,
+            st_heredoc_body,
+        };
+
+        scan_state state = st_normal;
+
+        // Brace nesting depth.
+        std::size_t depth = 0;
+
+        // Whether we've seen anything other than whitespace and comments
+        // since the last statement ended.
+        bool in_statement = false;
+
+        // The previous character was '/' (st_normal) or '*'
+        // (st_block_comment).
+        bool pending = false;
+
+        // Number of consecutive '<' seen, to detect "<<<".
+        int angles = 0;
+
+        // The opening quote character, and whether it was followed by '\'.
+        char quote = 0;
+        bool escape = false;
+
+        // The heredoc terminator, and how much of it we've matched at the
+        // start of the current line; -1 if we're not at the start of a line.
+        std::string token;
+        std::ptrdiff_t matched = -1;
+
+        static auto is_eol(char c) -> bool {
+            return c == '\n' || c == '\r';
+        }
+
+        static auto is_token_char(char c) -> bool {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                   (c >= '0' && c <= '9') || c == '-' || c == '_';
+        }
+
+        // Process one character; return true if it ended a statement.
+        auto step(char c) -> bool {
+            switch (state) {
+            case st_line_comment:
+                if (is_eol(c))
+                    state = st_normal;
+                return false;
+
+            case st_block_comment:
+                if (pending && c == '/') {
+                    state = st_normal;
+                    pending = false;
+                } else
+                    pending = (c == '*');
+                return false;
+
+            case st_quoted:
+                if (escape)
+                    escape = false;
+                else if (c == '\\')
+                    escape = true;
+                else if (c == quote)
+                    state = st_normal;
+                return false;
+
+            case st_heredoc_header:
+                if (is_token_char(c)) {
+                    token += c;
+                    return false;
+                }
+
+                if (is_eol(c) && !token.empty()) {
+                    state = st_heredoc_body;
+                    matched = -1;
+                    return false;
+                }
+
+                // Not a valid heredoc; let the parser complain about it.
+                state = st_normal;
+                return step(c);
+
+            case st_heredoc_body:
+                if (is_eol(c))
+                    matched = 0;
+                else if (matched >= 0 &&
+                         c == token[static_cast<std::size_t>(matched)]) {
+                    if (static_cast<std::size_t>(++matched) == token.size())
+                        state = st_normal;
+                } else
+                    matched = -1;
+                return false;
+
+            case st_normal:
+                break;
+            }
+
+            if (pending) {
+                pending = false;
+                if (c == '*') {
+                    state = st_block_comment;
+                    return false;
+                }
+                // The '/' was part of the statement.
+                in_statement = true;
+            }
+
+            if (c == '<') {
+                in_statement = true;
+                if (++angles == 3) {
+                    angles = 0;
+                    token.clear();
+                    state = st_heredoc_header;
+                }
+                return false;
+            }
+            angles = 0;
+
+            switch (c) {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+            case '\v':
+            case '\f':
+                return false;
+
+            case '#':
+                state = st_line_comment;
+                return false;
+
+            case '/':
+                pending = true;
+                return false;
+
+            case '\'':
+            case '"':
+                in_statement = true;
+                quote = c;
+                escape = false;
+                state = st_quoted;
+                return false;
+
+            case '{':
+                in_statement = true;
+                ++depth;
+                return false;
+
+            case '}':
+                in_statement = true;
+                if (depth > 0)
+                    --depth;
+                return false;
+
+            case ';':
+                if (depth == 0) {
+                    in_statement = false;
+                    return true;
+                }
+                return false;
+
+            default:
+                in_statement = true;
+                return false;
+            }
+        }
+    };
+
+} // namespace sk::config::detail
+
+#endif // SK_CONFIG_DETAIL_STATEMENT_SCANNER_HXX_INCLUDED
@@ -0,0 +1,497 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_FROZEN_MAP_HXX_INCLUDED
+#define SK_CONFIG_FROZEN_MAP_HXX_INCLUDED
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace sk::config {
+
+    /*
+     * frozen_hash<Key>: the default hash for frozen_map.  Keys which
+     * convert to std::string_view are hashed as a string_view, so a map
+     * with std::string keys can be searched with a string_view or a
+     * char const * without building a std::string.
+     */
+    template <typename Key> struct frozen_hash {
+        auto operator()(Key const &key) const -> std::size_t {
+            return std::hash<Key>()(key);
+        }
+    };
+
+    template <typename Key>
+        requires std::convertible_to<Key const &, std::string_view>
+    struct frozen_hash<Key> {
+        using is_transparent = void;
+
+        auto operator()(std::string_view key) const noexcept -> std::size_t {
+            return std::hash<std::string_view>()(key);
+        }
+    };
+
+    namespace detail {
+
+        // Scramble the bits of a hash, since std::hash of an integer is
+        // usually the integer itself.  This is the splitmix64 finaliser.
+        inline auto frozen_mix(std::uint64_t h) noexcept -> std::uint64_t {
+            h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+            return h ^ (h >> 31);
+        }
+
+        // Map a hash onto [0, n) without a division.
+        inline auto frozen_reduce(std::uint64_t h, std::size_t n) noexcept
+            -> std::size_t {
+#if defined(__SIZEOF_INT128__)
+            return static_cast<std::size_t>(
+                (static_cast<unsigned __int128>(h) * n) >> 64);
+#else
+            return static_cast<std::size_t>(h % n);
+#endif
+        }
+
+    } // namespace detail
+
+    /*
+     * frozen_map<Key, Value>: a map for configuration data which is
+     * searched often but only changes when the configuration is parsed.
+     *
+     * The entries are kept in a single array, and once the map is frozen
+     * a minimal perfect hash gives the position of each key in the array.
+     * A lookup hashes the key, reads one small displacement value, and
+     * compares the key with exactly one entry; there is no probing and no
+     * chain to follow.
+     *
+     * Entries added after the map was frozen are held in a separate index
+     * until the next call to freeze(), so the map can always be searched,
+     * but is only fast once it's frozen.  The parser freezes the map at
+     * the end of the block or configuration which contains it.
+     *
+     * Iteration order is unspecified and changes when the map is frozen.
+     * Keys must not be modified through an iterator.
+     */
+    template <typename Key, typename Value, typename Hash = frozen_hash<Key>,
+              typename KeyEqual = std::equal_to<>>
+    class frozen_map {
+      public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+        using size_type = std::size_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        frozen_map() = default;
+
+        frozen_map(std::initializer_list<value_type> init) {
+            for (auto &&v : init)
+                emplace(v.first, v.second);
+            freeze();
+        }
+
+        auto begin() noexcept -> iterator {
+            return entries.begin();
+        }
+
+        auto end() noexcept -> iterator {
+            return entries.end();
+        }
+
+        auto begin() const noexcept -> const_iterator {
+            return entries.begin();
+        }
+
+        auto end() const noexcept -> const_iterator {
+            return entries.end();
+        }
+
+        auto size() const noexcept -> size_type {
+            return entries.size();
+        }
+
+        auto empty() const noexcept -> bool {
+            return entries.empty();
+        }
+
+        // Returns true if every entry is in the perfect hash.  This is
+        // false after freeze() if two keys have the same Hash value.
+        auto frozen() const noexcept -> bool {
+            return pending.empty();
+        }
+
+        auto find(Key const &key) -> iterator {
+            return entries.begin() + index_of(key);
+        }
+
+        auto find(Key const &key) const -> const_iterator {
+            return entries.begin() + index_of(key);
+        }
+
+        template <typename K>
+            requires requires { typename Hash::is_transparent; }
+        auto find(K const &key) -> iterator {
+            return entries.begin() + index_of(key);
+        }
+
+        template <typename K>
+            requires requires { typename Hash::is_transparent; }
+        auto find(K const &key) const -> const_iterator {
+            return entries.begin() + index_of(key);
+        }
+
+        auto contains(Key const &key) const -> bool {
+            return index_of(key) != entries.size();
+        }
+
+        template <typename K>
+            requires requires { typename Hash::is_transparent; }
+        auto contains(K const &key) const -> bool {
+            return index_of(key) != entries.size();
+        }
+
+        auto count(Key const &key) const -> size_type {
+            return contains(key) ? 1 : 0;
+        }
+
+        auto at(Key const &key) -> Value & {
+            return entry_at(index_of(key)).second;
+        }
+
+        auto at(Key const &key) const -> Value const & {
+            return entry_at(index_of(key)).second;
+        }
+
+        template <typename K>
+            requires requires { typename Hash::is_transparent; }
+        auto at(K const &key) -> Value & {
+            return entry_at(index_of(key)).second;
+        }
+
+        template <typename K>
+            requires requires { typename Hash::is_transparent; }
+        auto at(K const &key) const -> Value const & {
+            return entry_at(index_of(key)).second;
+        }
+
+        /*
+         * Add an entry, unless the key is already present.  The new entry
+         * can be found straight away, but lookups are slower until the
+         * map is frozen again.
+         */
+        template <typename K, typename V>
+        auto emplace(K &&key, V &&value) -> std::pair<iterator, bool> {
+            Key k(std::forward<K>(key));
+
+            if (auto i = index_of(k); i != entries.size())
+                return {entries.begin() + i, false};
+
+            auto h = hash_of(k, seed);
+            entries.emplace_back(std::move(k), std::forward<V>(value));
+            pending.emplace(h, entries.size() - 1);
+            return {entries.end() - 1, true};
+        }
+
+        void clear() noexcept {
+            entries.clear();
+            pilots.clear();
+            remap.clear();
+            pending.clear();
+            nfrozen = 0;
+            nslots = 0;
+            nshared = 0;
+        }
+
+        /*
+         * Build the perfect hash for every entry.  This takes time linear
+         * in the size of the map (and a little more for very large maps),
+         * and does nothing if no entries were added since the last call.
+         *
+         * Two distinct keys with the same Hash value can't be told apart
+         * by any perfect hash, so all but the first of them stay in the
+         * slower index for entries added since the map was frozen.
+         */
+        void freeze() {
+            if (pending.size() == nshared)
+                return;
+
+            // Put the entries with a unique hash first.
+            std::vector<value_type> unique;
+            std::vector<value_type> shared;
+            {
+                std::unordered_set<std::uint64_t> seen;
+                seen.reserve(entries.size());
+                for (auto &&entry : entries) {
+                    if (seen.insert(hash(entry.first)).second)
+                        unique.push_back(std::move(entry));
+                    else
+                        shared.push_back(std::move(entry));
+                }
+            }
+
+            auto n = unique.size();
+            std::vector<std::size_t> slots(n);
+
+            // A seed fails only if some bucket can't be placed within the
+            // pilot limit, which is very unlikely.  If every seed fails,
+            // leave all the entries in the slower index.
+            auto s = seed;
+            bool built = false;
+            for (int tries = 0; tries < 16 && !built; ++tries) {
+                s = detail::frozen_mix(s + 0x9e3779b97f4a7c15ULL);
+                built = build(s, unique, slots);
+            }
+
+            entries.clear();
+            entries.reserve(n + shared.size());
+
+            if (built) {
+                // Move each entry to its slot.
+                std::vector<std::size_t> from(n);
+                for (std::size_t i = 0; i < n; ++i)
+                    from[slots[i]] = i;
+
+                for (auto i : from)
+                    entries.push_back(std::move(unique[i]));
+
+                seed = s;
+                nfrozen = n;
+                nslots = nfrozen + nfrozen / extra_slots + 1;
+            } else {
+                for (auto &&entry : unique)
+                    entries.push_back(std::move(entry));
+
+                pilots.clear();
+                remap.clear();
+                nfrozen = 0;
+                nslots = 0;
+            }
+
+            for (auto &&entry : shared)
+                entries.push_back(std::move(entry));
+
+            pending.clear();
+            for (auto i = nfrozen; i < entries.size(); ++i)
+                pending.emplace(hash_of(entries[i].first, seed), i);
+            nshared = pending.size();
+        }
+
+      private:
+        // Average number of keys per bucket.  A larger value makes the
+        // index smaller but takes longer to build.
+        static constexpr std::size_t bucket_size = 3;
+
+        // The hash has a few more slots than keys: placing the last keys
+        // of a minimal perfect hash takes about n attempts each.
+        static constexpr std::size_t extra_slots = 16;
+
+        std::vector<value_type> entries;
+
+        // The perfect hash covers entries [0, nfrozen).  It has one pilot
+        // value for each bucket of keys, and maps each key onto one of
+        // nslots slots; remap gives the entry for slots past nfrozen.
+        std::vector<std::uint32_t> pilots;
+        std::vector<std::size_t> remap;
+        std::size_t nfrozen = 0;
+        std::size_t nslots = 0;
+        std::uint64_t seed = 0;
+
+        // Entries which aren't in the perfect hash, by hash: those added
+        // since the map was last frozen, and the last nshared entries,
+        // whose hash is the same as another key's.
+        std::unordered_multimap<std::uint64_t, std::size_t> pending;
+        std::size_t nshared = 0;
+
+        [[no_unique_address]] Hash hash;
+        [[no_unique_address]] KeyEqual equal;
+
+        template <typename K>
+        auto hash_of(K const &key, std::uint64_t s) const -> std::uint64_t {
+            return detail::frozen_mix(
+                static_cast<std::uint64_t>(hash(key)) ^ s);
+        }
+
+        static auto slot_of(std::uint64_t h, std::uint64_t pilot,
+                            std::size_t n) noexcept -> std::size_t {
+            return detail::frozen_reduce(
+                detail::frozen_mix(h ^ (pilot * 0x9e3779b97f4a7c15ULL)), n);
+        }
+
+        // Returns size() if the key isn't present.
+        template <typename K>
+        auto index_of(K const &key) const -> std::size_t {
+            auto h = hash_of(key, seed);
+
+            if (nfrozen != 0) {
+                auto b = detail::frozen_reduce(h, pilots.size());
+                auto i = slot_of(h, pilots[b], nslots);
+                if (i >= nfrozen) [[unlikely]]
+                    i = remap[i - nfrozen];
+                if (equal(entries[i].first, key))
+                    return i;
+            }
+
+            if (!pending.empty()) [[unlikely]] {
+                auto [first, last] = pending.equal_range(h);
+                for (; first != last; ++first)
+                    if (equal(entries[first->second].first, key))
+                        return first->second;
+            }
+
+            return entries.size();
+        }
+
+        auto entry_at(std::size_t i) -> value_type & {
+            if (i == entries.size())
+                throw std::out_of_range("sk::config::frozen_map::at");
+            return entries[i];
+        }
+
+        auto entry_at(std::size_t i) const -> value_type const & {
+            if (i == entries.size())
+                throw std::out_of_range("sk::config::frozen_map::at");
+            return entries[i];
+        }
+
+        /*
+         * Try to build the perfect hash with the given seed, storing the
+         * final position of each entry in slots.  This is the "hash and
+         * displace" method: the keys are divided into small buckets, and
+         * starting with the largest bucket, each bucket is given the first
+         * pilot value which puts all its keys into free slots.  Keys which
+         * land in the extra slots past the end are then moved into the
+         * slots that were left free.  The keys' hashes must be distinct.
+         */
+        auto build(std::uint64_t s, std::vector<value_type> const &keyed,
+                   std::vector<std::size_t> &slots) -> bool {
+            auto n = keyed.size();
+            auto m = n + n / extra_slots + 1;
+            auto nbuckets = n / bucket_size + 1;
+
+            std::vector<std::uint64_t> hashes(n);
+            for (std::size_t i = 0; i < n; ++i)
+                hashes[i] = hash_of(keyed[i].first, s);
+
+            // Sort the keys by bucket.
+            std::vector<std::size_t> start(nbuckets + 1);
+            for (auto h : hashes)
+                ++start[detail::frozen_reduce(h, nbuckets) + 1];
+            std::partial_sum(start.begin(), start.end(), start.begin());
+
+            // The entry and hash of each key, in bucket order.
+            std::vector<std::size_t> keys(n);
+            std::vector<std::uint64_t> key_hashes(n);
+            {
+                auto next = start;
+                for (std::size_t i = 0; i < n; ++i) {
+                    auto j = next[detail::frozen_reduce(hashes[i], nbuckets)]++;
+                    keys[j] = i;
+                    key_hashes[j] = hashes[i];
+                }
+            }
+
+            std::vector<std::size_t> order(nbuckets);
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            std::ranges::stable_sort(order, std::greater<>(), [&](auto b) {
+                return start[b + 1] - start[b];
+            });
+
+            std::uint64_t const max_pilot = 1 << 20;
+            std::vector<std::uint32_t> new_pilots(nbuckets);
+            std::vector<bool> taken(m);
+
+            for (auto b : order) {
+                auto first = start[b];
+                auto last = start[b + 1];
+                if (first == last)
+                    break;
+
+                std::uint64_t pilot = 0;
+                for (;; ++pilot) {
+                    if (pilot == max_pilot)
+                        return false;
+
+                    // Claim a slot for each key, and give them all back if
+                    // one of them is taken.
+                    auto i = first;
+                    for (; i != last; ++i) {
+                        auto slot = slot_of(key_hashes[i], pilot, m);
+                        if (taken[slot])
+                            break;
+                        taken[slot] = true;
+                        slots[keys[i]] = slot;
+                    }
+
+                    if (i == last)
+                        break;
+
+                    for (auto j = first; j != i; ++j)
+                        taken[slots[keys[j]]] = false;
+                }
+
+                new_pilots[b] = static_cast<std::uint32_t>(pilot);
+            }
+
+            // There are as many free slots before n as used slots after.
+            std::vector<std::size_t> new_remap(m - n);
+            std::size_t free_slot = 0;
+            for (auto slot = n; slot < m; ++slot) {
+                if (!taken[slot])
+                    continue;
+                while (taken[free_slot])
+                    ++free_slot;
+                new_remap[slot - n] = free_slot++;
+            }
+
+            for (auto &&slot : slots)
+                if (slot >= n)
+                    slot = new_remap[slot - n];
+
+            pilots = std::move(new_pilots);
+            remap = std::move(new_remap);
+            return true;
+        }
+    };
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_FROZEN_MAP_HXX_INCLUDED
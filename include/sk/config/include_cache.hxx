@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_INCLUDE_CACHE_HXX_INCLUDED
+#define SK_CONFIG_INCLUDE_CACHE_HXX_INCLUDED
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace sk::config {
+
+    struct include_cache_tag {};
+
+    /*
+     * include_cache: parsed include files, keyed by the file's path,
+     * modification time and size.  A file which is included several times
+     * is only read and parsed once, as long as it doesn't change.
+     *
+     * Each parse() uses its own cache.  To keep included files across
+     * parses, for example when reloading a configuration, provide a cache
+     * in the context:
+     *
+     *   cfg::include_cache cache;
+     *   cfg::parse_file<my_policy>(
+     *       path, x3::with<cfg::include_cache_tag>(std::ref(cache))[grammar],
+     *       ret);
+     *
+     * A cache should only be used with one grammar for each configuration
+     * type.  include_cache is thread-safe.
+     */
+    class include_cache {
+      public:
+        include_cache() = default;
+        include_cache(include_cache const &) = delete;
+        include_cache &operator=(include_cache const &) = delete;
+
+        // Remove all cached files.
+        void clear() {
+            std::lock_guard lock(mutex);
+            entries.clear();
+            expansions.clear();
+        }
+
+        // The number of cached files.
+        auto size() const -> std::size_t {
+            std::lock_guard lock(mutex);
+            return entries.size();
+        }
+
+        // The paths of all cached files.
+        auto files() const -> std::vector<std::filesystem::path> {
+            std::lock_guard lock(mutex);
+
+            std::vector<std::filesystem::path> paths;
+            for (auto &&[key, value] : entries)
+                if (paths.empty() || paths.back() != key.first)
+                    paths.push_back(key.first);
+            return paths;
+        }
+
+        /*
+         * Record the files matched by an include pattern which contains
+         * wildcards.  The matches should be sorted.
+         */
+        void record_glob(std::filesystem::path const &pattern,
+                         std::vector<std::filesystem::path> matches) {
+            std::lock_guard lock(mutex);
+            expansions.insert_or_assign(pattern, std::move(matches));
+        }
+
+        // Every recorded include pattern, and the files it matched.
+        auto globs() const
+            -> std::vector<std::pair<std::filesystem::path,
+                                     std::vector<std::filesystem::path>>> {
+            std::lock_guard lock(mutex);
+            return {expansions.begin(), expansions.end()};
+        }
+
+        /*
+         * Return the cached Fragment for path, or nullptr if the file isn't
+         * cached or has changed since it was cached.
+         */
+        template <typename Fragment>
+        auto find(std::filesystem::path const &path,
+                  std::filesystem::file_time_type mtime,
+                  std::uintmax_t size) const
+            -> std::shared_ptr<Fragment const> {
+            std::lock_guard lock(mutex);
+
+            auto it = entries.find({path, typeid(Fragment)});
+            if (it == entries.end() || it->second.mtime != mtime ||
+                it->second.size != size)
+                return nullptr;
+
+            return std::static_pointer_cast<Fragment const>(
+                it->second.fragment);
+        }
+
+        // Add a Fragment to the cache, replacing any existing entry.
+        template <typename Fragment>
+        void insert(std::filesystem::path const &path,
+                    std::filesystem::file_time_type mtime, std::uintmax_t size,
+                    std::shared_ptr<Fragment const> fragment) {
+            std::lock_guard lock(mutex);
+            entries.insert_or_assign(key_type{path, typeid(Fragment)},
+                                     entry{mtime, size, std::move(fragment)});
+        }
+
+      private:
+        using key_type = std::pair<std::filesystem::path, std::type_index>;
+
+        struct entry {
+            std::filesystem::file_time_type mtime;
+            std::uintmax_t size;
+            std::shared_ptr<void const> fragment;
+        };
+
+        mutable std::mutex mutex;
+        std::map<key_type, entry> entries;
+        std::map<std::filesystem::path, std::vector<std::filesystem::path>>
+            expansions;
+    };
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_INCLUDE_CACHE_HXX_INCLUDED
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_INCREMENTAL_PARSER_HXX_INCLUDED
+#define SK_CONFIG_INCREMENTAL_PARSER_HXX_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string>
+#include <utility>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/freeze.hxx>
+#include <sk/config/detail/parser/intern_scope.hxx>
+#include <sk/config/detail/statement_scanner.hxx>
+#include <sk/config/error.hxx>
+#include <sk/config/parse.hxx>
+#include <sk/config/parser_policy.hxx>
+
+namespace sk::config {
+
+    /*
+     * incremental_parser: parse a configuration which arrives in pieces,
+     * for example from a pipe or a socket.
+     *
+     * Input is passed to feed() as it arrives, and finish() is called at
+     * the end of the input.  Each top-level statement is parsed into ret
+     * as soon as it's complete, and then discarded, so the parser only
+     * needs to buffer the statement currently being received.  Members
+     * which are frozen once they've been parsed, such as frozen_map, are
+     * frozen by finish() rather than after each statement, and named
+     * blocks in a flat map are inserted by finish() as one sorted range.
+     * Strings are interned in one table for the whole input.
+     *
+     * The grammar should be a config<T>() grammar.  Errors are reported
+     * by throwing parse_error, as for parse(), with line numbers relative
+     * to the whole input.  After an error, the parser can't be used again.
+     *
+     * Statements are split at top-level ';' characters, so the parser
+     * policy must use the default option terminator.
+     */
+    template <typename Grammar, typename T, typename Policy = parser_policy>
+    class incremental_parser {
+      public:
+        incremental_parser(Grammar const &grammar_, T &ret_,
+                           std::string filename_ = "")
+            : grammar(grammar_), ret(ret_), filename(std::move(filename_)),
+              pending(ret_) {}
+
+        /*
+         * Add more input.  Any statements which are now complete are
+         * parsed immediately.
+         */
+        void feed(std::span<char const> data) {
+            if (finished)
+                throw error("incremental_parser: feed() after finish()");
+
+            buffer.append(data.data(), data.size());
+
+            auto const *base = buffer.data();
+            auto const *last = base + buffer.size();
+
+            while (auto end = scanner.scan(base + scan_pos, last)) {
+                auto stmt_end = static_cast<std::size_t>(*end - base);
+                parse_statement(base, base + stmt_pos, *end);
+                scan_pos = stmt_pos = stmt_end;
+            }
+
+            scan_pos = buffer.size();
+            discard_parsed();
+        }
+
+        /*
+         * Signal the end of the input and parse anything which is left in
+         * the buffer.  An incomplete statement is reported as an error.
+         */
+        void finish() {
+            if (finished)
+                return;
+            finished = true;
+
+            auto const *base = buffer.data();
+            parse_statement(base, base + stmt_pos, base + buffer.size());
+            pending.freeze();
+
+            buffer.clear();
+            buffer.shrink_to_fit();
+            scan_pos = stmt_pos = 0;
+        }
+
+        // The number of bytes currently buffered.
+        auto buffered() const -> std::size_t {
+            return buffer.size();
+        }
+
+      private:
+        /*
+         * When a statement starts in the middle of a line, we keep up to
+         * this much of the line before it so errors can show the whole
+         * line.
+         */
+        static constexpr std::size_t max_context = 256;
+
+        Grammar grammar;
+        T &ret;
+        std::string filename;
+        detail::statement_scanner scanner;
+        bool finished = false;
+
+        // The members of ret to be frozen by finish().
+        detail::freeze_list pending;
+
+        // The table for strings in every statement.
+        shared_intern_table strings;
+
+        // Unparsed input, preceded by the start of the line it starts on.
+        std::string buffer;
+
+        // The line number of buffer[0].
+        std::size_t first_line = 1;
+
+        // The start of the current statement in the buffer.
+        std::size_t stmt_pos = 0;
+
+        // Where the scanner got to in the buffer.
+        std::size_t scan_pos = 0;
+
+        // Parse [first, last) into ret.  base is the start of the buffer.
+        void parse_statement(char const *base, char const *first,
+                             char const *last) {
+            namespace x3 = boost::spirit::x3;
+
+            auto const grammar_ =
+                x3::with<intern_table_tag>(std::ref(*strings))
+                    [x3::with<detail::pending_freeze_tag>(std::ref(pending))
+                         [grammar]];
+            detail::parse_at<Policy>(base, first, last, grammar_, ret,
+                                     filename, first_line);
+        }
+
+        // Remove everything which has been parsed, except for the start of
+        // the current line.
+        void discard_parsed() {
+            std::size_t cut = stmt_pos;
+            while (cut > 0 && buffer[cut - 1] != '\n' &&
+                   buffer[cut - 1] != '\r')
+                --cut;
+
+            if (stmt_pos - cut > max_context)
+                cut = stmt_pos - max_context;
+
+            if (cut == 0)
+                return;
+
+            // Count the lines we're discarding, the same way that
+            // error_formatter does.
+            char prev = 0;
+            for (std::size_t i = 0; i < cut; ++i) {
+                char c = buffer[i];
+                if (c == '\r' || (c == '\n' && prev != '\r'))
+                    ++first_line;
+                prev = c;
+            }
+
+            buffer.erase(0, cut);
+            stmt_pos -= cut;
+            scan_pos -= cut;
+        }
+    };
+
+    template <typename Grammar, typename T>
+    incremental_parser(Grammar const &, T &)
+        -> incremental_parser<Grammar, T>;
+
+    template <typename Grammar, typename T>
+    incremental_parser(Grammar const &, T &, std::string)
+        -> incremental_parser<Grammar, T>;
+
+    /*
+     * Create an incremental_parser with a non-default parser policy.
+     */
+    template <typename Policy = parser_policy, typename Grammar, typename T>
+    auto make_incremental_parser(Grammar const &grammar, T &ret,
+                                 std::string filename = "") {
+        return incremental_parser<Grammar, T, Policy>(grammar, ret,
+                                                      std::move(filename));
+    }
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_INCREMENTAL_PARSER_HXX_INCLUDED
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_INTERNED_STRING_HXX_INCLUDED
+#define SK_CONFIG_INTERNED_STRING_HXX_INCLUDED
+
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace sk::config {
+
+    class intern_table;
+
+    namespace detail {
+
+        // One distinct string in an intern_table.
+        struct intern_entry {
+            std::string text;
+            std::size_t hash = 0;
+            intern_table const *owner = nullptr;
+        };
+
+        // Every table returns this entry for the empty string.
+        inline intern_entry const empty_intern_entry{};
+
+        // Count a reference to a table from shared_intern_table.
+        void retain(intern_entry const *entry) noexcept;
+        void release(intern_entry const *entry) noexcept;
+
+    } // namespace detail
+
+    /*
+     * interned_string: an immutable string which is stored once in an
+     * intern_table, however many times it occurs.  An interned_string is
+     * the size of a pointer, and copying, hashing and comparing two
+     * strings from the same table for equality don't look at the text.
+     *
+     * Strings from different tables are compared by their text, so they
+     * still compare equal if the text is equal.  Ordering always compares
+     * the text, so a std::set<interned_string> is in the same order as a
+     * std::set<std::string>.
+     *
+     * A table created by shared_intern_table is kept alive by the strings
+     * which refer to it; any other intern_table must outlive them.
+     */
+    class interned_string {
+      public:
+        interned_string() = default;
+
+        interned_string(interned_string const &other) noexcept
+            : entry(other.entry) {
+            detail::retain(entry);
+        }
+
+        interned_string(interned_string &&other) noexcept
+            : entry(std::exchange(other.entry, &detail::empty_intern_entry)) {
+        }
+
+        auto operator=(interned_string other) noexcept -> interned_string & {
+            std::swap(entry, other.entry);
+            return *this;
+        }
+
+        ~interned_string() {
+            detail::release(entry);
+        }
+
+        auto str() const -> std::string const & {
+            return entry->text;
+        }
+
+        auto view() const -> std::string_view {
+            return entry->text;
+        }
+
+        operator std::string_view() const {
+            return entry->text;
+        }
+
+        auto c_str() const -> char const * {
+            return entry->text.c_str();
+        }
+
+        auto size() const -> std::size_t {
+            return entry->text.size();
+        }
+
+        auto empty() const -> bool {
+            return entry->text.empty();
+        }
+
+        auto hash() const -> std::size_t {
+            return entry->hash;
+        }
+
+        friend auto operator==(interned_string const &a,
+                               interned_string const &b) -> bool {
+            if (a.entry == b.entry)
+                return true;
+
+            // Each table stores a string only once.
+            if (a.entry->owner == b.entry->owner)
+                return false;
+
+            return a.entry->text == b.entry->text;
+        }
+
+        friend auto operator<=>(interned_string const &a,
+                                interned_string const &b)
+            -> std::strong_ordering {
+            if (a.entry == b.entry)
+                return std::strong_ordering::equal;
+            return a.view() <=> b.view();
+        }
+
+        friend auto operator==(interned_string const &a, std::string_view b)
+            -> bool {
+            return a.view() == b;
+        }
+
+        friend auto operator<=>(interned_string const &a, std::string_view b)
+            -> std::strong_ordering {
+            return a.view() <=> b;
+        }
+
+        friend auto operator<<(std::ostream &strm, interned_string const &s)
+            -> std::ostream & {
+            return strm << s.view();
+        }
+
+      private:
+        friend class intern_table;
+
+        explicit interned_string(detail::intern_entry const *entry_)
+            : entry(entry_) {
+            detail::retain(entry);
+        }
+
+        detail::intern_entry const *entry = &detail::empty_intern_entry;
+    };
+
+    /*
+     * intern_table: the storage for interned strings.  intern() can be
+     * called from several threads at once.
+     *
+     * By default, each parse interns strings in a shared_intern_table of
+     * its own, which is freed with the last string parsed into it.  To
+     * share one table between parses, parse with a table of your own
+     * using with_intern_table().
+     */
+    class intern_table {
+      public:
+        intern_table() = default;
+        intern_table(intern_table const &) = delete;
+        auto operator=(intern_table const &) -> intern_table & = delete;
+
+        // Return the interned copy of s, adding it if necessary.
+        auto intern(std::string_view s) -> interned_string {
+            if (s.empty())
+                return interned_string();
+
+            std::lock_guard lock(mutex);
+
+            if (auto it = index.find(s); it != index.end())
+                return interned_string(it->second);
+
+            auto &entry = entries.emplace_back();
+            entry.text = s;
+            entry.hash = std::hash<std::string_view>()(s);
+            entry.owner = this;
+            index.emplace(entry.text, &entry);
+            return interned_string(&entry);
+        }
+
+        // The number of distinct strings in the table.
+        auto size() const -> std::size_t {
+            std::lock_guard lock(mutex);
+            return entries.size();
+        }
+
+        // A table which is never freed.
+        static auto global() -> intern_table & {
+            // Never destroyed, so strings can be used during shutdown.
+            static auto *table = new intern_table;
+            return *table;
+        }
+
+      private:
+        friend class shared_intern_table;
+        friend void detail::retain(detail::intern_entry const *) noexcept;
+        friend void detail::release(detail::intern_entry const *) noexcept;
+
+        // For a table created by shared_intern_table, the number of
+        // references to it, including one for each interned_string.
+        mutable std::atomic<std::size_t> refs{0};
+        bool counted = false;
+
+        mutable std::mutex mutex;
+        // A deque, because its elements never move.
+        std::deque<detail::intern_entry> entries;
+        std::unordered_map<std::string_view, detail::intern_entry const *>
+            index;
+    };
+
+    /*
+     * shared_intern_table: a new intern_table, which is freed when the
+     * last shared_intern_table and the last interned_string which refer
+     * to it are destroyed.
+     */
+    class shared_intern_table {
+      public:
+        shared_intern_table() : table(new intern_table) {
+            table->counted = true;
+            table->refs.store(1, std::memory_order_relaxed);
+        }
+
+        shared_intern_table(shared_intern_table const &other) noexcept
+            : table(other.table) {
+            table->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto operator=(shared_intern_table other) noexcept
+            -> shared_intern_table & {
+            std::swap(table, other.table);
+            return *this;
+        }
+
+        ~shared_intern_table() {
+            if (table->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete table;
+        }
+
+        auto operator*() const noexcept -> intern_table & {
+            return *table;
+        }
+
+        auto operator->() const noexcept -> intern_table * {
+            return table;
+        }
+
+        auto intern(std::string_view s) const -> interned_string {
+            return table->intern(s);
+        }
+
+      private:
+        intern_table *table;
+    };
+
+    namespace detail {
+
+        inline void retain(intern_entry const *entry) noexcept {
+            auto const *table = entry->owner;
+            if (table && table->counted)
+                table->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline void release(intern_entry const *entry) noexcept {
+            auto const *table = entry->owner;
+            if (table && table->counted &&
+                table->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete table;
+        }
+
+    } // namespace detail
+
+} // namespace sk::config
+
+template <> struct std::hash<sk::config::interned_string> {
+    auto operator()(sk::config::interned_string const &s) const noexcept
+        -> std::size_t {
+        return s.hash();
+    }
+};
+
+#endif // SK_CONFIG_INTERNED_STRING_HXX_INCLUDED
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_LIVE_HXX_INCLUDED
+#define SK_CONFIG_LIVE_HXX_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/file_watcher.hxx>
+#include <sk/config/detail/parser/include.hxx>
+#include <sk/config/error.hxx>
+#include <sk/config/include_cache.hxx>
+#include <sk/config/parse.hxx>
+#include <sk/config/parser_policy.hxx>
+
+namespace sk::config {
+
+    struct live_options {
+        // Called on the reloading thread when a reload fails.
+        std::function<void(parse_error const &)> on_error;
+
+        // Called on the reloading thread when a new snapshot is published.
+        std::function<void()> on_reload;
+
+        /*
+         * How often to check the files for changes.  On Linux, changes are
+         * normally noticed immediately and this is only a fallback.
+         */
+        std::chrono::milliseconds poll_interval{1000};
+
+        // How long to wait for writes to finish after a change is seen.
+        std::chrono::milliseconds settle_time{50};
+    };
+
+    struct live_metrics {
+        // The number of snapshots published, including the first one.
+        std::uint64_t generation = 0;
+
+        // The number of reloads which failed.
+        std::uint64_t failures = 0;
+
+        // How long reloads took, including failed reloads.
+        std::chrono::nanoseconds last_reload_time{0};
+        std::chrono::nanoseconds max_reload_time{0};
+        std::chrono::nanoseconds total_reload_time{0};
+    };
+
+    /*
+     * live<T>: a configuration file which is reloaded when it changes.
+     *
+     * The file (and any files it includes) is watched by a background
+     * thread, which parses the new configuration and publishes it as an
+     * immutable snapshot.  Readers call get() to obtain the current
+     * snapshot; this never takes a lock and never waits for a reload.
+     *
+     * If a reload fails, the previous snapshot is kept and the error is
+     * passed to options.on_error and returned by last_error().  The first
+     * parse happens in the constructor, which throws parse_error if it
+     * fails.
+     *
+     * T must be default-constructible.
+     */
+    template <typename T, typename Policy = parser_policy> class live {
+      public:
+        template <typename Grammar>
+        live(std::filesystem::path path_, Grammar const &grammar,
+             live_options options_ = {})
+            : path(std::move(path_)), options(std::move(options_)) {
+            namespace x3 = boost::spirit::x3;
+
+            // Included files are kept in the cache between reloads, so
+            // only files which changed are parsed again.
+            parse = [this, grammar](T &ret) {
+                auto const grammar_ =
+                    x3::with<include_cache_tag>(std::ref(cache))[grammar];
+                parse_file<Policy>(path, grammar_, ret);
+            };
+
+            if (!reload())
+                throw *last_error();
+
+            thread = std::jthread([this](std::stop_token stop) { run(stop); });
+        }
+
+        ~live() {
+            thread.request_stop();
+            watcher.stop();
+        }
+
+        live(live const &) = delete;
+        live &operator=(live const &) = delete;
+
+        // Return the current snapshot.
+        auto get() const -> std::shared_ptr<T const> {
+            return snapshot.load(std::memory_order_acquire);
+        }
+
+        /*
+         * Reload the configuration now.  Returns true if a new snapshot
+         * was published.
+         */
+        auto reload() -> bool {
+            std::lock_guard reload_lock(reloading);
+
+            auto start = std::chrono::steady_clock::now();
+            auto stamps = watched_stamps();
+            std::optional<parse_error> err;
+
+            try {
+                auto next = std::make_shared<T>();
+                parse(*next);
+                snapshot.store(std::move(next), std::memory_order_release);
+            } catch (parse_error const &e) {
+                err = e;
+            } catch (std::exception const &e) {
+                err = parse_error(e.what(), {});
+            }
+
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            update_watched(std::move(stamps));
+
+            {
+                std::lock_guard lock(mutex);
+
+                stats.last_reload_time = elapsed;
+                stats.max_reload_time =
+                    std::max(stats.max_reload_time, stats.last_reload_time);
+                stats.total_reload_time += elapsed;
+
+                if (err) {
+                    ++stats.failures;
+                    error = err;
+                } else {
+                    ++stats.generation;
+                    error.reset();
+                }
+            }
+
+            if (err && options.on_error)
+                options.on_error(*err);
+            else if (!err && options.on_reload)
+                options.on_reload();
+
+            return !err;
+        }
+
+        // The error from the last reload, if it failed.
+        auto last_error() const -> std::optional<parse_error> {
+            std::lock_guard lock(mutex);
+            return error;
+        }
+
+        auto metrics() const -> live_metrics {
+            std::lock_guard lock(mutex);
+            return stats;
+        }
+
+      private:
+        std::filesystem::path path;
+        live_options options;
+        include_cache cache;
+        std::function<void(T &)> parse;
+        std::atomic<std::shared_ptr<T const>> snapshot;
+
+        // Held while reloading.
+        std::mutex reloading;
+
+        // Protects error, stats and watched.
+        mutable std::mutex mutex;
+        std::optional<parse_error> error;
+        live_metrics stats;
+        std::vector<detail::file_stamp> watched;
+
+        detail::file_watcher watcher;
+        std::jthread thread;
+
+        void run(std::stop_token stop) {
+            while (!stop.stop_requested()) {
+                bool changed = watcher.wait(options.poll_interval);
+                if (stop.stop_requested())
+                    break;
+
+                // Let the writer finish before we read the file.
+                if (changed)
+                    while (watcher.wait(options.settle_time) &&
+                           !stop.stop_requested())
+                        ;
+
+                if (changed || any_changed())
+                    reload();
+            }
+        }
+
+        // The files we depend on, and their current stamps.
+        auto watched_stamps() const -> std::vector<detail::file_stamp> {
+            std::lock_guard lock(mutex);
+
+            std::vector<detail::file_stamp> stamps;
+            for (auto &&s : watched)
+                stamps.push_back(stamp(s.path));
+            return stamps;
+        }
+
+        // The current state of a file.  A missing file gets a stamp too, so
+        // we don't keep reloading while it stays missing.
+        static auto stamp(std::filesystem::path const &file)
+            -> detail::file_stamp {
+            std::error_code ec;
+            detail::file_stamp s{file, {}, 0, {}};
+            s.mtime = std::filesystem::last_write_time(file, ec);
+            s.size = std::filesystem::file_size(file, ec);
+            return s;
+        }
+
+        /*
+         * Watch the main file and everything it includes.  stamps holds
+         * the files' state from before the reload, so a change during the
+         * reload will be noticed.
+         */
+        void update_watched(std::vector<detail::file_stamp> stamps) {
+            namespace fs = std::filesystem;
+
+            std::vector<fs::path> files{fs::absolute(path)};
+            std::error_code ec;
+            if (auto canonical = fs::canonical(path, ec); !ec)
+                files.push_back(canonical);
+
+            auto includes = cache.files();
+            files.insert(files.end(), includes.begin(), includes.end());
+
+            std::vector<detail::file_stamp> next;
+            for (auto &&file : files) {
+                auto it = std::ranges::find(stamps, file,
+                                            &detail::file_stamp::path);
+                next.push_back(it != stamps.end() ? *it : stamp(file));
+            }
+
+            watcher.watch(files);
+
+            std::lock_guard lock(mutex);
+            watched = std::move(next);
+        }
+
+        auto any_changed() const -> bool {
+            std::lock_guard lock(mutex);
+            return std::ranges::any_of(watched, [](auto const &s) {
+                auto now = stamp(s.path);
+                return now.mtime != s.mtime || now.size != s.size;
+            });
+        }
+    };
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_LIVE_HXX_INCLUDED
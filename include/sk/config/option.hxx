@@ -31,7 +31,9 @@
 
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/described.hxx>
 #include <sk/config/detail/make_member_parser.hxx>
+#include <sk/config/detail/parser/expect.hxx>
 #include <sk/config/detail/parser/option_separator.hxx>
 #include <sk/config/detail/parser/option_terminator.hxx>
 
@@ -40,30 +42,47 @@ namespace sk::config {
     template <typename T, typename V, typename Parser>
     auto option(auto label, V T::*member, Parser p) {
         namespace x3 = boost::spirit::x3;
+        using detail::parser::expect;
 
         auto rule = detail::member_rule<V>("value", p);
 
-        return x3::as_parser(label)                          //
-               > detail::parser::option_separator            //
-               > x3::expect[rule][detail::propagate(member)] //
-               > x3::no_skip[detail::parser::option_terminator];
+        auto parser =
+            x3::as_parser(label)                                        //
+            >> expect[detail::parser::option_separator]                 //
+            >> expect[expect[rule][detail::propagate(member)]]          //
+            >> expect[x3::no_skip[detail::parser::option_terminator]];
+        return detail::described(
+            parser, detail::member_entry<T, V>{member, {},
+                                               detail::label_string(label)});
     }
 
     template <typename T, typename V>
     auto option(auto label, V T::*member) {
         namespace x3 = boost::spirit::x3;
+        using detail::parser::expect;
 
         if constexpr (std::same_as<bool, V>) {
             // bool is special because it doesn't have a value.
-            auto set_bool = [=](auto &ctx) { x3::_val(ctx).*member = true; };
-            auto parser = x3::as_parser(label) //
-                          > x3::no_skip[detail::parser::option_terminator];
-            return parser[set_bool];
+            auto set_bool = [=](auto &ctx) {
+                bool value = true;
+                detail::propagate_member(ctx, member, value);
+            };
+            auto parser =
+                x3::as_parser(label) //
+                >> expect[x3::no_skip[detail::parser::option_terminator]];
+            return detail::described(
+                parser[set_bool],
+                detail::member_entry<T, V>{member, {},
+                                           detail::label_string(label)});
         } else {
-            return x3::as_parser(label)                 //
-                   > detail::parser::option_separator   //
-                   > detail::make_member_parser(member) //
-                   > x3::no_skip[detail::parser::option_terminator];
+            auto parser =
+                x3::as_parser(label)                                   //
+                >> expect[detail::parser::option_separator]            //
+                >> expect[detail::make_member_parser(member)]          //
+                >> expect[x3::no_skip[detail::parser::option_terminator]];
+            return detail::described(
+                parser, detail::member_entry<T, V>{
+                            member, {}, detail::label_string(label)});
         }
     };
 
@@ -33,8 +33,12 @@
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <memory_resource>
+#include <optional>
 #include <ranges>
+#include <sstream>
 #include <stdexcept>
+#include <system_error>
 #include <type_traits>
 #include <vector>
 
@@ -44,12 +48,48 @@
 #include <boost/spirit/include/support_istream_iterator.hpp>
 
 #include <sk/config/detail/error_formatter.hxx>
+#include <sk/config/detail/mapped_file.hxx>
+#include <sk/config/detail/memory_resource.hxx>
 #include <sk/config/detail/parser/comment.hxx>
 #include <sk/config/parser_policy.hxx>
 #include <sk/config/error.hxx>
+#include <sk/config/source_buffer.hxx>
 
 namespace sk::config {
 
+    namespace detail {
+
+        /*
+         * Parse [first, last), which is part of a larger input.  begin is the
+         * start of the line containing first, and first_line is the line
+         * number of begin in the original input; these are only used for
+         * error reporting.
+         */
+        template <typename Policy, typename Iterator>
+        auto parse_at(Iterator begin, Iterator first, Iterator last,
+                      auto const &grammar, auto &ret,
+                      std::string const &filename, std::size_t first_line) {
+            namespace x3 = boost::spirit::x3;
+
+            std::vector<error_detail> errors;
+            auto error_handler =
+                error_formatter(begin, last, std::back_inserter(errors),
+                                filename, 4, first_line);
+
+            Policy policy;
+            auto const grammar_ = x3::with<parser_policy_tag>(std::ref(
+                policy))[x3::with<x3::error_handler_tag>(
+                std::ref(error_handler))[grammar]];
+
+            bool r = x3::phrase_parse(first, last, grammar_,
+                                      parser::comment, ret);
+            if (r == false || (first != last))
+                throw parse_error("could not parse the entire input", errors);
+            return true;
+        }
+
+    } // namespace detail
+
     /*
      * Wrapper around x3::phrase_parse to handle errors.
      */
@@ -57,22 +97,8 @@ namespace sk::config {
     auto parse(Iterator first, Iterator last,
                auto const &grammar, auto &ret,
                std::string const &filename = "") {
-        namespace x3 = boost::spirit::x3;
-
-        std::vector<error_detail> errors;
-        auto error_handler = detail::error_formatter(
-            first, last, std::back_inserter(errors), filename);
-
-        Policy policy;
-        auto const grammar_ =
-            x3::with<parser_policy_tag>(std::ref(policy))[
-                x3::with<x3::error_handler_tag>(std::ref(error_handler))[grammar]];
-
-        bool r = x3::phrase_parse(first, last, grammar_,
-                                  detail::parser::comment, ret);
-        if (r == false || (first != last))
-            throw parse_error("could not parse the entire input", errors);
-        return true;
+        return detail::parse_at<Policy>(first, first, last, grammar, ret,
+                                        filename, 1);
     }
 
     template <typename Policy = parser_policy>
@@ -82,29 +108,67 @@ namespace sk::config {
                                  grammar, ret, filename);
     }
 
+    /*
+     * Parse a source_buffer.  Parsed values can refer to the buffer, so it
+     * must outlive ret.
+     */
+    template <typename Policy = parser_policy>
+    auto parse(source_buffer &buffer, auto const &grammar, auto &ret) {
+        namespace x3 = boost::spirit::x3;
+
+        auto const grammar_ =
+            x3::with<source_buffer_tag>(std::ref(buffer))[grammar];
+        return parse<Policy>(buffer.begin(), buffer.end(), grammar_, ret,
+                             buffer.name());
+    }
+
     template <typename Policy = parser_policy>
     auto parse(char const *s, auto const &grammar, auto &ret,
                std::string const &filename = "") {
         return parse<Policy>(std::string_view(s), grammar, ret, filename);
     }
 
+    /*
+     * Parse the input, allocating std::pmr strings and containers from
+     * resource.  Each one is moved to resource before a parsed value is
+     * stored in it, so the parsed configuration lives entirely in
+     * resource.
+     */
+    template <typename Policy = parser_policy, typename Iterator>
+    auto parse(Iterator first, Iterator last, auto const &grammar, auto &ret,
+               std::pmr::memory_resource *resource,
+               std::string const &filename = "") {
+        namespace x3 = boost::spirit::x3;
+
+        auto const grammar_ = x3::with<detail::memory_resource_tag>(
+            std::move(resource))[grammar];
+        return parse<Policy>(first, last, grammar_, ret, filename);
+    }
+
     template <typename Policy = parser_policy>
-    auto parse_file(std::filesystem::path filename, auto const &grammar,
-                    auto &ret) {
+    auto parse(std::ranges::range auto const &r, auto const &grammar, auto &ret,
+               std::pmr::memory_resource *resource,
+               std::string const &filename = "") {
+        return parse<Policy>(std::ranges::begin(r), std::ranges::end(r),
+                             grammar, ret, resource, filename);
+    }
 
-        std::ifstream fs;
-        fs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    template <typename Policy = parser_policy>
+    auto parse(char const *s, auto const &grammar, auto &ret,
+               std::pmr::memory_resource *resource,
+               std::string const &filename = "") {
+        return parse<Policy>(std::string_view(s), grammar, ret, resource,
+                             filename);
+    }
 
-        auto utf8name = boost::spirit::x3::to_utf8(filename.native());
+    namespace detail {
 
-        try {
-            fs.open(filename);
-            fs.unsetf(std::ios::skipws);
-            boost::spirit::istream_iterator begin(fs), end;
-            return parse<Policy>(begin, end, grammar, ret, utf8name);
-        } catch (std::ios_base::failure const &e) {
+        // Convert an I/O error into a parse_error.
+        inline auto make_file_error(std::filesystem::path const &filename,
+                                    std::system_error const &e)
+            -> parse_error {
             error_detail ed;
-            ed.file = utf8name;
+            ed.file = boost::spirit::x3::to_utf8(filename.native());
             ed.line = 0;
             ed.column = 0;
 
@@ -113,8 +177,33 @@ namespace sk::config {
             strm << filename << ": cannot read file: " << error_code.message();
             ed.message = strm.str();
 
-            throw parse_error(ed.message, std::vector<error_detail>{ed});
+            return parse_error(ed.message, std::vector<error_detail>{ed});
+        }
+
+    } // namespace detail
+
+    /*
+     * Parse a file.  The file is mapped into memory (or read into a buffer
+     * if it can't be mapped) and the grammar is run over the contents as a
+     * contiguous char range.
+     */
+    template <typename Policy = parser_policy>
+    auto parse_file(std::filesystem::path filename, auto const &grammar,
+                    auto &ret) {
+
+        auto utf8name = boost::spirit::x3::to_utf8(filename.native());
+
+        // Only errors opening this file are reported as such; a
+        // system_error from inside the parse is passed on unchanged.
+        std::optional<detail::mapped_file> file;
+        try {
+            file.emplace(filename);
+        } catch (std::system_error const &e) {
+            throw detail::make_file_error(filename, e);
         }
+
+        return parse<Policy>(file->begin(), file->end(), grammar, ret,
+                             utf8name);
     }
 } // namespace sk::config
 
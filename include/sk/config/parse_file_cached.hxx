@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_PARSE_FILE_CACHED_HXX_INCLUDED
+#define SK_CONFIG_PARSE_FILE_CACHED_HXX_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+#include <boost/spirit/home/x3/support/utility/utf8.hpp>
+
+#include <sk/config/detail/described.hxx>
+#include <sk/config/detail/glob.hxx>
+#include <sk/config/detail/mapped_file.hxx>
+#include <sk/config/detail/parser/intern_scope.hxx>
+#include <sk/config/include_cache.hxx>
+#include <sk/config/parse.hxx>
+#include <sk/config/parser_policy.hxx>
+#include <sk/config/snapshot.hxx>
+
+namespace sk::config {
+
+    namespace detail {
+
+        // Identifies a snapshot file, and its format version.
+        inline constexpr char snapshot_magic[8] = {'S', 'K', 'C', 'F',
+                                                   'G', 'S', 'N', '2'};
+
+        // The hash of a file's contents, or nothing if it can't be read.
+        inline auto hash_file(std::filesystem::path const &path)
+            -> std::optional<std::uint64_t> {
+            try {
+                mapped_file file(path);
+                return stable_hash({file.data(), file.size()});
+            } catch (std::system_error const &) {
+                return {};
+            }
+        }
+
+        // The header of a snapshot.
+        struct snapshot_header {
+            std::uint64_t fingerprint = 0;
+            std::uint64_t source_hash = 0;
+
+            // Files included by the source, and their hashes.
+            std::vector<std::pair<std::string, std::uint64_t>> includes;
+
+            // Include patterns with wildcards, and the files they matched.
+            std::vector<std::pair<std::string, std::vector<std::string>>>
+                globs;
+        };
+
+        /*
+         * Add the parser policy to a snapshot's fingerprint, since a
+         * snapshot taken with one policy might hold a result which another
+         * policy would reject or parse differently.  The policy's parsers
+         * can't be compared, so the policy is identified by its type, the
+         * types of its parsers and its flags.
+         */
+        template <typename Policy>
+        void policy_fingerprint(std::uint64_t &h) {
+            h = stable_hash(typeid(Policy).name(), h);
+            h = stable_hash(typeid(Policy::option_separator()).name(), h);
+            h = stable_hash(typeid(Policy::option_terminator()).name(), h);
+            h = stable_hash(Policy::allow_inline_lists ? "1" : "0", h);
+            h = stable_hash(Policy::allow_braced_lists ? "1" : "0", h);
+            h = stable_hash(Policy::allow_include ? "1" : "0", h);
+        }
+
+        // The files matched by an include pattern, as stored in a snapshot.
+        inline auto glob_matches(std::filesystem::path const &pattern)
+            -> std::vector<std::string> {
+            namespace x3 = boost::spirit::x3;
+
+            std::vector<std::string> matches;
+            for (auto &&path : expand_glob(pattern))
+                matches.push_back(x3::to_utf8(path.native()));
+            return matches;
+        }
+
+        /*
+         * The config() grammar inside a grammar passed to
+         * parse_file_cached(), and the table given to with_intern_table(),
+         * if any.
+         */
+        template <typename Grammar> struct cached_grammar {
+            static auto config(Grammar const &g) -> Grammar const & {
+                return g;
+            }
+
+            static auto strings(Grammar const &) -> intern_table * {
+                return nullptr;
+            }
+        };
+
+        template <typename Subject>
+        struct cached_grammar<boost::spirit::x3::with_directive<
+            Subject, intern_table_tag, std::reference_wrapper<intern_table>>> {
+            using grammar_type = boost::spirit::x3::with_directive<
+                Subject, intern_table_tag,
+                std::reference_wrapper<intern_table>>;
+
+            static auto config(grammar_type const &g) -> Subject const & {
+                return g.subject;
+            }
+
+            static auto strings(grammar_type const &g) -> intern_table * {
+                return &g.val.get();
+            }
+        };
+
+        /*
+         * Read a snapshot into ret if it matches the header.  Returns false
+         * if the snapshot is missing, stale or corrupt.  Interned strings
+         * are read into strings, or a table of the snapshot's own if it's
+         * null.
+         */
+        template <typename Codec, typename T>
+        auto load_snapshot(std::filesystem::path const &path,
+                           snapshot_header const &expected,
+                           Codec const &codec, intern_table *strings, T &ret)
+            -> bool {
+            try {
+                mapped_file file(path);
+                snapshot_reader r({file.data(), file.size()});
+                if (strings)
+                    r.set_intern_table(*strings);
+
+                char magic[sizeof(snapshot_magic)];
+                r.read_bytes(magic, sizeof(magic));
+                if (std::string_view(magic, sizeof(magic)) !=
+                    std::string_view(snapshot_magic, sizeof(snapshot_magic)))
+                    return false;
+
+                snapshot_header header;
+                r.read(header.fingerprint);
+                r.read(header.source_hash);
+                if (header.fingerprint != expected.fingerprint ||
+                    header.source_hash != expected.source_hash)
+                    return false;
+
+                auto nincludes = r.read_size();
+                for (std::size_t i = 0; i < nincludes; ++i) {
+                    std::string include;
+                    std::uint64_t hash;
+                    r.read_string(include);
+                    r.read(hash);
+
+                    if (hash_file(include) != hash)
+                        return false;
+                }
+
+                // A file added to or removed from an included directory
+                // changes the configuration even if no file has changed.
+                auto nglobs = r.read_size();
+                for (std::size_t i = 0; i < nglobs; ++i) {
+                    std::string pattern;
+                    r.read_string(pattern);
+
+                    std::vector<std::string> matches(r.read_size());
+                    for (auto &&match : matches)
+                        r.read_string(match);
+
+                    if (glob_matches(pattern) != matches)
+                        return false;
+                }
+
+                T value{};
+                codec.read(r, value);
+                if (!r.at_end())
+                    return false;
+
+                ret = std::move(value);
+                return true;
+            } catch (std::system_error const &) {
+                return false;
+            } catch (snapshot_error const &) {
+                return false;
+            }
+        }
+
+        /*
+         * Write a snapshot.  The cache is only an optimisation, so errors
+         * are ignored.
+         */
+        template <typename Codec, typename T>
+        void save_snapshot(std::filesystem::path const &path,
+                           snapshot_header const &header, Codec const &codec,
+                           T const &value) {
+            snapshot_writer w;
+            w.write_bytes(snapshot_magic, sizeof(snapshot_magic));
+            w.write(header.fingerprint);
+            w.write(header.source_hash);
+            w.write_size(header.includes.size());
+            for (auto &&[include, hash] : header.includes) {
+                w.write_string(include);
+                w.write(hash);
+            }
+            w.write_size(header.globs.size());
+            for (auto &&[pattern, matches] : header.globs) {
+                w.write_string(pattern);
+                w.write_size(matches.size());
+                for (auto &&match : matches)
+                    w.write_string(match);
+            }
+            codec.write(w, value);
+
+            // Write to a temporary file and rename it, so readers never
+            // see a partial snapshot.
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+
+            auto tmp = path;
+            tmp += ".tmp." + std::to_string(std::chrono::steady_clock::now()
+                                                 .time_since_epoch()
+                                                 .count());
+            {
+                std::ofstream strm(tmp, std::ios::binary);
+                strm.write(w.data().data(),
+                           static_cast<std::streamsize>(w.data().size()));
+                if (!strm) {
+                    std::filesystem::remove(tmp, ec);
+                    return;
+                }
+            }
+
+            std::filesystem::rename(tmp, path, ec);
+            if (ec)
+                std::filesystem::remove(tmp, ec);
+        }
+
+    } // namespace detail
+
+    /*
+     * Parse a file, using a binary snapshot of the result from a previous
+     * parse if the file hasn't changed.  Snapshots are stored in
+     * cache_dir.
+     *
+     * The grammar must be a config<T>() grammar built from option() and
+     * block(), optionally wrapped with with_intern_table(); any custom
+     * types used in the configuration need a snapshot_traits
+     * specialisation.  Unlike parse_file(), ret is
+     * replaced by the parsed value, so T must be default-constructible.
+     *
+     * Returns true if the result was loaded from a snapshot.
+     */
+    template <typename Policy = parser_policy, typename Grammar, typename T>
+    auto parse_file_cached(std::filesystem::path const &path,
+                           Grammar const &grammar, T &ret,
+                           std::filesystem::path const &cache_dir) -> bool {
+        namespace x3 = boost::spirit::x3;
+        namespace fs = std::filesystem;
+
+        using cached = detail::cached_grammar<Grammar>;
+        using config_type =
+            std::remove_cvref_t<decltype(cached::config(grammar))>;
+
+        static_assert(detail::is_described<config_type>::value,
+                      "parse_file_cached() requires a config() grammar");
+
+        auto const &codec = cached::config(grammar).info;
+        static_assert(
+            std::is_same_v<typename std::remove_cvref_t<decltype(codec)>::type,
+                           T>,
+            "the grammar doesn't produce this type");
+
+        auto utf8name = x3::to_utf8(path.native());
+
+        std::optional<detail::mapped_file> file;
+        try {
+            file.emplace(path);
+        } catch (std::system_error const &e) {
+            throw detail::make_file_error(path, e);
+        }
+
+        detail::snapshot_header header;
+        codec.fingerprint(header.fingerprint);
+        detail::policy_fingerprint<Policy>(header.fingerprint);
+        header.source_hash =
+            detail::stable_hash({file->data(), file->size()});
+
+        std::error_code ec;
+        auto canonical = fs::weakly_canonical(path, ec);
+        auto name = std::to_string(detail::stable_hash(
+                        x3::to_utf8(canonical.native()))) +
+                    ".snapshot";
+        auto snapshot = cache_dir / name;
+
+        if (detail::load_snapshot(snapshot, header, codec,
+                                  cached::strings(grammar), ret))
+            return true;
+
+        // Parse the file, and keep track of what it includes.
+        include_cache includes;
+        auto const grammar_ =
+            x3::with<include_cache_tag>(std::ref(includes))[grammar];
+
+        T value{};
+        parse<Policy>(file->begin(), file->end(), grammar_, value, utf8name);
+
+        for (auto &&include : includes.files())
+            if (auto hash = detail::hash_file(include))
+                header.includes.emplace_back(x3::to_utf8(include.native()),
+                                             *hash);
+
+        for (auto &&[pattern, matches] : includes.globs()) {
+            auto &glob = header.globs.emplace_back(
+                x3::to_utf8(pattern.native()), std::vector<std::string>());
+            for (auto &&match : matches)
+                glob.second.push_back(x3::to_utf8(match.native()));
+        }
+
+        detail::save_snapshot(snapshot, header, codec, value);
+        ret = std::move(value);
+        return false;
+    }
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_PARSE_FILE_CACHED_HXX_INCLUDED
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_PARSE_FILES_HXX_INCLUDED
+#define SK_CONFIG_PARSE_FILES_HXX_INCLUDED
+
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+#include <boost/spirit/home/x3/support/utility/utf8.hpp>
+
+#include <sk/config/detail/freeze.hxx>
+#include <sk/config/detail/mapped_file.hxx>
+#include <sk/config/detail/parallel.hxx>
+#include <sk/config/detail/parser/intern_scope.hxx>
+#include <sk/config/detail/propagate.hxx>
+#include <sk/config/error.hxx>
+#include <sk/config/parse.hxx>
+#include <sk/config/parser_policy.hxx>
+
+namespace sk::config {
+
+    namespace detail {
+
+        // One file being loaded by parse_files().
+        template <typename T> struct fragment {
+            std::filesystem::path path;
+            std::string name;
+            std::unique_ptr<mapped_file> file;
+            std::optional<deferred_log<T>> log;
+            std::exception_ptr error;
+        };
+
+    } // namespace detail
+
+    /*
+     * Parse several files into the same object.  The result is the same as
+     * calling parse_file() on each file in turn, but the files are loaded
+     * and parsed concurrently.  Strings are interned in one table for
+     * all the files (see interned_string).
+     *
+     * T must be default-constructible.
+     */
+    template <typename Policy = parser_policy, typename T>
+    auto parse_files(std::span<std::filesystem::path const> paths,
+                     auto const &grammar, T &ret) {
+        namespace x3 = boost::spirit::x3;
+
+        std::vector<detail::fragment<T>> fragments(paths.size());
+
+        // Open all the files first, so the OS can read them in parallel
+        // while we parse.
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            auto &f = fragments[i];
+            f.path = paths[i];
+            f.name = x3::to_utf8(f.path.native());
+
+            try {
+                f.file = std::make_unique<detail::mapped_file>(f.path);
+                f.file->prefetch();
+            } catch (std::system_error const &e) {
+                f.error =
+                    std::make_exception_ptr(detail::make_file_error(f.path, e));
+            }
+        }
+
+        // Parse each file into its own log.
+        detail::lazy_intern_table strings;
+        detail::parallel_for(fragments.size(), [&](std::size_t i) {
+            auto &f = fragments[i];
+            if (f.error)
+                return;
+
+            try {
+                T placeholder{};
+                f.log.emplace(&placeholder);
+
+                auto const grammar_ =
+                    x3::with<intern_table_tag>(std::ref(strings))
+                        [x3::with<detail::deferred_tag>(std::ref(*f.log))
+                             [grammar]];
+                parse<Policy>(f.file->begin(), f.file->end(), grammar_,
+                              placeholder, f.name);
+            } catch (...) {
+                f.error = std::current_exception();
+            }
+        });
+
+        // Merge the results in order, and freeze the result once they've
+        // all been merged.
+        detail::freeze_list list(ret);
+        for (auto &&f : fragments) {
+            if (f.error)
+                std::rethrow_exception(f.error);
+            detail::replay_log(*f.log, ret, list, f.file->begin(),
+                               f.file->end(), f.name);
+        }
+        list.freeze();
+
+        return true;
+    }
+
+    template <typename Policy = parser_policy, typename T>
+    auto parse_files(std::vector<std::filesystem::path> const &paths,
+                     auto const &grammar, T &ret) {
+        return parse_files<Policy>(
+            std::span<std::filesystem::path const>(paths), grammar, ret);
+    }
+
+    /*
+     * Parse all the files in a directory whose names end with extension,
+     * in order of their names.  If extension is empty, every regular file
+     * in the directory is parsed.  Files whose names start with '.' are
+     * ignored.
+     */
+    template <typename Policy = parser_policy, typename T>
+    auto parse_directory(std::filesystem::path const &directory,
+                         auto const &grammar, T &ret,
+                         std::string const &extension = ".conf") {
+        namespace fs = std::filesystem;
+
+        std::vector<fs::path> paths;
+
+        try {
+            for (auto &&entry : fs::directory_iterator(directory)) {
+                auto const &path = entry.path();
+                auto filename = path.filename().string();
+
+                if (filename.empty() || filename[0] == '.')
+                    continue;
+                if (!extension.empty() && path.extension() != extension)
+                    continue;
+                if (!entry.is_regular_file())
+                    continue;
+
+                paths.push_back(path);
+            }
+        } catch (fs::filesystem_error const &e) {
+            throw detail::make_file_error(directory, e);
+        }
+
+        std::ranges::sort(paths);
+        return parse_files<Policy>(paths, grammar, ret);
+    }
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_PARSE_FILES_HXX_INCLUDED
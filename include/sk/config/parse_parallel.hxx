@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_PARSE_PARALLEL_HXX_INCLUDED
+#define SK_CONFIG_PARSE_PARALLEL_HXX_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+#include <boost/spirit/home/x3/support/utility/utf8.hpp>
+
+#include <sk/config/detail/freeze.hxx>
+#include <sk/config/detail/mapped_file.hxx>
+#include <sk/config/detail/parallel.hxx>
+#include <sk/config/detail/parser/intern_scope.hxx>
+#include <sk/config/detail/propagate.hxx>
+#include <sk/config/detail/statement_scanner.hxx>
+#include <sk/config/parse.hxx>
+#include <sk/config/parser_policy.hxx>
+
+namespace sk::config {
+
+    namespace detail {
+
+        // A run of complete top-level statements.
+        struct shard {
+            // Start of the line containing first, and its line number.
+            char const *line_start;
+            std::size_t line;
+
+            char const *first;
+            char const *last;
+        };
+
+        /*
+         * Split [first, last) into shards of about shard_size bytes, each
+         * ending at the end of a top-level statement.
+         */
+        inline auto split_statements(char const *first, char const *last,
+                                     std::size_t shard_size)
+            -> std::vector<shard> {
+            std::vector<shard> shards;
+            statement_scanner scanner;
+
+            auto const *start = first;
+            auto const *pos = first;
+
+            while (auto end = scanner.scan(pos, last)) {
+                pos = *end;
+                if (static_cast<std::size_t>(pos - start) >= shard_size) {
+                    shards.push_back({first, 1, start, pos});
+                    start = pos;
+                }
+            }
+
+            if (start != last || shards.empty())
+                shards.push_back({first, 1, start, last});
+
+            // Find the line each shard starts on.  We count lines the same
+            // way that error_formatter does.
+            std::size_t line = 1;
+            char prev = 0;
+            auto const *counted = first;
+
+            for (auto &&s : shards) {
+                s.line_start = s.first;
+                while (s.line_start != first && s.line_start[-1] != '\n' &&
+                       s.line_start[-1] != '\r')
+                    --s.line_start;
+
+                for (; counted != s.line_start; ++counted) {
+                    char c = *counted;
+                    if (c == '\r' || (c == '\n' && prev != '\r'))
+                        ++line;
+                    prev = c;
+                }
+
+                s.line = line;
+            }
+
+            return shards;
+        }
+
+    } // namespace detail
+
+    /*
+     * Parse a configuration using several threads.  The input is split
+     * into runs of top-level statements, which are parsed at the same time
+     * and then merged in their original order, so the result (and any
+     * error) is the same as for parse().  Strings are interned in one
+     * table for all the shards (see interned_string).
+     *
+     * shard_size is the approximate number of bytes given to each thread
+     * at a time; if it's zero, a size is chosen based on the size of the
+     * input and the number of CPUs.
+     *
+     * Statements are split at top-level ';' characters, so the parser
+     * policy must use the default option terminator.  T must be
+     * default-constructible.
+     */
+    template <typename Policy = parser_policy, typename T>
+    auto parse_parallel(std::string_view text, auto const &grammar, T &ret,
+                        std::string const &filename = "",
+                        std::size_t shard_size = 0) {
+        namespace x3 = boost::spirit::x3;
+
+        auto const *first = text.data();
+        auto const *last = text.data() + text.size();
+
+        if (shard_size == 0) {
+            std::size_t nthreads =
+                std::max(1u, std::thread::hardware_concurrency());
+            shard_size =
+                std::max<std::size_t>(text.size() / (nthreads * 4), 65536);
+        }
+
+        auto shards = detail::split_statements(first, last, shard_size);
+        if (shards.size() == 1)
+            return parse<Policy>(first, last, grammar, ret, filename);
+
+        struct result {
+            std::optional<detail::deferred_log<T>> log;
+            std::exception_ptr error;
+        };
+        std::vector<result> results(shards.size());
+        detail::lazy_intern_table strings;
+
+        detail::parallel_for(shards.size(), [&](std::size_t i) {
+            auto const &s = shards[i];
+            auto &r = results[i];
+
+            try {
+                T placeholder{};
+                r.log.emplace(&placeholder);
+
+                auto const grammar_ =
+                    x3::with<intern_table_tag>(std::ref(strings))
+                        [x3::with<detail::deferred_tag>(std::ref(*r.log))
+                             [grammar]];
+                detail::parse_at<Policy>(s.line_start, s.first, s.last,
+                                         grammar_, placeholder, filename,
+                                         s.line);
+            } catch (...) {
+                r.error = std::current_exception();
+            }
+        });
+
+        detail::freeze_list list(ret);
+        for (auto &&r : results) {
+            if (r.error)
+                std::rethrow_exception(r.error);
+            detail::replay_log(*r.log, ret, list, first, last, filename);
+        }
+        list.freeze();
+
+        return true;
+    }
+
+    /*
+     * Parse a file using several threads, as parse_parallel().
+     */
+    template <typename Policy = parser_policy, typename T>
+    auto parse_file_parallel(std::filesystem::path filename,
+                             auto const &grammar, T &ret) {
+        auto utf8name = boost::spirit::x3::to_utf8(filename.native());
+
+        std::optional<detail::mapped_file> file;
+        try {
+            file.emplace(filename);
+        } catch (std::system_error const &e) {
+            throw detail::make_file_error(filename, e);
+        }
+
+        return parse_parallel<Policy>(
+            std::string_view(file->data(), file->size()), grammar, ret,
+            utf8name);
+    }
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_PARSE_PARALLEL_HXX_INCLUDED
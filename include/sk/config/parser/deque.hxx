@@ -31,12 +31,14 @@
 
 #include <deque>
 
+#include <sk/config/detail/memory_resource.hxx>
 #include <sk/config/detail/parser/vector.hxx>
 #include <sk/config/parser_for.hxx>
 
 namespace sk::config {
 
-    template <typename T> struct parser_for<std::deque<T>> {
+    template <typename T, typename Alloc>
+    struct parser_for<std::deque<T, Alloc>> {
         using parser_type =
             detail::parser::vector<typename parser_for<T>::parser_type>;
         using rule_type = std::vector<T>;
@@ -46,9 +48,10 @@ namespace sk::config {
     namespace detail {
 
         // deque<T> <- vector<T>
-        template <typename U>
-        void propagate_value(auto & /*ctx*/, std::deque<U> &to,
+        template <typename U, typename Alloc>
+        void propagate_value(auto &ctx, std::deque<U, Alloc> &to,
                              std::vector<U> &from) {
+            use_resource(ctx, to);
             std::move(from.begin(), from.end(), std::back_inserter(to));
             from.clear();
         }
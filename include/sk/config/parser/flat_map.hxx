@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_PARSER_FLAT_MAP_HXX_INCLUDED
+#define SK_CONFIG_PARSER_FLAT_MAP_HXX_INCLUDED
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <boost/container/flat_map.hpp>
+
+#if __has_include(<flat_map>)
+#    include <flat_map>
+#endif
+
+#include <sk/config/detail/flat.hxx>
+#include <sk/config/detail/parser/map.hxx>
+#include <sk/config/parser_for.hxx>
+
+namespace sk::config {
+
+    template <typename Key, typename Value, typename Alloc>
+    struct parser_for<
+        boost::container::flat_map<Key, Value, std::less<Key>, Alloc>> {
+        using parser_type =
+            detail::parser::map<typename parser_for<Key>::parser_type,
+                                typename parser_for<Value>::parser_type>;
+        using rule_type = typename parser_type::attribute_type;
+        static constexpr char const name[] = "a block";
+    };
+
+#if defined(__cpp_lib_flat_map)
+    template <typename Key, typename Value, typename KeyContainer,
+              typename MappedContainer>
+    struct parser_for<std::flat_map<Key, Value, std::less<Key>, KeyContainer,
+                                    MappedContainer>> {
+        using parser_type =
+            detail::parser::map<typename parser_for<Key>::parser_type,
+                                typename parser_for<Value>::parser_type>;
+        using rule_type = typename parser_type::attribute_type;
+        static constexpr char const name[] = "a block";
+    };
+#endif
+
+    namespace detail {
+
+        template <typename T, typename U, typename Alloc>
+        void propagate_value(
+            auto &ctx,
+            boost::container::flat_map<T, U, std::less<T>, Alloc> &to,
+            U &from, auto &name) {
+            flat_map_propagate_block(ctx, to, from, name,
+                                     boost::container::ordered_unique_range);
+        }
+
+        template <typename T, typename U, typename Alloc, typename K,
+                  typename V>
+        void propagate_value(
+            auto &ctx,
+            boost::container::flat_map<T, U, std::less<T>, Alloc> &to,
+            std::vector<std::pair<K, V>> &from) {
+            flat_map_propagate(ctx, to, from,
+                               boost::container::ordered_unique_range);
+        }
+
+#if defined(__cpp_lib_flat_map)
+        template <typename T, typename U, typename KC, typename MC>
+        void propagate_value(auto &ctx,
+                             std::flat_map<T, U, std::less<T>, KC, MC> &to,
+                             U &from, auto &name) {
+            flat_map_propagate_block(ctx, to, from, name, std::sorted_unique);
+        }
+
+        template <typename T, typename U, typename KC, typename MC,
+                  typename K, typename V>
+        void propagate_value(auto &ctx,
+                             std::flat_map<T, U, std::less<T>, KC, MC> &to,
+                             std::vector<std::pair<K, V>> &from) {
+            flat_map_propagate(ctx, to, from, std::sorted_unique);
+        }
+#endif
+
+    } // namespace detail
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_PARSER_FLAT_MAP_HXX_INCLUDED
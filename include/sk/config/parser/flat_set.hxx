@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_PARSER_FLAT_SET_HXX_INCLUDED
+#define SK_CONFIG_PARSER_FLAT_SET_HXX_INCLUDED
+
+#include <functional>
+#include <vector>
+
+#include <boost/container/flat_set.hpp>
+
+#if __has_include(<flat_set>)
+#    include <flat_set>
+#endif
+
+#include <sk/config/detail/flat.hxx>
+#include <sk/config/detail/parser/vector.hxx>
+#include <sk/config/parser_for.hxx>
+
+namespace sk::config {
+
+    template <typename T, typename Alloc>
+    struct parser_for<boost::container::flat_set<T, std::less<T>, Alloc>> {
+        using parser_type =
+            detail::parser::vector<typename parser_for<T>::parser_type>;
+        using rule_type = std::vector<T>;
+        static constexpr char const name[] = "a list of values";
+    };
+
+#if defined(__cpp_lib_flat_set)
+    template <typename T, typename KeyContainer>
+    struct parser_for<std::flat_set<T, std::less<T>, KeyContainer>> {
+        using parser_type =
+            detail::parser::vector<typename parser_for<T>::parser_type>;
+        using rule_type = std::vector<T>;
+        static constexpr char const name[] = "a list of values";
+    };
+#endif
+
+    namespace detail {
+
+        // flat_set<T> <- vector<T>
+        template <typename U, typename Alloc>
+        void propagate_value(
+            auto &ctx, boost::container::flat_set<U, std::less<U>, Alloc> &to,
+            std::vector<U> &from) {
+            flat_set_propagate(ctx, to, from,
+                               boost::container::ordered_unique_range);
+        }
+
+#if defined(__cpp_lib_flat_set)
+        template <typename U, typename KeyContainer>
+        void propagate_value(auto &ctx,
+                             std::flat_set<U, std::less<U>, KeyContainer> &to,
+                             std::vector<U> &from) {
+            flat_set_propagate(ctx, to, from, std::sorted_unique);
+        }
+#endif
+
+    } // namespace detail
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_PARSER_FLAT_SET_HXX_INCLUDED
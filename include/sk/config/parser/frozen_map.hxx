@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_PARSER_FROZEN_MAP_HXX_INCLUDED
+#define SK_CONFIG_PARSER_FROZEN_MAP_HXX_INCLUDED
+
+#include <utility>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/freeze.hxx>
+#include <sk/config/detail/parser/expect.hxx>
+#include <sk/config/detail/parser/map.hxx>
+#include <sk/config/detail/propagate.hxx>
+#include <sk/config/frozen_map.hxx>
+#include <sk/config/parser_for.hxx>
+
+namespace sk::config {
+
+    template <typename Key, typename Value, typename Hash, typename Eq>
+    struct parser_for<frozen_map<Key, Value, Hash, Eq>> {
+        using parser_type =
+            detail::parser::map<typename parser_for<Key>::parser_type,
+                                typename parser_for<Value>::parser_type>;
+        using rule_type = typename parser_type::attribute_type;
+        static constexpr char const name[] = "a block";
+    };
+
+    namespace detail {
+
+        template <typename T, typename U, typename Hash, typename Eq>
+        void propagate_value(auto &ctx, frozen_map<T, U, Hash, Eq> &to,
+                             U &from, auto &name) {
+            namespace x3 = boost::spirit::x3;
+
+            // The key is copied before from is moved into the value.
+            if (!to.emplace(T(from.*name), std::move(from)).second) {
+                auto it = x3::_where(ctx).begin();
+                detail::parser::action_failed(it, "unique value", ctx);
+                return;
+            }
+
+            freeze_later(ctx, to);
+        }
+
+        // As for std::map, the parsed items might not have the map's own
+        // key and value types.
+        template <typename T, typename U, typename Hash, typename Eq,
+                  typename K, typename V>
+        void propagate_value(auto &ctx, frozen_map<T, U, Hash, Eq> &to,
+                             std::vector<std::pair<K, V>> &from) {
+            namespace x3 = boost::spirit::x3;
+
+            for (auto &&item : from) {
+                U value{};
+                propagate_value(ctx, value, item.second);
+
+                if (!to.emplace(T(std::move(item.first)), std::move(value))
+                         .second) {
+                    auto it = x3::_where(ctx).begin();
+                    detail::parser::action_failed(it, "a block", ctx);
+                    return;
+                }
+            }
+
+            freeze_later(ctx, to);
+        }
+
+    } // namespace detail
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_PARSER_FROZEN_MAP_HXX_INCLUDED
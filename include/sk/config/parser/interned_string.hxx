@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_PARSER_INTERNED_STRING_HXX_INCLUDED
+#define SK_CONFIG_PARSER_INTERNED_STRING_HXX_INCLUDED
+
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/parser/intern_scope.hxx>
+#include <sk/config/interned_string.hxx>
+#include <sk/config/parser/string.hxx>
+#include <sk/config/parser_for.hxx>
+#include <sk/config/snapshot.hxx>
+
+namespace sk::config {
+
+    /*
+     * Return a grammar which interns strings in table rather than in a
+     * table belonging to the parse.  This can be passed to any of the
+     * parse functions, and to parse_file_cached().  Strings in included
+     * files are still interned in a table of their own, since the parsed
+     * files can be cached and used by later parses.
+     */
+    auto with_intern_table(intern_table &table, auto const &grammar) {
+        namespace x3 = boost::spirit::x3;
+        return x3::with<intern_table_tag>(std::ref(table))[grammar];
+    }
+
+} // namespace sk::config
+
+namespace sk::config::parser {
+
+    /*
+     * Parse a string and intern it.  This accepts the same syntax as
+     * std::string.
+     */
+    struct interned_string_parser
+        : boost::spirit::x3::parser<interned_string_parser> {
+        typedef interned_string attribute_type;
+        static bool const has_attribute = true;
+
+        template <typename Iterator, typename Context>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, boost::spirit::x3::unused_type,
+                   attribute_type &attr) const {
+            namespace x3 = boost::spirit::x3;
+
+            static const any_string_parser<char> string_parser;
+
+            // Most names fit in the small string buffer, so this usually
+            // doesn't allocate.
+            std::string s;
+            if (!string_parser.parse(first, last, context, x3::unused, s))
+                return false;
+
+            using table_ref = std::remove_cvref_t<decltype(
+                x3::get<intern_table_tag>(context))>;
+
+            // Outside a config() grammar, there's no table for the parse.
+            if constexpr (std::is_same_v<table_ref, x3::unused_type>)
+                attr = shared_intern_table().intern(s);
+            else
+                attr = x3::get<intern_table_tag>(context).get().intern(s);
+
+            return true;
+        }
+
+        template <typename Iterator, typename Context, typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, boost::spirit::x3::unused_type,
+                   Attribute &attr_param) const {
+            attribute_type attr_;
+            if (parse(first, last, context, boost::spirit::x3::unused, attr_)) {
+                boost::spirit::x3::traits::move_to(attr_, attr_param);
+                return true;
+            }
+            return false;
+        }
+    };
+
+} // namespace sk::config::parser
+
+namespace sk::config {
+
+    template <> struct parser_for<interned_string> {
+        using parser_type = parser::interned_string_parser;
+        using rule_type = interned_string;
+        static constexpr char const name[] = "a string";
+    };
+
+    // Snapshots store the text, which is interned in the reader's table
+    // when the snapshot is loaded.
+    template <> struct snapshot_traits<interned_string> {
+        static void write(snapshot_writer &w, interned_string const &s) {
+            w.write_string(s.view());
+        }
+
+        static void read(snapshot_reader &r, interned_string &s) {
+            std::string text;
+            r.read_string(text);
+            s = r.strings().intern(text);
+        }
+    };
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_PARSER_INTERNED_STRING_HXX_INCLUDED
@@ -29,54 +29,91 @@
 #ifndef SK_CONFIG_PARSER_MAP_HXX_INCLUDED
 #define SK_CONFIG_PARSER_MAP_HXX_INCLUDED
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
 #include <map>
+#include <tuple>
+#include <utility>
 
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/memory_resource.hxx>
+#include <sk/config/detail/parser/expect.hxx>
 #include <sk/config/detail/parser/map.hxx>
+#include <sk/config/detail/propagate.hxx>
 #include <sk/config/parser_for.hxx>
 
 namespace sk::config {
 
-    template <typename Key, typename Value>
-    struct parser_for<std::map<Key, Value>> {
+    template <typename Key, typename Value, typename Alloc>
+    struct parser_for<std::map<Key, Value, std::less<Key>, Alloc>> {
         using parser_type =
             detail::parser::map<typename parser_for<Key>::parser_type,
                                 typename parser_for<Value>::parser_type>;
-        using rule_type = std::vector<std::pair<Key, Value>>;
+        using rule_type = typename parser_type::attribute_type;
         static constexpr char const name[] = "a block";
     };
 
     namespace detail {
 
-        template <typename T, typename U>
-        void propagate_value(auto &ctx, std::map<T, U> &to, U &from,
-                             auto &name) {
+        template <typename T, typename U, typename Alloc>
+        void propagate_value(auto &ctx, std::map<T, U, std::less<T>, Alloc> &to,
+                             U &from, auto &name) {
             namespace x3 = boost::spirit::x3;
 
-            auto r = to.insert(std::make_pair(from.*name, from));
+            use_resource(ctx, to);
+
+            // The key is copied before from is moved into the value.
+            auto r = to.emplace(std::piecewise_construct,
+                                std::forward_as_tuple(from.*name),
+                                std::forward_as_tuple(std::move(from)));
 
             if (!r.second) {
                 auto it = x3::_where(ctx).begin();
-                boost::throw_exception(
-                    x3::expectation_failure<decltype(it)>(it, "unique value"));
+                detail::parser::action_failed(it, "unique value", ctx);
             }
         }
 
-        template <typename T, typename U>
-        void propagate_value(auto &ctx, std::map<T, U> &to,
-                             std::vector<std::pair<T, U>> &from) {
+        /*
+         * The parsed items might not have the map's own key and value
+         * types: for example, a std::pmr::string key is parsed as a
+         * std::string.  Each key is converted when its node is created,
+         * and the value is then propagated into the node.
+         */
+        template <typename T, typename U, typename Alloc, typename K,
+                  typename V>
+        void propagate_value(auto &ctx, std::map<T, U, std::less<T>, Alloc> &to,
+                             std::vector<std::pair<K, V>> &from) {
             namespace x3 = boost::spirit::x3;
 
+            use_resource(ctx, to);
+
+            if (from.empty())
+                return;
+
+            // Insert the items in key order, so each one goes just after the
+            // previous one and the hint is right, at least when the map
+            // started out empty.
+            std::ranges::sort(from, std::less<>(), &std::pair<K, V>::first);
+
+            auto hint = to.empty() ? to.end()
+                                   : to.lower_bound(T(from.front().first));
             for (auto &&item : from) {
-                auto r = to.insert(item);
+                auto size = to.size();
+                auto node = to.emplace_hint(
+                    hint, std::piecewise_construct,
+                    std::forward_as_tuple(std::move(item.first)),
+                    std::tuple<>());
 
-                if (!r.second) {
+                if (to.size() == size) {
                     auto it = x3::_where(ctx).begin();
-                    boost::throw_exception(
-                        x3::expectation_failure<decltype(it)>(it,
-                                                              "a block"));
+                    detail::parser::action_failed(it, "a block", ctx);
+                    return;
                 }
+
+                propagate_value(ctx, node->second, item.second);
+                hint = std::next(node);
             }
         }
 
@@ -31,11 +31,8 @@
 
 #include <concepts>
 
-#include <boost/spirit/home/x3/numeric/int.hpp>
-#include <boost/spirit/home/x3/numeric/real.hpp>
-#include <boost/spirit/home/x3/numeric/uint.hpp>
-
 #include <sk/config/detail/parser/bool.hxx>
+#include <sk/config/detail/parser/number.hxx>
 #include <sk/config/parser_for.hxx>
 
 namespace sk::config {
@@ -58,7 +55,7 @@ namespace sk::config {
 
     // signed_integral
     template <std::signed_integral T> struct parser_for<T> {
-        using parser_type = boost::spirit::x3::int_parser<T>;
+        using parser_type = detail::parser::number_parser<T>;
         using rule_type = T;
         static constexpr char const name[] = "an integer";
     };
@@ -70,7 +67,7 @@ namespace sk::config {
 
     // unsigned_integral
     template <std::unsigned_integral T> struct parser_for<T> {
-        using parser_type = boost::spirit::x3::uint_parser<T>;
+        using parser_type = detail::parser::number_parser<T>;
         using rule_type = T;
         static constexpr char const name[] = "a positive integer";
     };
@@ -81,12 +78,8 @@ namespace sk::config {
     }
 
     // floating_point
-    template <typename T>
-    struct config_real_policies : boost::spirit::x3::real_policies<T> {};
-
     template <std::floating_point T> struct parser_for<T> {
-        using parser_type =
-            boost::spirit::x3::real_parser<float, config_real_policies<float>>;
+        using parser_type = detail::parser::number_parser<T>;
         using rule_type = T;
         static constexpr char const name[] = "a decimal number";
     };
@@ -29,14 +29,21 @@
 #ifndef SK_CONFIG_PARSER_SET_HXX_INCLUDED
 #define SK_CONFIG_PARSER_SET_HXX_INCLUDED
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
 #include <set>
+#include <utility>
 
+#include <sk/config/detail/memory_resource.hxx>
+#include <sk/config/detail/parser/expect.hxx>
 #include <sk/config/detail/parser/vector.hxx>
 #include <sk/config/parser_for.hxx>
 
 namespace sk::config {
 
-    template <typename T> struct parser_for<std::set<T>> {
+    template <typename T, typename Alloc>
+    struct parser_for<std::set<T, std::less<T>, Alloc>> {
         using parser_type =
             detail::parser::vector<typename parser_for<T>::parser_type>;
         using rule_type = std::vector<T>;
@@ -46,16 +53,30 @@ namespace sk::config {
     namespace detail {
 
         // set<T> <- vector<T>
-        template <typename U>
-        void propagate_value(auto &ctx, std::set<U> &to, std::vector<U> &from) {
+        template <typename U, typename Alloc>
+        void propagate_value(auto &ctx, std::set<U, std::less<U>, Alloc> &to,
+                             std::vector<U> &from) {
             namespace x3 = boost::spirit::x3;
 
+            use_resource(ctx, to);
+
+            if (from.empty())
+                return;
+
+            // Insert the values in order, so each one goes just after the
+            // previous one and the hint is right, at least when the set
+            // started out empty.
+            std::ranges::sort(from, to.value_comp());
+
+            auto hint = to.lower_bound(from.front());
             for (auto &&v : from) {
-                if (!to.insert(v).second) {
+                auto size = to.size();
+                hint = std::next(to.emplace_hint(hint, std::move(v)));
+
+                if (to.size() == size) {
                     auto it = x3::_where(ctx).begin();
-                    boost::throw_exception(
-                        x3::expectation_failure<decltype(it)>(it,
-                                                              "unique value"));
+                    detail::parser::action_failed(it, "unique value", ctx);
+                    return;
                 }
             }
         }
@@ -29,12 +29,15 @@
 #ifndef SK_CONFIG_PARSER_ANY_STRING_HXX_INCLUDED
 #define SK_CONFIG_PARSER_ANY_STRING_HXX_INCLUDED
 
+#include <memory>
 #include <string>
+#include <type_traits>
 
 #include <boost/spirit/home/x3/core/parser.hpp>
 #include <boost/spirit/home/x3/operator/alternative.hpp>
 #include <boost/spirit/home/x3/support/unused.hpp>
 
+#include <sk/config/detail/memory_resource.hxx>
 #include <sk/config/detail/parser/identifier.hxx>
 #include <sk/config/detail/parser/qstring.hxx>
 #include <sk/config/detail/parser/heredoc.hxx>
@@ -79,12 +82,27 @@ namespace sk::config::parser {
 
 namespace sk::config {
 
-    template <typename Char> struct parser_for<std::basic_string<Char>> {
+    template <typename Char, typename Alloc>
+    struct parser_for<std::basic_string<Char, std::char_traits<Char>, Alloc>> {
         using parser_type = parser::any_string_parser<Char>;
         using rule_type = std::basic_string<Char>;
         static constexpr char const name[] = "a string";
     };
 
+    namespace detail {
+
+        // basic_string<Char, Traits, Alloc> <- basic_string<Char>
+        template <typename Char, typename Alloc>
+            requires(!std::is_same_v<Alloc, std::allocator<Char>>)
+        void propagate_value(
+            auto &ctx, std::basic_string<Char, std::char_traits<Char>, Alloc> &to,
+            std::basic_string<Char> &from) {
+            use_resource(ctx, to);
+            to.assign(from.begin(), from.end());
+        }
+
+    } // namespace detail
+
 } // namespace sk::config
 
 #endif // SK_CONFIG_PARSER_ANY_STRING_HXX_INCLUDED
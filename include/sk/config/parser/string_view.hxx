@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_PARSER_STRING_VIEW_HXX_INCLUDED
+#define SK_CONFIG_PARSER_STRING_VIEW_HXX_INCLUDED
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/parser/heredoc.hxx>
+#include <sk/config/detail/parser/identifier.hxx>
+#include <sk/config/detail/parser/qstring.hxx>
+#include <sk/config/parser_for.hxx>
+#include <sk/config/source_buffer.hxx>
+
+namespace sk::config::parser {
+
+    /*
+     * Parse a string into a std::string_view which refers to the
+     * source_buffer being parsed.  This accepts the same syntax as
+     * std::string, but only strings containing escapes are copied.
+     */
+    struct string_view_parser
+        : boost::spirit::x3::parser<string_view_parser> {
+        typedef std::string_view attribute_type;
+        static bool const has_attribute = true;
+
+        template <typename Iterator, typename Context>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, boost::spirit::x3::unused_type,
+                   attribute_type &attr) const {
+            namespace x3 = boost::spirit::x3;
+
+            using buffer_type = std::remove_cvref_t<decltype(
+                x3::get<source_buffer_tag>(context))>;
+
+            static_assert(!std::is_same_v<buffer_type, x3::unused_type>,
+                          "std::string_view can only be parsed from a "
+                          "source_buffer");
+            static_assert(std::is_same_v<Iterator, char const *>,
+                          "std::string_view can only be parsed from a "
+                          "source_buffer");
+
+            static const detail::parser::identifier<char> identifier;
+            static const detail::parser::qstring<char> qstring;
+            static const detail::parser::heredoc<char> heredoc;
+
+            x3::skip_over(first, last, context);
+
+            if (first == last)
+                return false;
+
+            // Unquoted string.
+            boost::iterator_range<Iterator> range;
+            if (x3::raw[identifier].parse(first, last, context, x3::unused,
+                                          range)) {
+                attr = std::string_view(range.begin(), range.size());
+                return true;
+            }
+
+            // Quoted string.  If there are no escapes, we can return the
+            // text between the quotes.
+            if (*first == '\'' || *first == '"') {
+                auto quote = *first;
+                auto end = first + 1;
+
+                while (end != last && *end != quote && *end != '\\')
+                    ++end;
+
+                if (end != last && *end == quote) {
+                    attr = std::string_view(first + 1, end - (first + 1));
+                    first = end + 1;
+                    return true;
+                }
+
+                std::string s;
+                if (!qstring.parse(first, last, context, x3::unused, s))
+                    return false;
+
+                auto &buffer = x3::get<source_buffer_tag>(context).get();
+                attr = buffer.store(std::move(s));
+                return true;
+            }
+
+            // Heredoc.
+            if (heredoc.parse_body(first, last, context, range)) {
+                attr = std::string_view(range.begin(), range.size());
+                return true;
+            }
+
+            return false;
+        }
+
+        template <typename Iterator, typename Context, typename Attribute>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, boost::spirit::x3::unused_type,
+                   Attribute &attr_param) const {
+            attribute_type attr_;
+            if (parse(first, last, context, boost::spirit::x3::unused, attr_)) {
+                boost::spirit::x3::traits::move_to(attr_, attr_param);
+                return true;
+            }
+            return false;
+        }
+    };
+
+} // namespace sk::config::parser
+
+namespace boost::spirit::x3::traits {
+
+    // Spirit would otherwise treat string_view as a container of chars and
+    // try to append to it.
+    template <>
+    struct detail::is_container_impl<std::string_view> : mpl::false_ {};
+
+} // namespace boost::spirit::x3::traits
+
+namespace sk::config {
+
+    template <> struct parser_for<std::string_view> {
+        using parser_type = parser::string_view_parser;
+        using rule_type = std::string_view;
+        static constexpr char const name[] = "a string";
+    };
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_PARSER_STRING_VIEW_HXX_INCLUDED
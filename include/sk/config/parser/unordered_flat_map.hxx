@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_PARSER_UNORDERED_FLAT_MAP_HXX_INCLUDED
+#define SK_CONFIG_PARSER_UNORDERED_FLAT_MAP_HXX_INCLUDED
+
+#if !__has_include(<boost/unordered/unordered_flat_map.hpp>)
+#    error "boost::unordered_flat_map requires Boost 1.81 or later"
+#endif
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <sk/config/detail/memory_resource.hxx>
+#include <sk/config/detail/parser/expect.hxx>
+#include <sk/config/detail/parser/map.hxx>
+#include <sk/config/detail/propagate.hxx>
+#include <sk/config/parser_for.hxx>
+
+namespace sk::config {
+
+    template <typename Key, typename Value, typename Hash, typename Eq,
+              typename Alloc>
+    struct parser_for<boost::unordered_flat_map<Key, Value, Hash, Eq, Alloc>> {
+        using parser_type =
+            detail::parser::map<typename parser_for<Key>::parser_type,
+                                typename parser_for<Value>::parser_type>;
+        using rule_type = typename parser_type::attribute_type;
+        static constexpr char const name[] = "a block";
+    };
+
+    namespace detail {
+
+        template <typename T, typename U, typename Hash, typename Eq,
+                  typename Alloc>
+        void propagate_value(
+            auto &ctx, boost::unordered_flat_map<T, U, Hash, Eq, Alloc> &to,
+            U &from, auto &name) {
+            namespace x3 = boost::spirit::x3;
+
+            use_resource(ctx, to);
+
+            // The key is copied before from is moved into the value.
+            auto r = to.try_emplace(from.*name, std::move(from));
+
+            if (!r.second) {
+                auto it = x3::_where(ctx).begin();
+                detail::parser::action_failed(it, "unique value", ctx);
+            }
+        }
+
+        // As for std::unordered_map, the parsed items might not have the
+        // map's own key and value types.
+        template <typename T, typename U, typename Hash, typename Eq,
+                  typename Alloc, typename K, typename V>
+        void propagate_value(
+            auto &ctx, boost::unordered_flat_map<T, U, Hash, Eq, Alloc> &to,
+            std::vector<std::pair<K, V>> &from) {
+            namespace x3 = boost::spirit::x3;
+
+            use_resource(ctx, to);
+            to.reserve(to.size() + from.size());
+
+            for (auto &&item : from) {
+                auto r = to.try_emplace(T(std::move(item.first)));
+
+                if (!r.second) {
+                    auto it = x3::_where(ctx).begin();
+                    detail::parser::action_failed(it, "a block", ctx);
+                    return;
+                }
+
+                propagate_value(ctx, r.first->second, item.second);
+            }
+        }
+
+    } // namespace detail
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_PARSER_UNORDERED_FLAT_MAP_HXX_INCLUDED
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_PARSER_UNORDERED_FLAT_SET_HXX_INCLUDED
+#define SK_CONFIG_PARSER_UNORDERED_FLAT_SET_HXX_INCLUDED
+
+#if !__has_include(<boost/unordered/unordered_flat_set.hpp>)
+#    error "boost::unordered_flat_set requires Boost 1.81 or later"
+#endif
+
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+#include <boost/unordered/unordered_flat_set.hpp>
+
+#include <sk/config/detail/memory_resource.hxx>
+#include <sk/config/detail/parser/expect.hxx>
+#include <sk/config/detail/parser/vector.hxx>
+#include <sk/config/parser_for.hxx>
+
+namespace sk::config {
+
+    template <typename T, typename Hash, typename Eq, typename Alloc>
+    struct parser_for<boost::unordered_flat_set<T, Hash, Eq, Alloc>> {
+        using parser_type =
+            detail::parser::vector<typename parser_for<T>::parser_type>;
+        using rule_type = std::vector<T>;
+        static constexpr char const name[] = "a list of values";
+    };
+
+    namespace detail {
+
+        // unordered_flat_set<T> <- vector<T>
+        template <typename U, typename Hash, typename Eq, typename Alloc>
+        void propagate_value(auto &ctx,
+                             boost::unordered_flat_set<U, Hash, Eq, Alloc> &to,
+                             std::vector<U> &from) {
+            namespace x3 = boost::spirit::x3;
+
+            use_resource(ctx, to);
+            to.reserve(to.size() + from.size());
+
+            for (auto &&v : from) {
+                if (!to.insert(std::move(v)).second) {
+                    auto it = x3::_where(ctx).begin();
+                    detail::parser::action_failed(it, "unique value", ctx);
+                    return;
+                }
+            }
+        }
+
+    } // namespace detail
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_PARSER_UNORDERED_FLAT_SET_HXX_INCLUDED
@@ -29,14 +29,20 @@
 #ifndef SK_CONFIG_PARSER_UNORDERED_SET_HXX_INCLUDED
 #define SK_CONFIG_PARSER_UNORDERED_SET_HXX_INCLUDED
 
+#include <functional>
 #include <unordered_set>
+#include <utility>
 
+#include <sk/config/detail/memory_resource.hxx>
+#include <sk/config/detail/parser/expect.hxx>
 #include <sk/config/detail/parser/vector.hxx>
 #include <sk/config/parser_for.hxx>
 
 namespace sk::config {
 
-    template <typename T> struct parser_for<std::unordered_set<T>> {
+    template <typename T, typename Alloc>
+    struct parser_for<
+        std::unordered_set<T, std::hash<T>, std::equal_to<T>, Alloc>> {
         using parser_type =
             detail::parser::vector<typename parser_for<T>::parser_type>;
         using rule_type = std::vector<T>;
@@ -46,17 +52,22 @@ namespace sk::config {
     namespace detail {
 
         // unordered_set<T> <- vector<T>
-        template <typename U>
-        void propagate_value(auto &ctx, std::unordered_set<U> &to,
-                             std::vector<U> &from) {
+        template <typename U, typename Alloc>
+        void propagate_value(
+            auto &ctx,
+            std::unordered_set<U, std::hash<U>, std::equal_to<U>, Alloc> &to,
+            std::vector<U> &from) {
             namespace x3 = boost::spirit::x3;
 
+            use_resource(ctx, to);
+
+            to.reserve(to.size() + from.size());
+
             for (auto &&v : from) {
-                if (!to.insert(v).second) {
+                if (!to.insert(std::move(v)).second) {
                     auto it = x3::_where(ctx).begin();
-                    boost::throw_exception(
-                        x3::expectation_failure<decltype(it)>(it,
-                                                              "unique value"));
+                    detail::parser::action_failed(it, "unique value", ctx);
+                    return;
                 }
             }
         }
@@ -29,15 +29,19 @@
 #ifndef SK_CONFIG_PARSER_VECTOR_HXX_INCLUDED
 #define SK_CONFIG_PARSER_VECTOR_HXX_INCLUDED
 
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <sk/config/detail/memory_resource.hxx>
 #include <sk/config/detail/parser/vector.hxx>
 #include <sk/config/parser_for.hxx>
 
 namespace sk::config {
 
-    template <typename T>
-    struct parser_for<std::vector<T>> {
+    template <typename T, typename Alloc>
+    struct parser_for<std::vector<T, Alloc>> {
         using parser_type =
             detail::parser::vector<typename parser_for<T>::parser_type>;
         using rule_type = std::vector<T>;
@@ -48,15 +52,25 @@ namespace sk::config {
 
         // vector<T> <- T
         // This one is required for vector of UDTs.
-        template <typename U>
-        void propagate_value(auto & /*ctx*/, std::vector<U> &to, U &from) {
-            to.push_back(from);
+        template <typename U, typename Alloc>
+        void propagate_value(auto &ctx, std::vector<U, Alloc> &to, U &from) {
+            use_resource(ctx, to);
+            to.push_back(std::move(from));
         }
 
         // vector<T> <- vector<T>
-        template <typename U>
-        void propagate_value(auto & /*ctx*/, std::vector<U> &to,
+        template <typename U, typename Alloc>
+        void propagate_value(auto &ctx, std::vector<U, Alloc> &to,
                              std::vector<U> &from) {
+            use_resource(ctx, to);
+
+            if constexpr (std::is_same_v<Alloc, std::allocator<U>>) {
+                if (to.empty()) {
+                    to = std::move(from);
+                    return;
+                }
+            }
+
             std::move(from.begin(), from.end(), std::back_inserter(to));
             from.clear();
         }
@@ -31,6 +31,8 @@
 
 #include <boost/spirit/home/x3.hpp>
 
+#include <sk/config/detail/parser/expect.hxx>
+
 namespace sk::config {
 
     struct parser_policy_tag {};
@@ -62,14 +64,29 @@ namespace sk::config {
         // Whether to accept braced lists, { val; val; val...; }
         static constexpr bool allow_braced_lists = true;
 
+        // Whether to accept include statements, `include "file";`
+        static constexpr bool allow_include = false;
+
         /*
          * The parser to confix a braced element.
          */
         static constexpr auto braced(auto const& v) {
-            return '{' > v > '}';
+            using detail::parser::expect;
+            return '{' >> expect[v] >> expect['}'];
         }
     };
 
 }; // namespace sk::config
 
+namespace sk::config::detail {
+
+    // The parser policy in effect in Context.
+    template <typename Context>
+    using policy_of = std::remove_cvref_t<decltype(boost::spirit::x3::get<
+                                                   parser_policy_tag>(
+                                                   std::declval<Context>())
+                                                       .get())>;
+
+} // namespace sk::config::detail
+
 #endif // SK_CONFIG_PARSER_POLICY_HXX_INCLUDED
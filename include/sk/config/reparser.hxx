@@ -0,0 +1,551 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_REPARSER_HXX_INCLUDED
+#define SK_CONFIG_REPARSER_HXX_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+#include <boost/spirit/home/x3/support/utility/utf8.hpp>
+
+#include <sk/config/detail/freeze.hxx>
+#include <sk/config/detail/mapped_file.hxx>
+#include <sk/config/detail/parallel.hxx>
+#include <sk/config/detail/parser/intern_scope.hxx>
+#include <sk/config/detail/propagate.hxx>
+#include <sk/config/detail/statement_scanner.hxx>
+#include <sk/config/error.hxx>
+#include <sk/config/parse.hxx>
+#include <sk/config/parser_policy.hxx>
+
+namespace sk::config {
+
+    /*
+     * reparser: parse a configuration repeatedly, only parsing the
+     * top-level statements which changed since the last parse.
+     *
+     * The parsed values of each statement are remembered, keyed by the
+     * statement's text.  When the configuration is parsed again, the
+     * remembered values are used for any statement whose text is the same,
+     * and only new or changed statements are given to the parser.
+     *
+     * If ret is the object given to the previous call, it's updated in
+     * place, so the work done depends on the size of the change rather
+     * than the size of the configuration:
+     *
+     * - Named blocks in removed statements are erased from their
+     *   container, and those in new statements are inserted, as long as
+     *   the container can erase by key (std::map, std::unordered_map and
+     *   the flat maps).
+     *
+     * - Any other member is reset and rebuilt from the statements which
+     *   set it, but only if those statements have changed.
+     *
+     * Otherwise, for example if a member can't be reset, or a statement
+     * includes other files, the result is built again from every
+     * statement, as it is the first time.  Either way, removed statements
+     * disappear and duplicate keys are still detected.  ret must not be
+     * changed between calls, except by the reparser.
+     *
+     * Statements which include other files are always parsed again, since
+     * the included files may have changed.
+     *
+     * The statements parsed by one call to parse() intern their strings
+     * in the same table.  A reused statement keeps the strings from the
+     * call which parsed it.
+     *
+     * The grammar should be a config<T>() grammar, and T must be
+     * default-constructible and copyable.  Statements are split at
+     * top-level ';' characters, so the parser policy must use the default
+     * option terminator.
+     */
+    template <typename Grammar, typename T, typename Policy = parser_policy>
+    class reparser {
+      public:
+        explicit reparser(Grammar const &grammar_, std::string filename_ = "")
+            : grammar(grammar_), filename(std::move(filename_)) {}
+
+        /*
+         * Parse text into ret, replacing its previous value.  If there's
+         * an error, ret isn't changed and parse_error is thrown.
+         */
+        void parse(std::string_view text, T &ret) {
+            auto spans = split(text);
+
+            // Find the statements we've already parsed.
+            std::vector<statement_ptr> stmts(spans.size());
+            std::vector<std::size_t> todo;
+
+            for (std::size_t i = 0; i < spans.size(); ++i) {
+                auto it = statements.find(spans[i].text);
+                if (it != statements.end())
+                    stmts[i] = it->second;
+                else
+                    todo.push_back(i);
+            }
+
+            // Parse the rest.  Their strings are interned in one table.
+            auto lines = line_numbers(text, spans, todo);
+            std::vector<std::exception_ptr> errors(todo.size());
+            detail::lazy_intern_table strings;
+
+            detail::parallel_for(todo.size(), [&](std::size_t n) {
+                auto i = todo[n];
+                try {
+                    stmts[i] = parse_statement(spans[i], lines[n], strings);
+                } catch (...) {
+                    errors[n] = std::current_exception();
+                }
+            });
+
+            for (auto &&e : errors)
+                if (e)
+                    std::rethrow_exception(e);
+
+            // Update the previous result, or build a new one.
+            auto [removed, added] = changes(stmts);
+
+            last_updated = &ret == target && update(ret, stmts, removed, added);
+            if (!last_updated) {
+                T result{};
+                build(result, stmts, [&](std::size_t i) {
+                    return line_numbers(text, spans, {i})[0];
+                });
+                ret = std::move(result);
+            }
+
+            // Remember the statements for next time.
+            for (auto const *s : removed)
+                if (auto it = statements.find(s->key());
+                    it != statements.end() && it->second.get() == s)
+                    statements.erase(it);
+
+            for (auto i : added)
+                if (stmts[i]->reusable())
+                    statements.emplace(stmts[i]->key(), stmts[i]);
+
+            order = std::move(stmts);
+            target = &ret;
+            last_parsed = todo.size();
+            last_reused = spans.size() - todo.size();
+        }
+
+        /*
+         * Parse a file into ret, as parse().
+         */
+        void parse_file(std::filesystem::path const &path, T &ret) {
+            std::optional<detail::mapped_file> file;
+            try {
+                file.emplace(path);
+            } catch (std::system_error const &e) {
+                throw detail::make_file_error(path, e);
+            }
+
+            filename = boost::spirit::x3::to_utf8(path.native());
+            parse(std::string_view(file->data(), file->size()), ret);
+        }
+
+        // The number of statements parsed by the last call to parse().
+        auto parsed() const -> std::size_t {
+            return last_parsed;
+        }
+
+        // The number of statements reused by the last call to parse().
+        auto reused() const -> std::size_t {
+            return last_reused;
+        }
+
+        /*
+         * Returns true if the last call to parse() updated the previous
+         * result in place, rather than building a new one.
+         */
+        auto updated() const -> bool {
+            return last_updated;
+        }
+
+        // Forget all remembered statements.
+        void clear() {
+            statements.clear();
+            order.clear();
+            target = nullptr;
+        }
+
+      private:
+        /*
+         * When a statement starts in the middle of a line, we keep up to
+         * this much of the line before it so errors can show the whole
+         * line.
+         */
+        static constexpr std::size_t max_context = 256;
+
+        // A statement in the input, preceded by the start of its line.
+        struct span {
+            std::string_view text;
+            std::size_t prefix;
+        };
+
+        using log_type = detail::deferred_log<T>;
+        using undo = typename log_type::undo;
+
+        // A parsed statement.
+        struct statement {
+            std::string text;
+            std::size_t prefix;
+            std::optional<log_type> log;
+
+            // The assignments in the log, and the members they assign.
+            std::vector<typename log_type::assignment> assignments;
+            std::vector<std::size_t> members;
+
+            // Used by changes() while comparing two parses.
+            mutable std::ptrdiff_t uses = 0;
+
+            auto key() const -> std::string_view {
+                return text;
+            }
+
+            auto reusable() const -> bool {
+                return !log->has_calls();
+            }
+
+            // Returns true if the statement sets member in a way that can
+            // be undone by resetting the member.
+            auto resets(std::size_t member) const -> bool {
+                return std::ranges::any_of(assignments, [&](auto const &a) {
+                    return a.member == member && a.how != undo::fixed;
+                });
+            }
+
+            template <typename LineFn>
+            void apply(T &ret, detail::freeze_list &list,
+                       std::string const &filename, LineFn line) const {
+                namespace x3 = boost::spirit::x3;
+
+                try {
+                    log->replay_copy(ret, list);
+                } catch (x3::expectation_failure<char const *> const &x) {
+                    std::vector<error_detail> errors;
+                    auto error_handler = detail::error_formatter(
+                        text.data(), text.data() + text.size(),
+                        std::back_inserter(errors), filename, 4, line());
+                    error_handler(x.where(), "expected " + x.which());
+                    throw parse_error("could not parse the entire input",
+                                      errors);
+                }
+            }
+        };
+
+        using statement_ptr = std::shared_ptr<statement const>;
+
+        Grammar grammar;
+        std::string filename;
+        std::unordered_map<std::string_view, statement_ptr> statements;
+
+        // The statements of the last successful parse, in order, and the
+        // object they were parsed into.
+        std::vector<statement_ptr> order;
+        T const *target = nullptr;
+
+        std::size_t last_parsed = 0;
+        std::size_t last_reused = 0;
+        bool last_updated = false;
+
+        // Build a result from every statement.
+        template <typename LineFn>
+        void build(T &result, std::vector<statement_ptr> const &stmts,
+                   LineFn line_of) const {
+            // Freeze the result once every statement has been applied.
+            detail::freeze_list list(result);
+            for (std::size_t i = 0; i < stmts.size(); ++i)
+                stmts[i]->apply(result, list, filename,
+                                [&] { return line_of(i); });
+            list.freeze();
+        }
+
+        using statement_list = std::vector<statement const *>;
+
+        /*
+         * Return the statements in order which aren't in stmts, and the
+         * positions in stmts of the statements which weren't in order.  A
+         * statement which appears more times than before is added once for
+         * each extra time, and likewise for removals.
+         */
+        auto changes(std::vector<statement_ptr> const &stmts) const
+            -> std::pair<statement_list, std::vector<std::size_t>> {
+            for (auto &&s : stmts)
+                ++s->uses;
+            for (auto &&s : order)
+                --s->uses;
+
+            // This leaves every statement's count at zero.
+            statement_list removed;
+            std::vector<std::size_t> added;
+            for (auto &&s : order)
+                if (s->uses < 0) {
+                    removed.push_back(s.get());
+                    ++s->uses;
+                }
+            for (std::size_t i = 0; i < stmts.size(); ++i)
+                if (stmts[i]->uses > 0) {
+                    added.push_back(i);
+                    --stmts[i]->uses;
+                }
+
+            return {std::move(removed), std::move(added)};
+        }
+
+        /*
+         * Update ret, which holds the result of the statements in order,
+         * to the result of the statements in stmts.  Returns false if the
+         * result has to be built from scratch instead, in which case ret
+         * isn't changed.
+         */
+        auto update(T &ret, std::vector<statement_ptr> const &stmts,
+                    statement_list const &removed,
+                    std::vector<std::size_t> const &added) const -> bool {
+            // Calls, such as include statements, can't be undone.
+            auto has_calls = [](statement const *s) {
+                return s->log->has_calls();
+            };
+            if (std::ranges::any_of(removed, has_calls) ||
+                std::ranges::any_of(added, [&](std::size_t i) {
+                    return has_calls(stmts[i].get());
+                }))
+                return false;
+
+            // Members set by anything other than a named block are
+            // rebuilt from scratch, so find those members, and which
+            // statements set them before and after.
+            std::vector<std::size_t> rebuilt;
+            for (auto const *list : {&order, &stmts})
+                for (auto &&s : *list)
+                    for (auto &&a : s->assignments)
+                        if (a.how != undo::keyed)
+                            rebuilt.push_back(a.member);
+
+            std::ranges::sort(rebuilt);
+            auto dups = std::ranges::unique(rebuilt);
+            rebuilt.erase(dups.begin(), dups.end());
+
+            auto is_rebuilt = [&](std::size_t member) {
+                return std::ranges::binary_search(rebuilt, member);
+            };
+
+            using sequences =
+                std::map<std::size_t, std::vector<statement const *>>;
+            auto setters = [&](std::vector<statement_ptr> const &list) {
+                sequences seqs;
+                for (auto &&s : list)
+                    for (auto m : s->members)
+                        if (is_rebuilt(m))
+                            seqs[m].push_back(s.get());
+                return seqs;
+            };
+
+            auto before = setters(order);
+            auto after = setters(stmts);
+
+            // Only rebuild the members whose statements changed.
+            std::vector<std::pair<std::size_t, statement const *>> changed;
+            for (auto m : rebuilt) {
+                auto const &b = before[m];
+                auto const &a = after[m];
+                if (a == b)
+                    continue;
+
+                auto const *s = a.empty() ? b.front() : a.front();
+                if (!s->resets(m))
+                    return false;
+                changed.emplace_back(m, s);
+            }
+
+            auto is_keyed = [&](std::size_t member) {
+                return !is_rebuilt(member);
+            };
+
+            try {
+                detail::freeze_list list(ret);
+
+                for (auto const *s : removed)
+                    s->log->retract_if(ret, is_keyed);
+
+                for (auto &&[m, s] : changed) {
+                    s->log->reset(ret, m);
+                    for (auto const *setter : after[m])
+                        setter->log->replay_copy_if(
+                            ret, list, [m](std::size_t n) { return n == m; });
+                }
+
+                for (auto i : added)
+                    stmts[i]->log->replay_copy_if(ret, list, is_keyed);
+
+                list.freeze();
+                return true;
+            } catch (...) {
+                // Put back the previous result; building the new result
+                // from scratch will report the error.
+                T previous{};
+                build(previous, order, [](std::size_t) {
+                    return std::size_t(1);
+                });
+                ret = std::move(previous);
+                return false;
+            }
+        }
+
+        // Split text into top-level statements.
+        static auto split(std::string_view text) -> std::vector<span> {
+            std::vector<span> spans;
+            detail::statement_scanner scanner;
+
+            auto const *first = text.data();
+            auto const *last = text.data() + text.size();
+            auto const *start = first;
+
+            auto add = [&](char const *end) {
+                auto const *line_start = start;
+                while (line_start != first && line_start[-1] != '\n' &&
+                       line_start[-1] != '\r' &&
+                       static_cast<std::size_t>(start - line_start) <
+                           max_context)
+                    --line_start;
+
+                spans.push_back(
+                    {std::string_view(line_start, end - line_start),
+                     static_cast<std::size_t>(start - line_start)});
+                start = end;
+            };
+
+            while (auto end = scanner.scan(start, last)) {
+                // If the rest of the line is blank, it belongs to this
+                // statement, so the next one starts on a new line.
+                auto const *p = *end;
+                while (p != last && (*p == ' ' || *p == '\t'))
+                    ++p;
+                if (p != last && *p == '\r')
+                    ++p;
+                if (p != last && *p == '\n')
+                    ++p;
+                if (p == last || p[-1] == '\n' || p[-1] == '\r')
+                    *end = p;
+
+                add(*end);
+            }
+
+            if (start != last)
+                add(last);
+
+            return spans;
+        }
+
+        /*
+         * Return the line numbers of the start of the given spans, which
+         * must be in order.  We count lines the same way that
+         * error_formatter does.
+         */
+        static auto line_numbers(std::string_view text,
+                                 std::vector<span> const &spans,
+                                 std::vector<std::size_t> const &which)
+            -> std::vector<std::size_t> {
+            std::vector<std::size_t> lines;
+            lines.reserve(which.size());
+
+            std::size_t line = 1;
+            char prev = 0;
+            auto const *counted = text.data();
+
+            for (auto i : which) {
+                for (; counted != spans[i].text.data(); ++counted) {
+                    char c = *counted;
+                    if (c == '\r' || (c == '\n' && prev != '\r'))
+                        ++line;
+                    prev = c;
+                }
+
+                lines.push_back(line);
+            }
+
+            return lines;
+        }
+
+        auto parse_statement(span const &s, std::size_t line,
+                             detail::lazy_intern_table &strings) const
+            -> statement_ptr {
+            namespace x3 = boost::spirit::x3;
+
+            auto stmt = std::make_shared<statement>();
+            stmt->text = s.text;
+            stmt->prefix = s.prefix;
+
+            T placeholder{};
+            stmt->log.emplace(&placeholder);
+
+            auto const *base = stmt->text.data();
+            auto const grammar_ =
+                x3::with<intern_table_tag>(std::ref(strings))
+                    [x3::with<detail::deferred_tag>(std::ref(*stmt->log))
+                         [grammar]];
+            detail::parse_at<Policy>(base, base + stmt->prefix,
+                                     base + stmt->text.size(), grammar_,
+                                     placeholder, filename, line);
+
+            stmt->assignments = stmt->log->assignments();
+            for (auto &&a : stmt->assignments)
+                stmt->members.push_back(a.member);
+            std::ranges::sort(stmt->members);
+            auto dups = std::ranges::unique(stmt->members);
+            stmt->members.erase(dups.begin(), dups.end());
+            return stmt;
+        }
+    };
+
+    /*
+     * Create a reparser for T, optionally with a non-default parser
+     * policy.
+     */
+    template <typename T, typename Policy = parser_policy, typename Grammar>
+    auto make_reparser(Grammar const &grammar, std::string filename = "") {
+        return reparser<Grammar, T, Policy>(grammar, std::move(filename));
+    }
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_REPARSER_HXX_INCLUDED
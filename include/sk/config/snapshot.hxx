@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_SNAPSHOT_HXX_INCLUDED
+#define SK_CONFIG_SNAPSHOT_HXX_INCLUDED
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <variant>
+
+#include <boost/throw_exception.hpp>
+
+#include <sk/config/error.hxx>
+#include <sk/config/interned_string.hxx>
+
+namespace sk::config {
+
+    // A snapshot couldn't be read.
+    struct snapshot_error : error {
+        snapshot_error(std::string message) : error(std::move(message)) {}
+    };
+
+    /*
+     * snapshot_writer: write values to a binary snapshot.  The format
+     * is only meant to be read back by the same program on the same
+     * machine, so values are written in native byte order.
+     */
+    class snapshot_writer {
+      public:
+        void write_bytes(void const *data, std::size_t size) {
+            buffer.append(static_cast<char const *>(data), size);
+        }
+
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        void write(T const &value) {
+            write_bytes(&value, sizeof(value));
+        }
+
+        void write_size(std::size_t size) {
+            write(static_cast<std::uint64_t>(size));
+        }
+
+        void write_string(std::string_view s) {
+            write_size(s.size());
+            write_bytes(s.data(), s.size());
+        }
+
+        auto data() const -> std::string const & {
+            return buffer;
+        }
+
+      private:
+        std::string buffer;
+    };
+
+    /*
+     * snapshot_reader: read values from a binary snapshot.  If the
+     * snapshot is truncated, snapshot_error is thrown.
+     */
+    class snapshot_reader {
+      public:
+        explicit snapshot_reader(std::string_view data)
+            : first(data.data()), last(data.data() + data.size()) {}
+
+        void read_bytes(void *data, std::size_t size) {
+            if (static_cast<std::size_t>(last - first) < size)
+                boost::throw_exception(snapshot_error("snapshot is truncated"));
+            std::memcpy(data, first, size);
+            first += size;
+        }
+
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        void read(T &value) {
+            read_bytes(&value, sizeof(value));
+        }
+
+        auto read_size() -> std::size_t {
+            std::uint64_t size;
+            read(size);
+
+            // Every element takes at least one byte, so this catches
+            // corrupt sizes before we try to allocate them.
+            if (size > static_cast<std::size_t>(last - first))
+                boost::throw_exception(snapshot_error("snapshot is corrupt"));
+            return static_cast<std::size_t>(size);
+        }
+
+        template <typename Char, typename Traits, typename Alloc>
+        void read_string(std::basic_string<Char, Traits, Alloc> &s) {
+            auto size = read_size();
+
+            // A size which isn't a whole number of characters would
+            // write past the end of the string.
+            if (size % sizeof(Char) != 0)
+                boost::throw_exception(snapshot_error("snapshot is corrupt"));
+
+            s.resize(size / sizeof(Char));
+            read_bytes(s.data(), size);
+        }
+
+        auto at_end() const -> bool {
+            return first == last;
+        }
+
+        // Intern the strings read from the snapshot in table.
+        void set_intern_table(intern_table &table) {
+            strings_ = &table;
+        }
+
+        /*
+         * The table for interned strings read from the snapshot: the one
+         * given to set_intern_table(), or else a table of the snapshot's
+         * own.
+         */
+        auto strings() -> intern_table & {
+            if (!strings_) {
+                own_strings.emplace();
+                strings_ = &**own_strings;
+            }
+            return *strings_;
+        }
+
+      private:
+        char const *first;
+        char const *last;
+        intern_table *strings_ = nullptr;
+        std::optional<shared_intern_table> own_strings;
+    };
+
+    /*
+     * snapshot_traits<T>: how to store a T in a snapshot.  To cache a
+     * configuration which contains a custom type, specialise this with:
+     *
+     *   static void write(snapshot_writer &, T const &);
+     *   static void read(snapshot_reader &, T &);
+     *
+     * Containers, pairs, tuples and variants are handled automatically.
+     */
+    template <typename T> struct snapshot_traits;
+
+    template <typename T>
+        requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    struct snapshot_traits<T> {
+        static void write(snapshot_writer &w, T const &value) {
+            w.write(value);
+        }
+
+        static void read(snapshot_reader &r, T &value) {
+            r.read(value);
+        }
+    };
+
+    template <typename Char, typename Traits, typename Alloc>
+    struct snapshot_traits<std::basic_string<Char, Traits, Alloc>> {
+        static void write(snapshot_writer &w,
+                          std::basic_string<Char, Traits, Alloc> const &s) {
+            w.write_size(s.size() * sizeof(Char));
+            w.write_bytes(s.data(), s.size() * sizeof(Char));
+        }
+
+        static void read(snapshot_reader &r,
+                         std::basic_string<Char, Traits, Alloc> &s) {
+            r.read_string(s);
+        }
+    };
+
+    namespace detail {
+
+        /*
+         * A stable 64-bit hash of some bytes, used to check whether a
+         * snapshot is still valid.  This isn't std::hash because that
+         * can change between runs.
+         */
+        inline auto stable_hash(std::string_view data, std::uint64_t seed = 0)
+            -> std::uint64_t {
+            constexpr std::uint64_t k = 0x9e3779b97f4a7c15ULL;
+
+            std::uint64_t h = seed ^ (data.size() * k);
+            auto const *p = data.data();
+            auto n = data.size();
+
+            auto mix = [&](std::uint64_t w) {
+                w *= k;
+                w ^= w >> 29;
+                h = std::rotl(h ^ w, 27) * k + 0x52dce729;
+            };
+
+            for (; n >= 8; p += 8, n -= 8) {
+                std::uint64_t w;
+                std::memcpy(&w, p, 8);
+                mix(w);
+            }
+
+            if (n > 0) {
+                std::uint64_t w = 0;
+                std::memcpy(&w, p, n);
+                mix(w);
+            }
+
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        // No special handling for this value.
+        struct no_codec {
+            using type = void;
+
+            void fingerprint(std::uint64_t &) const {}
+        };
+
+        template <typename T> struct is_pair : std::false_type {};
+        template <typename T, typename U>
+        struct is_pair<std::pair<T, U>> : std::true_type {};
+
+        template <typename T> struct is_tuple : std::false_type {};
+        template <typename... Ts>
+        struct is_tuple<std::tuple<Ts...>> : std::true_type {};
+
+        template <typename T> struct is_variant : std::false_type {};
+        template <typename... Ts>
+        struct is_variant<std::variant<Ts...>> : std::true_type {};
+
+        template <typename T> struct is_string : std::false_type {};
+        template <typename Char, typename Traits, typename Alloc>
+        struct is_string<std::basic_string<Char, Traits, Alloc>>
+            : std::true_type {};
+
+        template <typename T>
+        concept snapshot_map = requires {
+            typename T::key_type;
+            typename T::mapped_type;
+        };
+
+        template <typename T>
+        concept snapshot_set = !snapshot_map<T> && requires {
+            typename T::key_type;
+            typename T::value_type;
+        };
+
+        template <typename T>
+        concept snapshot_sequence =
+            !is_string<T>::value && !snapshot_map<T> && !snapshot_set<T> &&
+            requires(T &c, typename T::value_type v) {
+                c.push_back(std::move(v));
+            };
+
+        template <typename T, typename Codec>
+        void write_value(snapshot_writer &w, T const &value,
+                         Codec const &codec);
+
+        template <typename T, typename Codec>
+        void read_value(snapshot_reader &r, T &value, Codec const &codec);
+
+        template <std::size_t I, typename... Ts, typename Codec>
+        void read_variant(snapshot_reader &r, std::variant<Ts...> &value,
+                          std::size_t index, Codec const &codec) {
+            if constexpr (I < sizeof...(Ts)) {
+                if (index == I)
+                    read_value(r, value.template emplace<I>(), codec);
+                else
+                    read_variant<I + 1>(r, value, index, codec);
+            } else {
+                boost::throw_exception(snapshot_error("snapshot is corrupt"));
+            }
+        }
+
+        /*
+         * Write a value to a snapshot.  If the value (or an element of it)
+         * is codec's type, codec is used to write it.
+         */
+        template <typename T, typename Codec>
+        void write_value(snapshot_writer &w, T const &value,
+                         Codec const &codec) {
+            if constexpr (std::is_same_v<T, typename Codec::type>) {
+                codec.write(w, value);
+            } else if constexpr (is_pair<T>::value) {
+                write_value(w, value.first, codec);
+                write_value(w, value.second, codec);
+            } else if constexpr (is_tuple<T>::value) {
+                std::apply(
+                    [&](auto const &...v) { (write_value(w, v, codec), ...); },
+                    value);
+            } else if constexpr (is_variant<T>::value) {
+                w.write_size(value.index());
+                std::visit([&](auto const &v) { write_value(w, v, codec); },
+                           value);
+            } else if constexpr (snapshot_map<T>) {
+                w.write_size(value.size());
+                for (auto &&[k, v] : value) {
+                    write_value(w, k, codec);
+                    write_value(w, v, codec);
+                }
+            } else if constexpr (snapshot_set<T> || snapshot_sequence<T>) {
+                w.write_size(value.size());
+                for (auto &&v : value)
+                    write_value(w, v, codec);
+            } else {
+                snapshot_traits<T>::write(w, value);
+            }
+        }
+
+        // Read a value written by write_value().
+        template <typename T, typename Codec>
+        void read_value(snapshot_reader &r, T &value, Codec const &codec) {
+            if constexpr (std::is_same_v<T, typename Codec::type>) {
+                codec.read(r, value);
+            } else if constexpr (is_pair<T>::value) {
+                read_value(r, value.first, codec);
+                read_value(r, value.second, codec);
+            } else if constexpr (is_tuple<T>::value) {
+                std::apply([&](auto &...v) { (read_value(r, v, codec), ...); },
+                           value);
+            } else if constexpr (is_variant<T>::value) {
+                read_variant<0>(r, value, r.read_size(), codec);
+            } else if constexpr (snapshot_map<T>) {
+                value.clear();
+                auto size = r.read_size();
+                for (std::size_t i = 0; i < size; ++i) {
+                    typename T::key_type k{};
+                    typename T::mapped_type v{};
+                    read_value(r, k, codec);
+                    read_value(r, v, codec);
+                    value.emplace(std::move(k), std::move(v));
+                }
+
+                // A frozen_map is frozen once it's complete.
+                if constexpr (requires { value.freeze(); })
+                    value.freeze();
+            } else if constexpr (snapshot_set<T>) {
+                value.clear();
+                auto size = r.read_size();
+                for (std::size_t i = 0; i < size; ++i) {
+                    typename T::value_type v{};
+                    read_value(r, v, codec);
+                    value.insert(std::move(v));
+                }
+            } else if constexpr (snapshot_sequence<T>) {
+                value.clear();
+                auto size = r.read_size();
+                for (std::size_t i = 0; i < size; ++i) {
+                    typename T::value_type v{};
+                    read_value(r, v, codec);
+                    value.push_back(std::move(v));
+                }
+            } else {
+                snapshot_traits<T>::read(r, value);
+            }
+        }
+
+        template <typename T> auto label_string(T const &label) -> std::string {
+            if constexpr (std::is_convertible_v<T const &, std::string_view>)
+                return std::string(std::string_view(label));
+            else
+                return {};
+        }
+
+        /*
+         * member_entry: a member of a struct set by an option or block,
+         * and the codec for any structs it contains.
+         */
+        template <typename T, typename V, typename Codec = no_codec>
+        struct member_entry {
+            V T::*member;
+            Codec codec;
+            std::string label;
+
+            void write(snapshot_writer &w, T const &value) const {
+                write_value(w, value.*member, codec);
+            }
+
+            void read(snapshot_reader &r, T &value) const {
+                read_value(r, value.*member, codec);
+            }
+
+            void fingerprint(std::uint64_t &h) const {
+                h = stable_hash(label, h);
+                h = stable_hash(typeid(V).name(), h);
+                codec.fingerprint(h);
+            }
+        };
+
+        // A member parser which we don't know how to store.
+        struct unknown_entry {
+            template <typename T>
+            void write(snapshot_writer &, T const &) const {
+                static_assert(sizeof(T) == 0,
+                              "this grammar contains a parser which isn't an "
+                              "option() or a block(), so it can't be cached");
+            }
+
+            template <typename T> void read(snapshot_reader &, T &) const {}
+
+            void fingerprint(std::uint64_t &) const {}
+        };
+
+        /*
+         * struct_codec: store a struct by storing each of the members set
+         * by its grammar.
+         */
+        template <typename T, typename... Entries> struct struct_codec {
+            using type = T;
+
+            std::tuple<Entries...> entries;
+
+            void write(snapshot_writer &w, T const &value) const {
+                std::apply([&](auto const &...e) { (e.write(w, value), ...); },
+                           entries);
+            }
+
+            void read(snapshot_reader &r, T &value) const {
+                std::apply([&](auto const &...e) { (e.read(r, value), ...); },
+                           entries);
+            }
+
+            void fingerprint(std::uint64_t &h) const {
+                h = stable_hash(typeid(T).name(), h);
+                std::apply([&](auto const &...e) { (e.fingerprint(h), ...); },
+                           entries);
+            }
+        };
+
+    } // namespace detail
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_SNAPSHOT_HXX_INCLUDED
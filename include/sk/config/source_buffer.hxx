@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_SOURCE_BUFFER_HXX_INCLUDED
+#define SK_CONFIG_SOURCE_BUFFER_HXX_INCLUDED
+
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <boost/spirit/home/x3/support/utility/utf8.hpp>
+
+#include <sk/config/detail/mapped_file.hxx>
+
+namespace sk::config {
+
+    struct source_buffer_tag {};
+
+    /*
+     * source_buffer: the text of a configuration, kept alive after parsing
+     * so that parsed values can refer to it.
+     *
+     * When a configuration is parsed from a source_buffer, std::string_view
+     * members are set to point directly into the buffer instead of being
+     * copied.  Strings which contain escapes have to be unescaped, and
+     * these are stored in the buffer as well.
+     *
+     * The source_buffer must outlive any object which was parsed from it.
+     */
+    class source_buffer {
+      public:
+        explicit source_buffer(std::string text_, std::string filename_ = "")
+            : text(std::move(text_)), first(text.data()),
+              last(text.data() + text.size()), filename(std::move(filename_)) {}
+
+        // Load a file; the file is mapped into memory if possible.
+        static auto from_file(std::filesystem::path const &path)
+            -> source_buffer {
+            return source_buffer(file_tag{}, path);
+        }
+
+        source_buffer(source_buffer const &) = delete;
+        source_buffer &operator=(source_buffer const &) = delete;
+
+        auto begin() const -> char const * {
+            return first;
+        }
+
+        auto end() const -> char const * {
+            return last;
+        }
+
+        auto size() const -> std::size_t {
+            return static_cast<std::size_t>(last - first);
+        }
+
+        auto name() const -> std::string const & {
+            return filename;
+        }
+
+        /*
+         * Take ownership of a string which isn't part of the source text,
+         * and return a view of it which lives as long as the buffer.
+         */
+        auto store(std::string s) -> std::string_view {
+            return strings.emplace_back(std::move(s));
+        }
+
+      private:
+        struct file_tag {};
+
+        source_buffer(file_tag, std::filesystem::path const &path)
+            : file(std::make_unique<detail::mapped_file>(path)),
+              first(file->begin()), last(file->end()),
+              filename(boost::spirit::x3::to_utf8(path.native())) {}
+
+        std::string text;
+        std::unique_ptr<detail::mapped_file> file;
+        char const *first;
+        char const *last;
+        std::string filename;
+
+        // Unescaped strings.  This is a deque because it never moves its
+        // elements, so views of them remain valid.
+        std::deque<std::string> strings;
+    };
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_SOURCE_BUFFER_HXX_INCLUDED
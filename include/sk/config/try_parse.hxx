@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SK_CONFIG_TRY_PARSE_HXX_INCLUDED
+#define SK_CONFIG_TRY_PARSE_HXX_INCLUDED
+
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <sk/config/detail/error_formatter.hxx>
+#include <sk/config/detail/parser/comment.hxx>
+#include <sk/config/detail/parser/expect.hxx>
+#include <sk/config/error.hxx>
+#include <sk/config/parser_policy.hxx>
+
+namespace sk::config {
+
+    /*
+     * parse_result: the result of try_parse().  Like
+     * std::expected<void, std::vector<error_detail>>, it converts to true
+     * if the input was parsed, and otherwise error() returns the errors.
+     */
+    class parse_result {
+      public:
+        parse_result() = default;
+
+        explicit parse_result(std::vector<error_detail> errors_)
+            : errors(std::move(errors_)), ok(false) {}
+
+        auto has_value() const -> bool {
+            return ok;
+        }
+
+        explicit operator bool() const {
+            return ok;
+        }
+
+        auto error() const & -> std::vector<error_detail> const & {
+            return errors;
+        }
+
+        auto error() && -> std::vector<error_detail> {
+            return std::move(errors);
+        }
+
+      private:
+        std::vector<error_detail> errors;
+        bool ok = true;
+    };
+
+    namespace detail {
+
+        /*
+         * The same as parse_at(), but errors are returned instead of
+         * thrown.
+         */
+        template <typename Policy, typename Iterator>
+        auto try_parse_at(Iterator begin, Iterator first, Iterator last,
+                          auto const &grammar, auto &ret,
+                          std::string const &filename, std::size_t first_line)
+            -> parse_result {
+            namespace x3 = boost::spirit::x3;
+
+            std::vector<error_detail> errors;
+            auto error_handler =
+                error_formatter(begin, last, std::back_inserter(errors),
+                                filename, 4, first_line);
+
+            Policy policy;
+            parser::no_throw_state state;
+            auto const grammar_ = x3::with<parser_policy_tag>(std::ref(
+                policy))[x3::with<x3::error_handler_tag>(std::ref(
+                error_handler))[x3::with<parser::no_throw_tag>(
+                std::ref(state))[grammar]]];
+
+            bool r = false;
+
+#ifdef BOOST_NO_EXCEPTIONS
+            r = x3::phrase_parse(first, last, grammar_, parser::comment, ret);
+#else
+            // Our own parsers don't throw, but include statements and
+            // user-supplied parsers can.
+            try {
+                r = x3::phrase_parse(first, last, grammar_, parser::comment,
+                                     ret);
+            } catch (parse_error const &e) {
+                errors.insert(errors.end(), e.errors.begin(), e.errors.end());
+            } catch (x3::expectation_failure<Iterator> const &x) {
+                error_handler(x.where(), "expected " + x.which());
+            }
+#endif
+
+            if (r && !state.failed && first == last)
+                return {};
+
+            if (errors.empty())
+                errors.push_back(error_handler.format(
+                    first, "could not parse the entire input"));
+            return parse_result(std::move(errors));
+        }
+
+    } // namespace detail
+
+    /*
+     * Parse the input like parse(), but return the errors rather than
+     * throwing parse_error.  Expectation failures are reported to the
+     * error handler directly instead of being thrown and caught, so an
+     * invalid input is as cheap to reject as a valid one is to parse.
+     */
+    template <typename Policy = parser_policy, typename Iterator>
+    auto try_parse(Iterator first, Iterator last, auto const &grammar,
+                   auto &ret, std::string const &filename = "")
+        -> parse_result {
+        return detail::try_parse_at<Policy>(first, first, last, grammar, ret,
+                                            filename, 1);
+    }
+
+    template <typename Policy = parser_policy>
+    auto try_parse(std::ranges::range auto const &r, auto const &grammar,
+                   auto &ret, std::string const &filename = "")
+        -> parse_result {
+        return try_parse<Policy>(std::ranges::begin(r), std::ranges::end(r),
+                                 grammar, ret, filename);
+    }
+
+    template <typename Policy = parser_policy>
+    auto try_parse(char const *s, auto const &grammar, auto &ret,
+                   std::string const &filename = "") -> parse_result {
+        return try_parse<Policy>(std::string_view(s), grammar, ret, filename);
+    }
+
+} // namespace sk::config
+
+#endif // SK_CONFIG_TRY_PARSE_HXX_INCLUDED
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * sk-config-core: the built-in parsers, compiled once for the context
+ * which parse() uses for char const * input with the default policy.
+ * Translation units built with SK_CONFIG_SEPARATE_COMPILATION see these
+ * as extern templates and don't instantiate them again.
+ */
+
+#ifndef SK_CONFIG_SEPARATE_COMPILATION
+#    error sk-config-core must be built with SK_CONFIG_SEPARATE_COMPILATION
+#endif
+
+#include <sk/config/detail/parser/compiled.hxx>
+
+namespace sk::config::detail::parser {
+
+    template bool parse_compiled<compiled_string>(
+        char const *&, char const *, parser_policy const &,
+        compiled_string::attribute_type &);
+    template bool parse_compiled<bool_parser>(
+        char const *&, char const *, parser_policy const &,
+        bool_parser::attribute_type &);
+    template bool parse_compiled<number_parser<int>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<int>::attribute_type &);
+    template bool parse_compiled<number_parser<unsigned>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<unsigned>::attribute_type &);
+    template bool parse_compiled<number_parser<long>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<long>::attribute_type &);
+    template bool parse_compiled<number_parser<unsigned long>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<unsigned long>::attribute_type &);
+    template bool parse_compiled<number_parser<long long>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<long long>::attribute_type &);
+    template bool parse_compiled<number_parser<unsigned long long>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<unsigned long long>::attribute_type &);
+    template bool parse_compiled<number_parser<float>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<float>::attribute_type &);
+    template bool parse_compiled<number_parser<double>>(
+        char const *&, char const *, parser_policy const &,
+        number_parser<double>::attribute_type &);
+    template bool parse_compiled<vector<compiled_string>>(
+        char const *&, char const *, parser_policy const &,
+        vector<compiled_string>::attribute_type &);
+    template bool parse_compiled<vector<number_parser<int>>>(
+        char const *&, char const *, parser_policy const &,
+        vector<number_parser<int>>::attribute_type &);
+    template bool parse_compiled<vector<number_parser<unsigned>>>(
+        char const *&, char const *, parser_policy const &,
+        vector<number_parser<unsigned>>::attribute_type &);
+    template bool parse_compiled<vector<number_parser<double>>>(
+        char const *&, char const *, parser_policy const &,
+        vector<number_parser<double>>::attribute_type &);
+    template bool parse_compiled<compiled_string_map>(
+        char const *&, char const *, parser_policy const &,
+        compiled_string_map::attribute_type &);
+    template bool parse_compiled<compiled_int_map>(
+        char const *&, char const *, parser_policy const &,
+        compiled_int_map::attribute_type &);
+
+} // namespace sk::config::detail::parser
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * C++20 module interface for sk::config: `import sk.config;` instead of
+ * #include <sk/config.hxx>.  This is a wrapper around the headers, so
+ * macros such as SK_CONFIG_SEPARATE_COMPILATION must be the same for the
+ * module and the code which imports it.
+ */
+
+module;
+
+#include <sk/config.hxx>
+
+export module sk.config;
+
+export namespace sk::config {
+
+    // Grammar
+    using sk::config::block;
+    using sk::config::config;
+    using sk::config::option;
+    using sk::config::parser_for;
+    using sk::config::parser_policy;
+    using sk::config::parser_policy_tag;
+
+    // Parsing
+    using sk::config::parse;
+    using sk::config::parse_directory;
+    using sk::config::parse_file;
+    using sk::config::parse_file_cached;
+    using sk::config::parse_file_parallel;
+    using sk::config::parse_files;
+    using sk::config::parse_parallel;
+    using sk::config::parse_result;
+    using sk::config::try_parse;
+
+    using sk::config::include_cache;
+    using sk::config::incremental_parser;
+    using sk::config::make_incremental_parser;
+    using sk::config::make_reparser;
+    using sk::config::reparser;
+    using sk::config::source_buffer;
+    using sk::config::source_buffer_tag;
+
+    using sk::config::live;
+    using sk::config::live_metrics;
+    using sk::config::live_options;
+
+    using sk::config::snapshot_error;
+    using sk::config::snapshot_reader;
+    using sk::config::snapshot_traits;
+    using sk::config::snapshot_writer;
+
+    // Value types
+    using sk::config::frozen_hash;
+    using sk::config::frozen_map;
+    using sk::config::intern_table;
+    using sk::config::intern_table_tag;
+    using sk::config::interned_string;
+    using sk::config::shared_intern_table;
+    using sk::config::with_intern_table;
+
+    // Errors
+    using sk::config::error;
+    using sk::config::error_detail;
+    using sk::config::file_error;
+    using sk::config::parse_error;
+    using sk::config::parser_error_handler;
+    using sk::config::operator<<;
+
+} // namespace sk::config
+
+export namespace sk::config::parser {
+
+    using sk::config::parser::any_string_parser;
+    using sk::config::parser::interned_string_parser;
+    using sk::config::parser::string_view_parser;
+    using sk::config::parser::tuple_parser;
+
+} // namespace sk::config::parser
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <catch.hpp>
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    // Return the input which remains after skipping.
+    auto skip(std::string_view input) -> std::string_view {
+        namespace x3 = boost::spirit::x3;
+
+        auto first = input.begin();
+        auto const context = x3::make_context<x3::skipper_tag>(
+            sk::config::detail::parser::comment);
+        x3::skip_over(first, input.end(), context);
+        return {first, input.end()};
+    }
+
+    // The same, for an iterator which isn't contiguous.
+    auto skip_list(std::string_view input) -> std::string {
+        namespace x3 = boost::spirit::x3;
+
+        std::list<char> chars(input.begin(), input.end());
+        auto first = chars.begin();
+        auto const context = x3::make_context<x3::skipper_tag>(
+            sk::config::detail::parser::comment);
+        x3::skip_over(first, chars.end(), context);
+        return {first, chars.end()};
+    }
+
+} // namespace
+
+TEST_CASE("comment skipper") {
+    auto check = [](std::string_view input, std::string_view rest) {
+        REQUIRE(skip(input) == rest);
+        REQUIRE(skip_list(input) == rest);
+    };
+
+    check("", "");
+    check("  \t\r\n\v\fa", "a");
+    check("# comment\na", "a");
+    check("# comment\r\na", "a");
+    check("# comment\ra", "a");
+    check("# one\n  # two\n\na", "a");
+    check("/* comment */a", "a");
+    check("/* multi\nline ** comment **/ a", "a");
+    check("/**/a", "a");
+    check("/*/ a */a", "a");
+    check(" /* one */ # two\n /* three */ a", "a");
+    check("a # comment\n", "a # comment\n");
+    check("/a", "/a");
+
+    // Unterminated comments are left for the parser.
+    check("  # comment", "# comment");
+    check("  /* comment", "/* comment");
+    check("  /* comment *", "/* comment *");
+    check("/*/", "/*/");
+}
+
+TEST_CASE("comments in a configuration") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        std::vector<int> numbers;
+    };
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("number", &test_config::numbers));
+
+    test_config c;
+    cfg::parse("# leading\nnumber /* inline */ 1;/**/number\t2; # x\n"
+               "/* trailing */",
+               grammar, c);
+    REQUIRE(c.numbers == std::vector{1, 2});
+}
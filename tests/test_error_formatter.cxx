@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <catch.hpp>
+
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sk/config/detail/error_formatter.hxx>
+
+namespace {
+
+    auto format_at(std::string_view input, std::size_t offset,
+                   std::size_t first_line = 1) -> sk::config::error_detail {
+        std::vector<sk::config::error_detail> errors;
+        sk::config::detail::error_formatter formatter(
+            input.begin(), input.end(), std::back_inserter(errors), "test", 4,
+            first_line);
+        return formatter.format(input.begin() + offset, "error");
+    }
+
+} // namespace
+
+TEST_CASE("error_formatter line and column") {
+    auto check = [](std::string_view input, std::size_t offset,
+                    std::size_t line, std::size_t column,
+                    std::string_view context) {
+        auto err = format_at(input, offset);
+        REQUIRE(err.file == "test");
+        REQUIRE(err.message == "error");
+        REQUIRE(err.line == line);
+        REQUIRE(err.column == column);
+        REQUIRE(err.context == context);
+    };
+
+    check("abc", 0, 1, 0, "abc");
+    check("abc", 2, 1, 2, "abc");
+    check("a\nbcd\nef", 3, 2, 1, "bcd");
+    check("a\nbcd\nef", 6, 3, 0, "ef");
+    check("a\r\nbcd\r\nef", 5, 2, 2, "bcd");
+    check("a\r\nbcd\r\nef", 8, 3, 0, "ef");
+    check("a\rbcd\ref", 2, 2, 0, "bcd");
+    check("a\n\n\r\n\rb", 6, 5, 0, "b");
+    check("\nabc", 2, 2, 1, "abc");
+
+    // Whitespace before the error is skipped.
+    check("a\n  \n  b", 2, 3, 2, "  b");
+}
+
+TEST_CASE("error_formatter first line") {
+    auto err = format_at("x;\ny;", 3, 10);
+    REQUIRE(err.line == 11);
+    REQUIRE(err.column == 0);
+    REQUIRE(err.context == "y;");
+}
+
+TEST_CASE("error_formatter many errors") {
+    std::string input;
+    for (int i = 0; i < 10000; ++i)
+        input += "line " + std::to_string(i) + "\n";
+
+    std::vector<sk::config::error_detail> errors;
+    sk::config::detail::error_formatter formatter(
+        input.cbegin(), input.cend(), std::back_inserter(errors));
+
+    for (std::size_t i = 0, pos = 0; i < 10000; ++i) {
+        formatter(input.cbegin() + static_cast<std::ptrdiff_t>(pos), "error");
+        pos = input.find('\n', pos) + 1;
+    }
+
+    REQUIRE(errors.size() == 10000);
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        REQUIRE(errors[i].line == i + 1);
+        REQUIRE(errors[i].context == "line " + std::to_string(i));
+    }
+}
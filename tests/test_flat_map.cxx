@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <map>
+#include <string>
+
+#include <boost/container/flat_map.hpp>
+
+#include <sk/config/block.hxx>
+#include <sk/config/config.hxx>
+#include <sk/config/option.hxx>
+#include <sk/config/parse.hxx>
+#include <sk/config/parser/flat_map.hxx>
+#include <sk/config/parser/map.hxx>
+#include <sk/config/parser/numeric.hxx>
+#include <sk/config/parser/string.hxx>
+
+TEST_CASE("boost::container::flat_map<>") {
+    namespace cfg = sk::config;
+
+    struct test_block {
+        std::string name;
+        int value;
+    };
+
+    struct test_config {
+        boost::container::flat_map<std::string, test_block> items;
+    };
+
+    auto grammar =                                                     //
+        cfg::config<test_config>(                                      //
+            cfg::block("item", &test_block::name, &test_config::items, //
+                       cfg::option("value", &test_block::value)));
+    test_config c;
+
+    cfg::parse(R"(
+item "one" { value 1; };
+item "forty-two" { value 42; };
+item "two" { value 2; };
+)",
+               grammar, c);
+
+    REQUIRE(c.items.size() == 3);
+    REQUIRE(c.items["one"].value == 1);
+    REQUIRE(c.items["two"].value == 2);
+    REQUIRE(c.items["forty-two"].value == 42);
+    REQUIRE(c.items.begin()->first == "forty-two");
+}
+
+TEST_CASE("boost::container::flat_map<> duplicate value") {
+    namespace cfg = sk::config;
+
+    struct test_block {
+        std::string name;
+        int value;
+    };
+
+    struct test_config {
+        boost::container::flat_map<std::string, test_block> items;
+    };
+
+    auto grammar =                                                     //
+        cfg::config<test_config>(                                      //
+            cfg::block("item", &test_block::name, &test_config::items, //
+                       cfg::option("value", &test_block::value)));
+    test_config c;
+
+    REQUIRE_THROWS(cfg::parse(R"(
+item "one" { value 1; };
+item "one" { value 42; };
+)",
+                              grammar, c));
+}
+
+TEST_CASE("boost::container::flat_map<> with many blocks") {
+    namespace cfg = sk::config;
+
+    struct test_block {
+        int name = 0;
+        int value = 0;
+    };
+
+    struct test_config {
+        boost::container::flat_map<int, test_block> items;
+    };
+
+    auto grammar =                                                     //
+        cfg::config<test_config>(                                      //
+            cfg::block("item", &test_block::name, &test_config::items, //
+                       cfg::option("value", &test_block::value)));
+
+    // Blocks out of order, added to what's already in the map.
+    std::string input;
+    for (int i = 0; i < 20000; ++i) {
+        auto key = (i * 7919 % 20000) * 2 + 1;
+        input += "item " + std::to_string(key) + " { value " +
+                 std::to_string(-key) + "; };\n";
+    }
+
+    test_config c;
+    for (int i = 0; i < 40000; i += 2)
+        c.items[i].value = -i;
+
+    cfg::parse(input, grammar, c);
+
+    REQUIRE(c.items.size() == 40000);
+    for (int i = 0; i < 40000; ++i) {
+        REQUIRE(c.items.nth(i)->first == i);
+        REQUIRE(c.items.nth(i)->second.value == -i);
+    }
+}
+
+TEST_CASE("boost::container::flat_map<> reports a duplicate block") {
+    namespace cfg = sk::config;
+
+    struct test_block {
+        std::string name;
+        int value;
+    };
+
+    struct test_config {
+        boost::container::flat_map<std::string, test_block> items;
+    };
+
+    auto grammar =                                                     //
+        cfg::config<test_config>(                                      //
+            cfg::block("item", &test_block::name, &test_config::items, //
+                       cfg::option("value", &test_block::value)));
+
+    auto check = [&](test_config c, std::string const &input,
+                     std::size_t line, std::size_t column) {
+        try {
+            cfg::parse(input, grammar, c);
+            FAIL("no exception");
+        } catch (cfg::parse_error const &e) {
+            REQUIRE(e.errors.at(0).message == "expected unique value");
+            REQUIRE(e.errors.at(0).line == line);
+            REQUIRE(e.errors.at(0).column == column);
+        }
+    };
+
+    // The error is reported at the end of the duplicate block.
+    check({},
+          "item c { value 1; };\nitem a { value 2; };\n"
+          "item c { value 3; }; item d { value 4; };\n",
+          3, 21);
+
+    test_config c;
+    c.items["b"].value = 1;
+    check(c,
+          "item a { value 1; };\n"
+          "item b { value 2; }; item d { value 3; };\n",
+          2, 21);
+}
+
+TEST_CASE("boost::container::flat_map<string,int>") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        boost::container::flat_map<std::string, int> items;
+    };
+
+    auto grammar =                //
+        cfg::config<test_config>( //
+            cfg::option("items", &test_config::items));
+
+    test_config c;
+
+    cfg::parse(R"(
+items {
+    one 1;
+    three 3;
+    forty-two 42;
+};
+)",
+               grammar, c);
+
+    REQUIRE(c.items.size() == 3);
+    REQUIRE(c.items["one"] == 1);
+    REQUIRE(c.items["three"] == 3);
+    REQUIRE(c.items["forty-two"] == 42);
+}
+
+TEST_CASE("boost::container::flat_map<string,map<string,int>>") {
+    namespace cfg = sk::config;
+
+    // The parsed value type isn't the map's own value type.
+    struct test_config {
+        boost::container::flat_map<std::string,
+                                   std::map<std::string, int>>
+            items;
+    };
+
+    auto grammar =                //
+        cfg::config<test_config>( //
+            cfg::option("items", &test_config::items));
+
+    test_config c;
+
+    cfg::parse(R"(
+items {
+    b { x 1; y 2; };
+    a { z 3; };
+};
+)",
+               grammar, c);
+
+    REQUIRE(c.items.size() == 2);
+    REQUIRE(c.items["a"].at("z") == 3);
+    REQUIRE(c.items["b"].at("x") == 1);
+    REQUIRE(c.items["b"].at("y") == 2);
+}
+
+TEST_CASE("boost::container::flat_map<int,int> with many values") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        boost::container::flat_map<int, int> items;
+    };
+
+    auto grammar =                //
+        cfg::config<test_config>( //
+            cfg::option("items", &test_config::items));
+
+    // Keys out of order, over several options which overlap in range.
+    std::string input;
+    for (int i = 0; i < 3; ++i) {
+        input += "items {\n";
+        for (int j = 0; j < 10000; ++j) {
+            auto key = (j * 7919 % 10000) * 3 + i;
+            input += std::to_string(key) + " " + std::to_string(-key) + ";\n";
+        }
+        input += "};\n";
+    }
+
+    test_config c;
+    cfg::parse(input, grammar, c);
+
+    REQUIRE(c.items.size() == 30000);
+    for (int i = 0; i < 30000; ++i)
+        REQUIRE(c.items.nth(i)->second == -i);
+}
+
+TEST_CASE("boost::container::flat_map<int,int> reports a duplicate key") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        boost::container::flat_map<int, int> items;
+    };
+
+    auto grammar =                //
+        cfg::config<test_config>( //
+            cfg::option("items", &test_config::items));
+
+    // The error is reported at the end of the option's value.
+    auto check = [&](std::string const &input, std::size_t line,
+                     std::size_t column) {
+        test_config c;
+        try {
+            cfg::parse(input, grammar, c);
+            FAIL("no exception");
+        } catch (cfg::parse_error const &e) {
+            REQUIRE(e.errors.at(0).message == "expected a block");
+            REQUIRE(e.errors.at(0).line == line);
+            REQUIRE(e.errors.at(0).column == column);
+        }
+    };
+
+    check("items { 1 1; };\nitems { 3 3; 2 2; 3 4; };\n", 2, 24);
+    check("items { 1 1; 2 2; };\nitems { 3 3; 2 4; };\n", 2, 19);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <string>
+
+#include <boost/container/flat_set.hpp>
+
+#include <sk/config/config.hxx>
+#include <sk/config/option.hxx>
+#include <sk/config/parse.hxx>
+#include <sk/config/parser/flat_set.hxx>
+#include <sk/config/parser/numeric.hxx>
+#include <sk/config/parser/string.hxx>
+
+TEST_CASE("boost::container::flat_set<int>") {
+    namespace cr = sk::config;
+
+    struct test_config {
+        boost::container::flat_set<int> items;
+    };
+
+    auto grammar =
+        cr::config<test_config>(cr::option("int-value", &test_config::items));
+    test_config c;
+
+    sk::config::parse(R"(
+int-value 42, 1;
+int-value 666, 7;
+)",
+                      grammar, c);
+
+    REQUIRE(c.items.size() == 4);
+    REQUIRE(c.items.contains(1));
+    REQUIRE(c.items.contains(7));
+    REQUIRE(c.items.contains(42));
+    REQUIRE(c.items.contains(666));
+}
+
+TEST_CASE("boost::container::flat_set<std::string>") {
+    namespace cr = sk::config;
+
+    struct test_config {
+        boost::container::flat_set<std::string> items;
+    };
+
+    auto grammar =
+        cr::config<test_config>(cr::option("value", &test_config::items));
+    test_config c;
+
+    sk::config::parse("value \"b\", \"c\", \"a\";", grammar, c);
+
+    REQUIRE(c.items.size() == 3);
+    REQUIRE(*c.items.begin() == "a");
+    REQUIRE(*c.items.rbegin() == "c");
+}
+
+TEST_CASE("boost::container::flat_set<int> with many values") {
+    namespace cr = sk::config;
+
+    struct test_config {
+        boost::container::flat_set<int> items;
+    };
+
+    auto grammar =
+        cr::config<test_config>(cr::option("int-value", &test_config::items));
+
+    // Values out of order, over several options which overlap in range.
+    std::string input;
+    for (int i = 0; i < 3; ++i) {
+        input += "int-value ";
+        for (int j = 0; j < 10000; ++j) {
+            if (j)
+                input += ", ";
+            input += std::to_string((j * 7919 % 10000) * 3 + i);
+        }
+        input += ";\n";
+    }
+
+    test_config c;
+    sk::config::parse(input, grammar, c);
+
+    REQUIRE(c.items.size() == 30000);
+    for (int i = 0; i < 30000; ++i)
+        REQUIRE(c.items.nth(i) == c.items.find(i));
+}
+
+TEST_CASE("boost::container::flat_set<int> reports duplicates") {
+    namespace cr = sk::config;
+
+    struct test_config {
+        boost::container::flat_set<int> items;
+    };
+
+    auto grammar =
+        cr::config<test_config>(cr::option("int-value", &test_config::items));
+
+    // The error is reported at the end of the option's value.
+    auto check = [&](std::string const &input, std::size_t column) {
+        test_config c;
+        try {
+            sk::config::parse(input, grammar, c);
+            FAIL("no exception");
+        } catch (sk::config::parse_error const &e) {
+            REQUIRE(e.errors.at(0).message == "expected unique value");
+            REQUIRE(e.errors.at(0).line == 2);
+            REQUIRE(e.errors.at(0).column == column);
+        }
+    };
+
+    // In the same option.
+    check("int-value 1;\nint-value 5, 3, 4, 3, 2;\n", 23);
+    // With a value from an earlier option.
+    check("int-value 1, 4;\nint-value 5, 3, 4;\n", 17);
+}
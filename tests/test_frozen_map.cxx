@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <sk/config/block.hxx>
+#include <sk/config/config.hxx>
+#include <sk/config/frozen_map.hxx>
+#include <sk/config/incremental_parser.hxx>
+#include <sk/config/option.hxx>
+#include <sk/config/parse.hxx>
+#include <sk/config/parse_parallel.hxx>
+#include <sk/config/reparser.hxx>
+#include <sk/config/parser/frozen_map.hxx>
+#include <sk/config/parser/map.hxx>
+#include <sk/config/parser/numeric.hxx>
+#include <sk/config/parser/string.hxx>
+
+TEST_CASE("frozen_map lookups") {
+    sk::config::frozen_map<std::string, int> m;
+
+    REQUIRE(m.empty());
+    REQUIRE(m.find("x") == m.end());
+
+    for (int i = 0; i < 10000; ++i)
+        REQUIRE(m.emplace("key" + std::to_string(i), i).second);
+    REQUIRE(!m.emplace("key5", 0).second);
+
+    // Entries can be found before the map is frozen.
+    REQUIRE(!m.frozen());
+    REQUIRE(m.at("key5") == 5);
+
+    m.freeze();
+    REQUIRE(m.frozen());
+    REQUIRE(m.size() == 10000);
+
+    for (int i = 0; i < 10000; ++i) {
+        auto key = "key" + std::to_string(i);
+        REQUIRE(m.at(std::string_view(key)) == i);
+    }
+
+    REQUIRE(!m.contains("key10000"));
+    REQUIRE(!m.contains(""));
+    REQUIRE_THROWS_AS(m.at("nothing"), std::out_of_range);
+
+    // Entries added after freezing are found too.
+    REQUIRE(m.emplace("more", -1).second);
+    REQUIRE(!m.frozen());
+    REQUIRE(m.at("more") == -1);
+    REQUIRE(m.at("key42") == 42);
+
+    m.freeze();
+    REQUIRE(m.at("more") == -1);
+    REQUIRE(m.at("key42") == 42);
+}
+
+TEST_CASE("frozen_map<int,int>") {
+    sk::config::frozen_map<int, int> m{{1, 10}, {2, 20}, {-3, 30}};
+
+    REQUIRE(m.frozen());
+    REQUIRE(m.size() == 3);
+    REQUIRE(m.at(1) == 10);
+    REQUIRE(m.at(2) == 20);
+    REQUIRE(m.at(-3) == 30);
+    REQUIRE(m.count(3) == 0);
+}
+
+namespace {
+
+    // A hash which only looks at the first character of the key.
+    struct first_char_hash {
+        auto operator()(std::string const &key) const -> std::size_t {
+            return key.empty() ? 0 : static_cast<unsigned char>(key[0]);
+        }
+    };
+
+    // Counts the keys hashed, to tell how often a map was frozen.
+    struct counting_hash {
+        static inline std::size_t calls = 0;
+
+        auto operator()(std::string const &key) const -> std::size_t {
+            ++calls;
+            return std::hash<std::string>()(key);
+        }
+    };
+
+} // namespace
+
+TEST_CASE("frozen_map with a weak hash") {
+    namespace cfg = sk::config;
+
+    cfg::frozen_map<std::string, int, first_char_hash> m;
+    m.emplace(std::string("alice"), 1);
+    m.emplace(std::string("adam"), 2);
+    m.emplace(std::string("bob"), 3);
+    m.emplace(std::string("anne"), 4);
+
+    // Keys with the same hash can't all be in the perfect hash.
+    m.freeze();
+    REQUIRE(!m.frozen());
+    REQUIRE(m.size() == 4);
+    REQUIRE(m.at("alice") == 1);
+    REQUIRE(m.at("adam") == 2);
+    REQUIRE(m.at("bob") == 3);
+    REQUIRE(m.at("anne") == 4);
+    REQUIRE(!m.contains("arthur"));
+
+    m.emplace(std::string("alan"), 5);
+    m.freeze();
+    REQUIRE(m.at("alan") == 5);
+    REQUIRE(m.at("adam") == 2);
+
+    // The parser freezes the map without throwing.
+    struct test_config {
+        cfg::frozen_map<std::string, int, first_char_hash> ids;
+    };
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("id", &test_config::ids));
+    test_config c;
+
+    cfg::parse("id { alice 1; adam 2; };", grammar, c);
+    REQUIRE(c.ids.size() == 2);
+    REQUIRE(c.ids.at("alice") == 1);
+    REQUIRE(c.ids.at("adam") == 2);
+}
+
+TEST_CASE("frozen_map<> from named blocks") {
+    namespace cfg = sk::config;
+
+    struct user {
+        std::string name;
+        int uid;
+    };
+
+    struct test_config {
+        cfg::frozen_map<std::string, user> users;
+    };
+
+    auto grammar =                                                  //
+        cfg::config<test_config>(                                   //
+            cfg::block("user", &user::name, &test_config::users, //
+                       cfg::option("uid", &user::uid)));
+    test_config c;
+
+    cfg::parse(R"(
+user "alice" { uid 1000; };
+user "bob" { uid 1001; };
+user "carol" { uid 1002; };
+)",
+               grammar, c);
+
+    REQUIRE(c.users.frozen());
+    REQUIRE(c.users.size() == 3);
+    REQUIRE(c.users.at(std::string_view("alice")).uid == 1000);
+    REQUIRE(c.users.at("bob").uid == 1001);
+    REQUIRE(c.users.at("carol").uid == 1002);
+    REQUIRE(c.users.at("carol").name == "carol");
+}
+
+TEST_CASE("frozen_map<> duplicate value") {
+    namespace cfg = sk::config;
+
+    struct user {
+        std::string name;
+        int uid;
+    };
+
+    struct test_config {
+        cfg::frozen_map<std::string, user> users;
+    };
+
+    auto grammar =                                                  //
+        cfg::config<test_config>(                                   //
+            cfg::block("user", &user::name, &test_config::users, //
+                       cfg::option("uid", &user::uid)));
+    test_config c;
+
+    REQUIRE_THROWS(cfg::parse(R"(
+user "alice" { uid 1000; };
+user "alice" { uid 1001; };
+)",
+                              grammar, c));
+}
+
+TEST_CASE("frozen_map<string,int> over several options") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        cfg::frozen_map<std::string, int> items;
+    };
+
+    auto grammar =                //
+        cfg::config<test_config>( //
+            cfg::option("items", &test_config::items));
+
+    test_config c;
+
+    cfg::parse(R"(
+items { one 1; three 3; };
+items { forty-two 42; };
+)",
+               grammar, c);
+
+    REQUIRE(c.items.frozen());
+    REQUIRE(c.items.size() == 3);
+    REQUIRE(c.items.at("one") == 1);
+    REQUIRE(c.items.at("three") == 3);
+    REQUIRE(c.items.at("forty-two") == 42);
+
+    // A second parse adds to the map, which is frozen again.
+    cfg::parse("items { two 2; };", grammar, c);
+    REQUIRE(c.items.frozen());
+    REQUIRE(c.items.size() == 4);
+    REQUIRE(c.items.at("two") == 2);
+    REQUIRE(c.items.at("one") == 1);
+
+    try {
+        cfg::parse("items { four 4; one 1; };", grammar, c);
+        FAIL("no exception");
+    } catch (cfg::parse_error const &e) {
+        REQUIRE(e.errors.at(0).message == "expected a block");
+    }
+}
+
+TEST_CASE("frozen_map<> nested in blocks and maps") {
+    namespace cfg = sk::config;
+
+    struct group {
+        std::string name;
+        cfg::frozen_map<std::string, int> members;
+    };
+
+    struct test_config {
+        std::map<std::string, group> groups;
+        cfg::frozen_map<std::string, cfg::frozen_map<std::string, int>>
+            tables;
+    };
+
+    auto grammar =                                                  //
+        cfg::config<test_config>(                                   //
+            cfg::block("group", &group::name, &test_config::groups, //
+                       cfg::option("members", &group::members)),
+            cfg::option("tables", &test_config::tables));
+
+    test_config c;
+
+    cfg::parse(R"(
+group "staff" { members { alice 1; bob 2; }; members { carol 3; }; };
+group "admin" { members { root 0; }; };
+tables { t1 { a 1; b 2; }; t2 { c 3; }; };
+)",
+               grammar, c);
+
+    REQUIRE(c.groups.size() == 2);
+    REQUIRE(c.groups["staff"].members.frozen());
+    REQUIRE(c.groups["staff"].members.size() == 3);
+    REQUIRE(c.groups["staff"].members.at("carol") == 3);
+    REQUIRE(c.groups["admin"].members.frozen());
+    REQUIRE(c.groups["admin"].members.at("root") == 0);
+
+    REQUIRE(c.tables.frozen());
+    REQUIRE(c.tables.at("t1").frozen());
+    REQUIRE(c.tables.at("t1").at("b") == 2);
+    REQUIRE(c.tables.at("t2").at("c") == 3);
+}
+
+TEST_CASE("frozen_map<> with parse_parallel()") {
+    namespace cfg = sk::config;
+
+    struct user {
+        std::string name;
+        int uid;
+    };
+
+    struct test_config {
+        cfg::frozen_map<std::string, user> users;
+    };
+
+    auto grammar =                                                  //
+        cfg::config<test_config>(                                   //
+            cfg::block("user", &user::name, &test_config::users, //
+                       cfg::option("uid", &user::uid)));
+
+    std::string input;
+    for (int i = 0; i < 5000; ++i)
+        input += "user \"u" + std::to_string(i) + "\" { uid " +
+                 std::to_string(i) + "; };\n";
+
+    test_config c;
+    cfg::parse_parallel(input, grammar, c, "", 4096);
+
+    REQUIRE(c.users.frozen());
+    REQUIRE(c.users.size() == 5000);
+    for (int i = 0; i < 5000; ++i)
+        REQUIRE(c.users.at("u" + std::to_string(i)).uid == i);
+}
+
+TEST_CASE("frozen_map<> with incremental_parser and reparser") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        cfg::frozen_map<std::string, int, counting_hash> items;
+    };
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("items", &test_config::items));
+
+    constexpr std::size_t n = 2000;
+    std::string input;
+    for (std::size_t i = 0; i < n; ++i)
+        input += "items { k" + std::to_string(i) + " 1; };\n";
+
+    // Freezing after every statement would hash each key about n/2 times.
+    auto check = [&](test_config const &c, std::size_t size) {
+        REQUIRE(c.items.frozen());
+        REQUIRE(c.items.size() == size);
+        REQUIRE(c.items.at("k0") == 1);
+        REQUIRE(c.items.at("k" + std::to_string(n - 1)) == 1);
+        REQUIRE(counting_hash::calls < 20 * n);
+    };
+
+    SECTION("incremental_parser") {
+        test_config c;
+        auto parser = cfg::incremental_parser(grammar, c);
+
+        counting_hash::calls = 0;
+        parser.feed(input);
+        REQUIRE(!c.items.frozen());
+
+        parser.finish();
+        check(c, n);
+    }
+
+    SECTION("reparser") {
+        auto parser = cfg::make_reparser<test_config>(grammar);
+
+        test_config c;
+        counting_hash::calls = 0;
+        parser.parse(input, c);
+        check(c, n);
+
+        input += "items { extra 2; };\n";
+        counting_hash::calls = 0;
+        parser.parse(input, c);
+        REQUIRE(c.items.at("extra") == 2);
+        check(c, n + 1);
+    }
+}
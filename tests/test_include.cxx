@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    struct temp_directory {
+        std::filesystem::path path;
+
+        explicit temp_directory(std::string const &name)
+            : path(std::filesystem::temp_directory_path() / name) {
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+        }
+
+        ~temp_directory() {
+            std::error_code ec;
+            std::filesystem::remove_all(path, ec);
+        }
+
+        auto write(std::string const &name, std::string const &contents)
+            -> std::filesystem::path {
+            auto p = path / name;
+            std::filesystem::create_directories(p.parent_path());
+            std::ofstream strm(p, std::ios::binary);
+            strm << contents;
+            return p;
+        }
+    };
+
+    struct user {
+        std::string name;
+        int uid = 0;
+    };
+
+    struct test_config {
+        std::map<std::string, user> users;
+        std::vector<int> numbers;
+        std::string motd;
+    };
+
+    struct include_policy : sk::config::parser_policy {
+        static constexpr bool allow_include = true;
+    };
+
+    auto make_grammar() {
+        namespace cfg = sk::config;
+        return cfg::config<test_config>(
+            cfg::block<user>("user", &user::name, &test_config::users,
+                             cfg::option("uid", &user::uid)),
+            cfg::option("number", &test_config::numbers),
+            cfg::option("motd", &test_config::motd));
+    }
+
+} // namespace
+
+TEST_CASE("include") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_include");
+
+    dir.write("common/users.conf", "user alice { uid 1; };\n"
+                                   "number 2;\n");
+    auto main = dir.write("main.conf", "number 1;\n"
+                                       "include \"common/users.conf\";\n"
+                                       "number 3;\n"
+                                       "motd 'hello';\n");
+
+    test_config c;
+    cfg::parse_file<include_policy>(main, make_grammar(), c);
+
+    REQUIRE(c.users.size() == 1);
+    REQUIRE(c.users.at("alice").uid == 1);
+    REQUIRE(c.numbers == std::vector<int>{1, 2, 3});
+    REQUIRE(c.motd == "hello");
+}
+
+TEST_CASE("include is disabled by default") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_include_disabled");
+
+    dir.write("other.conf", "number 2;\n");
+    auto main = dir.write("main.conf", "include \"other.conf\";\n");
+
+    test_config c;
+    REQUIRE_THROWS_AS(cfg::parse_file(main, make_grammar(), c),
+                      cfg::parse_error);
+}
+
+TEST_CASE("include glob") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_include_glob");
+
+    dir.write("conf.d/20-b.conf", "number 2; include '../leaf.conf';\n");
+    dir.write("conf.d/10-a.conf", "number 1; include '../leaf.conf';\n");
+    dir.write("conf.d/30-c.txt", "number 3;\n");
+    dir.write("conf.d/.40-d.conf", "number 4;\n");
+    dir.write("leaf.conf", "number 0;\n");
+    auto main = dir.write("main.conf", "include 'conf.d/*.conf';\n"
+                                       "include 'none.d/*.conf';\n");
+
+    test_config c;
+    cfg::parse_file<include_policy>(main, make_grammar(), c);
+
+    REQUIRE(c.numbers == std::vector<int>{1, 0, 2, 0});
+}
+
+TEST_CASE("include loop") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_include_loop");
+
+    dir.write("a.conf", "number 1;\ninclude 'b.conf';\n");
+    dir.write("b.conf", "number 2;\ninclude 'a.conf';\n");
+    auto main = dir.write("main.conf", "include 'a.conf';\n");
+
+    test_config c;
+    try {
+        cfg::parse_file<include_policy>(main, make_grammar(), c);
+        FAIL("expected parse_error");
+    } catch (cfg::parse_error const &e) {
+        REQUIRE(e.errors.size() == 3);
+        REQUIRE(e.errors[0].file == (dir.path / "b.conf").string());
+        REQUIRE(e.errors[0].line == 2);
+        REQUIRE(e.errors[0].message == "include file \"a.conf\" includes itself");
+        REQUIRE(e.errors[1].file == (dir.path / "a.conf").string());
+        REQUIRE(e.errors[1].message == "included from here");
+        REQUIRE(e.errors[2].file == main.string());
+    }
+}
+
+TEST_CASE("include errors") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_include_errors");
+
+    dir.write("bad.conf", "\nnumber 'x';\n");
+    dir.write("dup.conf", "user alice { uid 2; };\n");
+
+    SECTION("missing file") {
+        auto main = dir.write("main.conf", "\ninclude 'missing.conf';\n");
+        test_config c;
+        try {
+            cfg::parse_file<include_policy>(main, make_grammar(), c);
+            FAIL("expected parse_error");
+        } catch (cfg::parse_error const &e) {
+            REQUIRE(e.errors.size() == 1);
+            REQUIRE(e.errors[0].file == main.string());
+            REQUIRE(e.errors[0].line == 2);
+        }
+    }
+
+    SECTION("syntax error") {
+        auto main = dir.write("main.conf", "include 'bad.conf';\n");
+        test_config c;
+        try {
+            cfg::parse_file<include_policy>(main, make_grammar(), c);
+            FAIL("expected parse_error");
+        } catch (cfg::parse_error const &e) {
+            REQUIRE(e.errors.size() == 2);
+            REQUIRE(e.errors[0].file == (dir.path / "bad.conf").string());
+            REQUIRE(e.errors[0].line == 2);
+            REQUIRE(e.errors[1].file == main.string());
+            REQUIRE(e.errors[1].line == 1);
+        }
+    }
+
+    SECTION("duplicate key") {
+        auto main = dir.write("main.conf", "user alice { uid 1; };\n"
+                                           "include 'dup.conf';\n");
+        test_config c;
+        try {
+            cfg::parse_file<include_policy>(main, make_grammar(), c);
+            FAIL("expected parse_error");
+        } catch (cfg::parse_error const &e) {
+            REQUIRE(e.errors.size() == 1);
+            REQUIRE(e.errors[0].file == (dir.path / "dup.conf").string());
+            REQUIRE(e.errors[0].message == "expected unique value");
+        }
+    }
+}
+
+TEST_CASE("include cache") {
+    namespace cfg = sk::config;
+    namespace x3 = boost::spirit::x3;
+
+    temp_directory dir("sk_config_test_include_cache");
+
+    auto common = dir.write("common.conf", "number 1;\n");
+    dir.write("a.conf", "include 'common.conf';\n");
+    dir.write("b.conf", "include 'common.conf';\n");
+    auto main =
+        dir.write("main.conf", "include 'a.conf'; include 'b.conf';\n");
+
+    cfg::include_cache cache;
+    auto const grammar =
+        x3::with<cfg::include_cache_tag>(std::ref(cache))[make_grammar()];
+
+    test_config c1;
+    cfg::parse_file<include_policy>(main, grammar, c1);
+    REQUIRE(c1.numbers == std::vector<int>{1, 1});
+    REQUIRE(cache.size() == 3);
+
+    // Changing an included file invalidates its cache entry.
+    std::ofstream(common, std::ios::binary) << "number 2; number 3;\n";
+    test_config c2;
+    cfg::parse_file<include_policy>(main, grammar, c2);
+    REQUIRE(c2.numbers == std::vector<int>{2, 3, 2, 3});
+    REQUIRE(cache.size() == 3);
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    struct user {
+        std::string name;
+        int uid = 0;
+        std::string shell;
+    };
+
+    struct test_config {
+        std::map<std::string, user> users;
+        std::vector<int> numbers;
+        std::string motd;
+    };
+
+    auto make_grammar() {
+        namespace cfg = sk::config;
+        return cfg::config<test_config>(
+            cfg::block<user>("user", &user::name, &test_config::users,
+                             cfg::option("uid", &user::uid),
+                             cfg::option("shell", &user::shell)),
+            cfg::option("number", &test_config::numbers),
+            cfg::option("motd", &test_config::motd));
+    }
+
+    std::string const input = R"(# users; with {braces} in a comment
+user "root" {
+    uid 0;
+    shell "/bin/sh; {";
+};
+/* a block comment; } */ user 'fred' { uid 1000; shell '\';'; };
+number 1, 2, 3; number 4;
+motd <<<END
+Welcome; enjoy { your stay
+END;
+)";
+
+    void check(test_config const &c) {
+        REQUIRE(c.users.size() == 2);
+        REQUIRE(c.users.at("root").uid == 0);
+        REQUIRE(c.users.at("root").shell == "/bin/sh; {");
+        REQUIRE(c.users.at("fred").uid == 1000);
+        REQUIRE(c.users.at("fred").shell == "';");
+        REQUIRE(c.numbers == std::vector<int>{1, 2, 3, 4});
+        REQUIRE(c.motd == "Welcome; enjoy { your stay");
+    }
+
+} // namespace
+
+TEST_CASE("incremental_parser: single chunk") {
+    namespace cfg = sk::config;
+
+    test_config c;
+    cfg::incremental_parser p(make_grammar(), c);
+    p.feed(input);
+    p.finish();
+
+    check(c);
+}
+
+TEST_CASE("incremental_parser: one byte at a time") {
+    namespace cfg = sk::config;
+
+    test_config c;
+    cfg::incremental_parser p(make_grammar(), c);
+
+    std::size_t max_buffered = 0;
+    for (auto &&ch : input) {
+        p.feed(std::span<char const>(&ch, 1));
+        max_buffered = std::max(max_buffered, p.buffered());
+    }
+    p.finish();
+
+    check(c);
+
+    // We should never have buffered the entire input.
+    REQUIRE(max_buffered < input.size() / 2);
+}
+
+TEST_CASE("incremental_parser: statements are parsed as they arrive") {
+    namespace cfg = sk::config;
+
+    test_config c;
+    cfg::incremental_parser p(make_grammar(), c);
+
+    p.feed(std::string("number 1; num"));
+    REQUIRE(c.numbers == std::vector<int>{1});
+
+    p.feed(std::string("ber 2;"));
+    REQUIRE(c.numbers == std::vector<int>{1, 2});
+
+    p.finish();
+}
+
+TEST_CASE("incremental_parser: error line numbers") {
+    namespace cfg = sk::config;
+
+    std::string text = "number 1;\nnumber 2;\r\n\nnumber 3; number 'x';\n";
+
+    test_config c;
+    cfg::incremental_parser p(make_grammar(), c, "test.conf");
+
+    try {
+        for (auto &&ch : text)
+            p.feed(std::span<char const>(&ch, 1));
+        p.finish();
+        FAIL("expected parse_error");
+    } catch (cfg::parse_error const &e) {
+        REQUIRE(e.errors.size() > 0);
+        REQUIRE(e.errors[0].file == "test.conf");
+        REQUIRE(e.errors[0].line == 4);
+        REQUIRE(e.errors[0].column == 17);
+        REQUIRE(e.errors[0].context == "number 3; number 'x';");
+    }
+}
+
+TEST_CASE("incremental_parser: incomplete statement") {
+    namespace cfg = sk::config;
+
+    test_config c;
+    cfg::incremental_parser p(make_grammar(), c);
+
+    p.feed(std::string("number 1;\nuser \"x\" { uid 1;"));
+    REQUIRE_THROWS_AS(p.finish(), cfg::parse_error);
+}
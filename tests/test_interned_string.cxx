@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace cfg = sk::config;
+
+TEST_CASE("interned_string") {
+    cfg::intern_table table;
+
+    auto a = table.intern("alice");
+    auto b = table.intern(std::string("alice"));
+    auto c = table.intern("bob");
+
+    REQUIRE(a == b);
+    REQUIRE(a.c_str() == b.c_str());
+    REQUIRE(a != c);
+    REQUIRE(a < c);
+    REQUIRE(a == "alice");
+    REQUIRE(a.str() == "alice");
+    REQUIRE(a.size() == 5);
+    REQUIRE(std::hash<cfg::interned_string>()(a) == a.hash());
+    REQUIRE(table.size() == 2);
+
+    // The empty string isn't stored.
+    cfg::interned_string empty;
+    REQUIRE(empty.empty());
+    REQUIRE(empty == table.intern(""));
+    REQUIRE(table.size() == 2);
+
+    // Strings from different tables are compared by their text.
+    cfg::intern_table other;
+    REQUIRE(other.intern("alice") == a);
+    REQUIRE(other.intern("alice").hash() == a.hash());
+    REQUIRE(other.intern("carol") != a);
+}
+
+TEST_CASE("interned_string option") {
+    struct test_group {
+        std::string name;
+        std::set<cfg::interned_string> members;
+        std::unordered_set<cfg::interned_string> admins;
+    };
+
+    struct test_config {
+        cfg::interned_string owner;
+        std::vector<cfg::interned_string> names;
+        std::map<std::string, test_group> groups;
+    };
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("owner", &test_config::owner),
+        cfg::option("names", &test_config::names),
+        cfg::block<test_group>("group", &test_group::name,
+                               &test_config::groups,
+                               cfg::option("members", &test_group::members),
+                               cfg::option("admins", &test_group::admins)));
+
+    auto input = R"(
+owner alice;
+names alice, "bob", <<<END
+carol
+END;
+group staff {
+    members carol, alice, bob;
+    admins alice;
+};
+group wheel {
+    members alice;
+};
+)";
+
+    cfg::intern_table table;
+    test_config c;
+    cfg::parse(input, cfg::with_intern_table(table, grammar), c);
+
+    REQUIRE(table.size() == 3);
+    REQUIRE(c.owner == "alice");
+    REQUIRE(c.names.size() == 3);
+    REQUIRE(c.names[2] == "carol");
+
+    auto const &staff = c.groups.at("staff");
+    REQUIRE(staff.members.size() == 3);
+    REQUIRE(staff.members.begin()->str() == "alice");
+    REQUIRE(staff.admins.contains(c.owner));
+
+    // Every occurrence refers to the same string.
+    REQUIRE(c.groups.at("wheel").members.begin()->c_str() == c.owner.c_str());
+
+    SECTION("without a table") {
+        test_config d;
+        cfg::parse(input, grammar, d);
+        REQUIRE(d.owner == c.owner);
+        REQUIRE(d.owner.c_str() != c.owner.c_str());
+
+        // The parse has a table of its own.
+        REQUIRE(d.groups.at("wheel").members.begin()->c_str() ==
+                d.owner.c_str());
+
+        test_config e;
+        cfg::parse(input, grammar, e);
+        REQUIRE(e.owner == d.owner);
+        REQUIRE(e.owner.c_str() != d.owner.c_str());
+
+        // The table is kept alive by the strings in it.
+        auto owner = d.owner;
+        d = test_config();
+        REQUIRE(owner == "alice");
+        REQUIRE(owner == e.owner);
+    }
+
+    SECTION("duplicate values") {
+        test_config d;
+        REQUIRE_THROWS_AS(
+            cfg::parse("group g { members bob, 'bob'; };", grammar, d),
+            cfg::parse_error);
+    }
+}
+
+TEST_CASE("interned_string in statements parsed separately") {
+    struct test_config {
+        std::vector<cfg::interned_string> names;
+    };
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("name", &test_config::names));
+
+    std::string input;
+    for (int i = 0; i < 100; ++i)
+        input += "name alice;\n";
+
+    // Every statement, shard or file interns into the same table.
+    auto check = [](test_config const &c, std::size_t n) {
+        REQUIRE(c.names.size() == n);
+        for (auto &&name : c.names) {
+            REQUIRE(name == "alice");
+            REQUIRE(name.c_str() == c.names.front().c_str());
+        }
+    };
+
+    SECTION("incremental_parser") {
+        test_config c;
+        auto parser = cfg::incremental_parser(grammar, c);
+        parser.feed(input);
+        parser.finish();
+        check(c, 100);
+    }
+
+    SECTION("reparser") {
+        test_config c;
+        auto parser = cfg::make_reparser<test_config>(grammar);
+        parser.parse(input + "name bob;\nname bob;\n", c);
+        REQUIRE(c.names.at(100).c_str() == c.names.at(101).c_str());
+        c.names.resize(100);
+        check(c, 100);
+    }
+
+    SECTION("parse_parallel") {
+        test_config c;
+        cfg::parse_parallel(input, grammar, c, "", 64);
+        check(c, 100);
+    }
+
+    SECTION("parse_files") {
+        auto dir = std::filesystem::temp_directory_path() /
+                   "sk_config_test_interned_files";
+        std::filesystem::create_directories(dir);
+        std::vector<std::filesystem::path> paths{dir / "a.conf",
+                                                 dir / "b.conf"};
+        for (auto &&path : paths)
+            std::ofstream(path) << input;
+
+        test_config c;
+        cfg::parse_files(paths, grammar, c);
+        check(c, 200);
+        std::filesystem::remove_all(dir);
+    }
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <catch.hpp>
+
+#include <stdexcept>
+#include <string>
+
+#include <sk/config.hxx>
+
+TEST_CASE("keyword labels which are prefixes of each other") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        std::string user;
+        std::string username;
+    };
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("user", &test_config::user),
+        cfg::option("username", &test_config::username));
+
+    test_config c;
+    cfg::parse("username \"bob\"; user \"alice\";", grammar, c);
+    REQUIRE(c.user == "alice");
+    REQUIRE(c.username == "bob");
+}
+
+TEST_CASE("keyword boundary") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        int user = 0;
+    };
+
+    auto grammar =
+        cfg::config<test_config>(cfg::option("user", &test_config::user));
+
+    test_config c;
+    REQUIRE_THROWS_AS(cfg::parse("userid 1;", grammar, c), cfg::parse_error);
+    REQUIRE(c.user == 0);
+
+    cfg::parse("user 1;", grammar, c);
+    REQUIRE(c.user == 1);
+}
+
+TEST_CASE("keyword in a block") {
+    namespace cfg = sk::config;
+
+    struct item {
+        int a = 0;
+        int ab = 0;
+    };
+
+    struct test_config {
+        item item_;
+    };
+
+    auto grammar = cfg::config<test_config>(cfg::block<item>(
+        "item", &test_config::item_, cfg::option("a", &item::a),
+        cfg::option("ab", &item::ab)));
+
+    test_config c;
+    cfg::parse("item { ab 2; a 1; };", grammar, c);
+    REQUIRE(c.item_.a == 1);
+    REQUIRE(c.item_.ab == 2);
+}
+
+TEST_CASE("duplicate keyword") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        int a = 0;
+        int b = 0;
+    };
+
+    REQUIRE_THROWS_AS(
+        cfg::config<test_config>(cfg::option("a", &test_config::a),
+                                 cfg::option("a", &test_config::b)),
+        std::logic_error);
+}
+
+TEST_CASE("keyword with a custom label parser") {
+    namespace cfg = sk::config;
+    namespace x3 = boost::spirit::x3;
+
+    struct test_config {
+        int a = 0;
+        int b = 0;
+    };
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("a", &test_config::a),
+        cfg::option(x3::lit("b") | x3::lit("bee"), &test_config::b));
+
+    test_config c;
+    cfg::parse("b 1; a 2;", grammar, c);
+    REQUIRE(c.a == 2);
+    REQUIRE(c.b == 1);
+}
+
+TEST_CASE("keyword_table") {
+    using sk::config::detail::parser::keyword_table;
+
+    keyword_table table;
+    for (std::uint32_t i = 0; i < 500; ++i)
+        table.add("option-" + std::to_string(i), i);
+    table.build();
+
+    for (std::uint32_t i = 0; i < 500; ++i)
+        REQUIRE(table.find("option-" + std::to_string(i)) == i);
+
+    REQUIRE(table.find("option-500") == keyword_table::npos);
+    REQUIRE(table.find("option") == keyword_table::npos);
+    REQUIRE(table.find("") == keyword_table::npos);
+
+    REQUIRE_THROWS_AS(table.add("option-1", 1), std::logic_error);
+}
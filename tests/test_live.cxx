@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    struct temp_directory {
+        std::filesystem::path path;
+
+        explicit temp_directory(std::string const &name)
+            : path(std::filesystem::temp_directory_path() / name) {
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+        }
+
+        ~temp_directory() {
+            std::error_code ec;
+            std::filesystem::remove_all(path, ec);
+        }
+
+        // Replace a file the way an editor would.
+        auto write(std::string const &name, std::string const &contents)
+            -> std::filesystem::path {
+            auto p = path / name;
+            auto tmp = path / (name + ".tmp");
+            {
+                std::ofstream strm(tmp, std::ios::binary);
+                strm << contents;
+            }
+            std::filesystem::rename(tmp, p);
+            return p;
+        }
+    };
+
+    struct test_config {
+        std::vector<int> numbers;
+    };
+
+    struct include_policy : sk::config::parser_policy {
+        static constexpr bool allow_include = true;
+    };
+
+    auto make_grammar() {
+        namespace cfg = sk::config;
+        return cfg::config<test_config>(
+            cfg::option("number", &test_config::numbers));
+    }
+
+    // Wait for pred() to become true.
+    auto wait_for(std::function<bool()> pred) -> bool {
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!pred()) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return true;
+    }
+
+} // namespace
+
+TEST_CASE("live") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_live");
+    auto path = dir.write("main.conf", "number 1;\n");
+
+    cfg::live_options options;
+    options.poll_interval = std::chrono::milliseconds(100);
+    options.settle_time = std::chrono::milliseconds(10);
+
+    cfg::live<test_config> config(path, make_grammar(), options);
+
+    auto first = config.get();
+    REQUIRE(first->numbers == std::vector<int>{1});
+    REQUIRE(config.metrics().generation == 1);
+
+    dir.write("main.conf", "number 2;\n");
+    REQUIRE(wait_for([&] { return config.metrics().generation == 2; }));
+    REQUIRE(config.get()->numbers == std::vector<int>{2});
+
+    // Old snapshots are still valid.
+    REQUIRE(first->numbers == std::vector<int>{1});
+
+    // A failed reload keeps the previous snapshot.
+    dir.write("main.conf", "number 'x';\n");
+    REQUIRE(wait_for([&] { return config.metrics().failures == 1; }));
+    REQUIRE(config.get()->numbers == std::vector<int>{2});
+    REQUIRE(config.last_error());
+    REQUIRE(config.last_error()->errors[0].file == path.string());
+
+    dir.write("main.conf", "number 3;\n");
+    REQUIRE(wait_for([&] { return config.metrics().generation == 3; }));
+    REQUIRE(config.get()->numbers == std::vector<int>{3});
+    REQUIRE(!config.last_error());
+
+    auto m = config.metrics();
+    REQUIRE(m.max_reload_time >= m.last_reload_time);
+    REQUIRE(m.total_reload_time >= m.max_reload_time);
+}
+
+TEST_CASE("live watches included files") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_live_include");
+    dir.write("other.conf", "number 2;\n");
+    auto path = dir.write("main.conf", "number 1; include 'other.conf';\n");
+
+    cfg::live_options options;
+    options.poll_interval = std::chrono::milliseconds(100);
+    options.settle_time = std::chrono::milliseconds(10);
+
+    cfg::live<test_config, include_policy> config(path, make_grammar(),
+                                                  options);
+    REQUIRE(config.get()->numbers == std::vector<int>{1, 2});
+
+    dir.write("other.conf", "number 3;\n");
+    REQUIRE(wait_for([&] { return config.metrics().generation == 2; }));
+    REQUIRE(config.get()->numbers == std::vector<int>{1, 3});
+}
+
+TEST_CASE("live initial error") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_live_error");
+    auto path = dir.write("main.conf", "number 'x';\n");
+
+    REQUIRE_THROWS_AS(cfg::live<test_config>(path, make_grammar()),
+                      cfg::parse_error);
+}
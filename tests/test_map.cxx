@@ -123,3 +123,61 @@ items {
     REQUIRE(c.items["three"] == 3);
     REQUIRE(c.items["forty-two"] == 42);
 }
+
+TEST_CASE("std::map<int,int> with many values") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        std::map<int, int> items;
+    };
+
+    auto grammar =                //
+        cfg::config<test_config>( //
+            cfg::option("items", &test_config::items));
+
+    // Keys out of order, over several options which overlap in range.
+    std::string input;
+    for (int i = 0; i < 3; ++i) {
+        input += "items {\n";
+        for (int j = 0; j < 10000; ++j) {
+            auto key = (j * 7919 % 10000) * 3 + i;
+            input += std::to_string(key) + " " + std::to_string(-key) + ";\n";
+        }
+        input += "};\n";
+    }
+
+    test_config c;
+    cfg::parse(input, grammar, c);
+
+    REQUIRE(c.items.size() == 30000);
+    for (int i = 0; i < 30000; ++i)
+        REQUIRE(c.items.at(i) == -i);
+}
+
+TEST_CASE("std::map<int,int> reports a duplicate key") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        std::map<int, int> items;
+    };
+
+    auto grammar =                //
+        cfg::config<test_config>( //
+            cfg::option("items", &test_config::items));
+
+    // The error is reported at the end of the option's value.
+    auto check = [&](std::string const &input, std::size_t line,
+                     std::size_t column) {
+        test_config c;
+        try {
+            cfg::parse(input, grammar, c);
+            FAIL("no exception");
+        } catch (cfg::parse_error const &e) {
+            REQUIRE(e.errors.at(0).line == line);
+            REQUIRE(e.errors.at(0).column == column);
+        }
+    };
+
+    check("items { 1 1; };\nitems { 3 3; 2 2; 3 4; };\n", 2, 24);
+    check("items { 1 1; 2 2; };\nitems { 3 3; 2 4; };\n", 2, 19);
+}
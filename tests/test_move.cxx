@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    namespace x3 = boost::spirit::x3;
+
+    /*
+     * A value which owns heap memory and counts how many times it has
+     * been deep-copied.
+     */
+    struct counted {
+        static inline int copies = 0;
+
+        std::unique_ptr<std::string> value;
+
+        counted() = default;
+        counted(counted &&) noexcept = default;
+        auto operator=(counted &&) noexcept -> counted & = default;
+
+        counted(counted const &other)
+            : value(other.value ? std::make_unique<std::string>(*other.value)
+                                : nullptr) {
+            ++copies;
+        }
+
+        auto operator=(counted const &other) -> counted & {
+            counted copy(other);
+            return *this = std::move(copy);
+        }
+
+        auto operator<(counted const &other) const -> bool {
+            return *value < *other.value;
+        }
+    };
+
+    struct include_policy : sk::config::parser_policy {
+        static constexpr bool allow_include = true;
+    };
+
+    // The same, but it can't be copied at all.
+    struct move_only {
+        std::unique_ptr<std::string> value;
+    };
+
+    template <typename T>
+    struct word_parser : x3::parser<word_parser<T>> {
+        typedef T attribute_type;
+        static bool const has_attribute = true;
+
+        template <typename Iterator, typename Context, typename RContext>
+        bool parse(Iterator &first, Iterator const &last,
+                   Context const &context, RContext const &, T &attr) const {
+            std::string word;
+            if (!x3::lexeme[+x3::alpha].parse(first, last, context, x3::unused,
+                                              word))
+                return false;
+            attr.value = std::make_unique<std::string>(std::move(word));
+            return true;
+        }
+    };
+
+} // namespace
+
+template <> struct sk::config::parser_for<counted> {
+    using parser_type = word_parser<counted>;
+    using rule_type = counted;
+    static constexpr char const name[] = "a word";
+};
+
+template <> struct sk::config::parser_for<move_only> {
+    using parser_type = word_parser<move_only>;
+    using rule_type = move_only;
+    static constexpr char const name[] = "a word";
+};
+
+TEST_CASE("blocks are moved, not copied") {
+    namespace cfg = sk::config;
+
+    struct test_block {
+        std::string name;
+        counted value;
+        std::vector<counted> values;
+        std::set<counted> set;
+        std::map<std::string, counted> map;
+    };
+
+    struct test_config {
+        counted value;
+        std::vector<counted> values;
+        std::vector<test_block> list;
+        std::map<std::string, test_block> map;
+        std::unordered_map<std::string, test_block> unordered_map;
+    };
+
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("value", &test_config::value),
+        cfg::option("values", &test_config::values),
+        cfg::block<test_block>("list", &test_config::list,
+                               cfg::option("value", &test_block::value),
+                               cfg::option("values", &test_block::values),
+                               cfg::option("set", &test_block::set),
+                               cfg::option("map", &test_block::map)),
+        cfg::block<test_block>("map", &test_block::name, &test_config::map,
+                               cfg::option("value", &test_block::value),
+                               cfg::option("values", &test_block::values),
+                               cfg::option("set", &test_block::set),
+                               cfg::option("map", &test_block::map)),
+        cfg::block<test_block>("umap", &test_block::name,
+                               &test_config::unordered_map,
+                               cfg::option("value", &test_block::value),
+                               cfg::option("values", &test_block::values),
+                               cfg::option("set", &test_block::set),
+                               cfg::option("map", &test_block::map)));
+
+    auto block_body = R"({
+    value x;
+    values a, b, c;
+    values d;
+    set a, b, c;
+    map { a x; b y; };
+};
+)";
+
+    std::string input = "value x;\nvalues a, b;\nvalues c;\n";
+    for (auto label : {"list", "map one", "map two", "umap one", "umap two"})
+        input += std::string(label) + " " + block_body;
+
+    counted::copies = 0;
+    test_config c;
+    cfg::parse(input, grammar, c);
+
+    REQUIRE(counted::copies == 0);
+
+    REQUIRE(*c.value.value == "x");
+    REQUIRE(c.values.size() == 3);
+    REQUIRE(c.list.size() == 1);
+    REQUIRE(c.map.size() == 2);
+    REQUIRE(c.unordered_map.size() == 2);
+
+    auto const &b = c.map.at("two");
+    REQUIRE(*b.value.value == "x");
+    REQUIRE(b.values.size() == 4);
+    REQUIRE(*b.values[3].value == "d");
+    REQUIRE(b.set.size() == 3);
+    REQUIRE(*b.map.at("b").value == "y");
+}
+
+TEST_CASE("move-only members") {
+    namespace cfg = sk::config;
+
+    struct test_block {
+        std::string name;
+        move_only value;
+        std::vector<move_only> values;
+    };
+
+    struct test_config {
+        move_only value;
+        std::vector<move_only> values;
+        std::map<std::string, test_block> blocks;
+    };
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("value", &test_config::value),
+        cfg::option("values", &test_config::values),
+        cfg::block<test_block>("block", &test_block::name,
+                               &test_config::blocks,
+                               cfg::option("value", &test_block::value),
+                               cfg::option("values", &test_block::values)));
+
+    test_config c;
+    cfg::parse(R"(
+value x;
+values a, b;
+block one {
+    value y;
+    values c;
+    values d;
+};
+)",
+               grammar, c);
+
+    REQUIRE(*c.value.value == "x");
+    REQUIRE(c.values.size() == 2);
+    REQUIRE(*c.blocks.at("one").value.value == "y");
+    REQUIRE(c.blocks.at("one").values.size() == 2);
+    REQUIRE(*c.blocks.at("one").values[1].value == "d");
+}
+
+TEST_CASE("move-only members in included files") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        move_only value;
+        std::vector<move_only> values;
+    };
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("value", &test_config::value),
+        cfg::option("values", &test_config::values));
+
+    auto dir = std::filesystem::temp_directory_path() /
+               "sk_config_test_move_include";
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "common.conf") << "values a, b;\nvalue x;\n";
+
+    auto main = dir / "main.conf";
+    std::ofstream(main) << "include \"common.conf\";\n"
+                           "values c;\n"
+                           "include \"common.conf\";\n";
+
+    // The cached fragment is parsed again each time it's applied, since
+    // its values can't be copied.
+    cfg::include_cache cache;
+    auto const grammar_ =
+        x3::with<cfg::include_cache_tag>(std::ref(cache))[grammar];
+
+    for (int i = 0; i < 2; ++i) {
+        test_config c;
+        cfg::parse_file<include_policy>(main, grammar_, c);
+
+        REQUIRE(*c.value.value == "x");
+        REQUIRE(c.values.size() == 5);
+        REQUIRE(*c.values[0].value == "a");
+        REQUIRE(*c.values[2].value == "c");
+        REQUIRE(*c.values[4].value == "b");
+    }
+
+    REQUIRE(cache.size() == 1);
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("move-only members in nested includes") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        std::vector<move_only> values;
+    };
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("values", &test_config::values));
+
+    auto dir = std::filesystem::temp_directory_path() /
+               "sk_config_test_move_nested";
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "leaf.conf") << "values a;\n";
+    std::ofstream(dir / "common.conf") << "include \"leaf.conf\";\n"
+                                          "values b;\n";
+
+    auto main = dir / "main.conf";
+    std::ofstream(main) << "include \"common.conf\";\n";
+
+    auto check = [](test_config const &c) {
+        REQUIRE(c.values.size() == 2);
+        REQUIRE(*c.values[0].value == "a");
+        REQUIRE(*c.values[1].value == "b");
+    };
+
+    // The included files are applied after the parse of main.conf, and
+    // its include_cache, have gone.
+    SECTION("parse_files") {
+        test_config c;
+        std::vector<std::filesystem::path> paths{main};
+        cfg::parse_files<include_policy>(paths, grammar, c);
+        check(c);
+    }
+
+    SECTION("parse_parallel") {
+        std::string text = "include \"" + (dir / "common.conf").string() +
+                           "\";\n"
+                           "include \"" + (dir / "leaf.conf").string() +
+                           "\";\n";
+
+        test_config c;
+        cfg::parse_parallel<include_policy>(text, grammar, c, "", 1);
+        REQUIRE(c.values.size() == 3);
+        REQUIRE(*c.values[0].value == "a");
+        REQUIRE(*c.values[1].value == "b");
+        REQUIRE(*c.values[2].value == "a");
+    }
+
+    std::filesystem::remove_all(dir);
+}
@@ -28,7 +28,10 @@
 
 #include <catch.hpp>
 
+#include <cmath>
 #include <cstring>
+#include <limits>
+#include <list>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -211,3 +214,131 @@ TEST_CASE("double with int argument") {
     REQUIRE(c.v == Approx(5));
 }
 
+
+TEST_CASE("double value is not rounded to float") {
+    namespace cr = sk::config;
+
+    struct test_config {
+        double v;
+        long double lv;
+    };
+
+    auto grammar =
+        cr::config<test_config>(cr::option("v", &test_config::v),
+                                cr::option("lv", &test_config::lv));
+    test_config c;
+    sk::config::parse("v 0.1; lv 0.1;", grammar, c);
+    REQUIRE(c.v == 0.1);
+    REQUIRE(c.lv == 0.1L);
+
+    sk::config::parse("v 1.7976931348623157e308;", grammar, c);
+    REQUIRE(c.v == 1.7976931348623157e308);
+
+    // The same result on non-contiguous input.
+    std::string s = "v 0.1;";
+    std::list<char> input(s.begin(), s.end());
+    c.v = 0;
+    sk::config::parse(input.begin(), input.end(), grammar, c);
+    REQUIRE(c.v == 0.1);
+}
+
+TEST_CASE("number syntax") {
+    namespace cr = sk::config;
+
+    struct test_config {
+        long long i = 0;
+        unsigned long long u = 0;
+        double d = 0;
+    };
+
+    auto grammar = cr::config<test_config>(cr::option("i", &test_config::i),
+                                           cr::option("u", &test_config::u),
+                                           cr::option("d", &test_config::d));
+
+    auto parse = [&](std::string const &input) {
+        test_config c;
+        sk::config::parse(input, grammar, c);
+        return c;
+    };
+
+    REQUIRE(parse("i +42;").i == 42);
+    REQUIRE(parse("i -9223372036854775808;").i ==
+            std::numeric_limits<long long>::min());
+    REQUIRE(parse("u 18446744073709551615;").u ==
+            std::numeric_limits<unsigned long long>::max());
+    REQUIRE(parse("d +.5;").d == 0.5);
+    REQUIRE(parse("d -5.;").d == -5.0);
+    REQUIRE(parse("d 1e3;").d == 1000.0);
+    REQUIRE(parse("d 1E-3;").d == 0.001);
+    REQUIRE(parse("d inf;").d == std::numeric_limits<double>::infinity());
+    REQUIRE(std::isnan(parse("d nan;").d));
+
+    REQUIRE_THROWS_AS(parse("i +-1;"), sk::config::parse_error);
+    REQUIRE_THROWS_AS(parse("u -1;"), sk::config::parse_error);
+    REQUIRE_THROWS_AS(parse("u +1;"), sk::config::parse_error);
+    REQUIRE_THROWS_AS(parse("i 9223372036854775808;"),
+                      sk::config::parse_error);
+    REQUIRE_THROWS_AS(parse("d 1e400;"), sk::config::parse_error);
+    REQUIRE_THROWS_AS(parse("d .;"), sk::config::parse_error);
+}
+
+TEST_CASE("number range on non-contiguous input") {
+    namespace cr = sk::config;
+
+    struct test_config {
+        int i = 0;
+        double d = 0;
+    };
+
+    auto grammar = cr::config<test_config>(cr::option("i", &test_config::i),
+                                           cr::option("d", &test_config::d));
+
+    // Both kinds of input accept and reject the same numbers.
+    auto parse = [&](std::string const &s) {
+        test_config c;
+        std::list<char> input(s.begin(), s.end());
+        sk::config::parse(input.begin(), input.end(), grammar, c);
+        return c;
+    };
+
+    REQUIRE(parse("d 1e308;").d == 1e308);
+    REQUIRE(parse("d -2.5e-3;").d == -2.5e-3);
+    REQUIRE(parse("d inf;").d == std::numeric_limits<double>::infinity());
+    REQUIRE(parse("i -42;").i == -42);
+
+    REQUIRE_THROWS_AS(parse("d 1e400;"), sk::config::parse_error);
+    REQUIRE_THROWS_AS(parse("d 1e-400;"), sk::config::parse_error);
+    REQUIRE_THROWS_AS(parse("i 2147483648;"), sk::config::parse_error);
+
+    test_config c;
+    REQUIRE_THROWS_AS(sk::config::parse("d 1e-400;", grammar, c),
+                      sk::config::parse_error);
+}
+
+TEST_CASE("number error message") {
+    namespace cr = sk::config;
+
+    struct test_config {
+        int i = 0;
+        unsigned u = 0;
+        float f = 0;
+    };
+
+    auto grammar = cr::config<test_config>(cr::option("i", &test_config::i),
+                                           cr::option("u", &test_config::u),
+                                           cr::option("f", &test_config::f));
+
+    auto error = [&](std::string const &input) -> std::string {
+        test_config c;
+        try {
+            sk::config::parse(input, grammar, c);
+        } catch (sk::config::parse_error const &e) {
+            return e.errors.at(0).message;
+        }
+        return "";
+    };
+
+    REQUIRE(error("i x;") == "expected an integer");
+    REQUIRE(error("u -1;") == "expected a positive integer");
+    REQUIRE(error("f x;") == "expected a decimal number");
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    struct temp_file {
+        std::filesystem::path path;
+
+        temp_file(std::string const &name, std::string const &contents)
+            : path(std::filesystem::temp_directory_path() / name) {
+            std::ofstream strm(path, std::ios::binary);
+            strm << contents;
+        }
+
+        ~temp_file() {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    };
+
+    struct test_config {
+        int a = 0;
+        std::string s;
+    };
+
+    auto make_grammar() {
+        namespace cfg = sk::config;
+        return cfg::config<test_config>(cfg::option("a", &test_config::a),
+                                        cfg::option("s", &test_config::s));
+    }
+
+} // namespace
+
+TEST_CASE("parse_file") {
+    namespace cfg = sk::config;
+
+    temp_file f("sk_config_test_parse_file.conf",
+                "# comment\na 42;\ns <<<END\nheredoc\nEND;\n");
+
+    test_config c;
+    cfg::parse_file(f.path, make_grammar(), c);
+
+    REQUIRE(c.a == 42);
+    REQUIRE(c.s == "heredoc");
+}
+
+TEST_CASE("parse_file empty file") {
+    namespace cfg = sk::config;
+
+    temp_file f("sk_config_test_parse_file_empty.conf", "");
+
+    test_config c;
+    cfg::parse_file(f.path, make_grammar(), c);
+
+    REQUIRE(c.a == 0);
+}
+
+TEST_CASE("parse_file error position") {
+    namespace cfg = sk::config;
+
+    temp_file f("sk_config_test_parse_file_error.conf",
+                "a 1;\n\n  s 'foo';\na 'x';\n");
+
+    test_config c;
+    try {
+        cfg::parse_file(f.path, make_grammar(), c);
+        FAIL("expected parse_error");
+    } catch (cfg::parse_error const &e) {
+        REQUIRE(e.errors.size() == 1);
+        REQUIRE(e.errors[0].line == 4);
+        REQUIRE(e.errors[0].column == 2);
+        REQUIRE(e.errors[0].context == "a 'x';");
+        REQUIRE(e.errors[0].message == "expected an integer");
+        REQUIRE(e.errors[0].file == f.path.string());
+    }
+}
+
+TEST_CASE("parse_file missing file") {
+    namespace cfg = sk::config;
+
+    test_config c;
+    try {
+        cfg::parse_file("sk_config_this_file_does_not_exist.conf",
+                        make_grammar(), c);
+        FAIL("expected parse_error");
+    } catch (cfg::parse_error const &e) {
+        REQUIRE(e.errors.size() == 1);
+        REQUIRE(e.errors[0].line == 0);
+        REQUIRE(std::string(e.what()).find("cannot read file") !=
+                std::string::npos);
+    }
+}
+
+TEST_CASE("parse_file error inside the parse") {
+    namespace cfg = sk::config;
+    namespace x3 = boost::spirit::x3;
+
+    temp_file f("sk_config_test_parse_file_system_error.conf", "a 1;\n");
+
+    // A system_error from the parse isn't an error opening the file.
+    auto fail = [](auto &) {
+        throw std::system_error(
+            std::make_error_code(std::errc::permission_denied));
+    };
+    auto grammar = cfg::config<test_config>(
+        cfg::option("a", &test_config::a, x3::int_[fail]));
+
+    test_config c;
+    REQUIRE_THROWS_AS(cfg::parse_file(f.path, grammar, c), std::system_error);
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    struct temp_directory {
+        std::filesystem::path path;
+
+        explicit temp_directory(std::string const &name)
+            : path(std::filesystem::temp_directory_path() / name) {
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+        }
+
+        ~temp_directory() {
+            std::error_code ec;
+            std::filesystem::remove_all(path, ec);
+        }
+
+        auto write(std::string const &name, std::string const &contents)
+            -> std::filesystem::path {
+            auto p = path / name;
+            std::ofstream strm(p, std::ios::binary);
+            strm << contents;
+            return p;
+        }
+    };
+
+    struct user {
+        std::string name;
+        int uid = 0;
+        bool admin = false;
+    };
+
+    struct test_config {
+        std::map<std::string, user> users;
+        std::vector<int> numbers;
+        std::string motd;
+        bool debug = false;
+    };
+
+    auto make_grammar() {
+        namespace cfg = sk::config;
+        return cfg::config<test_config>(
+            cfg::block<user>("user", &user::name, &test_config::users,
+                             cfg::option("uid", &user::uid),
+                             cfg::option("admin", &user::admin)),
+            cfg::option("number", &test_config::numbers),
+            cfg::option("motd", &test_config::motd),
+            cfg::option("debug", &test_config::debug));
+    }
+
+} // namespace
+
+TEST_CASE("parse_files") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_parse_files");
+
+    std::vector<std::filesystem::path> paths;
+    for (int i = 0; i < 20; ++i) {
+        std::string text = "user u" + std::to_string(i) + " { uid " +
+                           std::to_string(i) + "; };\n" + "number " +
+                           std::to_string(i) + ";\n" + "motd m" +
+                           std::to_string(i) + ";\n";
+        if (i == 3)
+            text += "debug;\n";
+        paths.push_back(dir.write("f" + std::to_string(i), text));
+    }
+
+    test_config c;
+    cfg::parse_files(paths, make_grammar(), c);
+
+    REQUIRE(c.users.size() == 20);
+    REQUIRE(c.users.at("u7").uid == 7);
+    REQUIRE(c.numbers.size() == 20);
+    for (int i = 0; i < 20; ++i)
+        REQUIRE(c.numbers[i] == i);
+
+    // Later files override earlier ones, but only for options they set.
+    REQUIRE(c.motd == "m19");
+    REQUIRE(c.debug == true);
+}
+
+TEST_CASE("parse_files duplicate key") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_parse_files_dup");
+
+    std::vector<std::filesystem::path> paths{
+        dir.write("a.conf", "user alice { uid 1; };\n"),
+        dir.write("b.conf", "number 1;\n\nuser alice { uid 2; };\n"),
+    };
+
+    test_config c;
+    try {
+        cfg::parse_files(paths, make_grammar(), c);
+        FAIL("expected parse_error");
+    } catch (cfg::parse_error const &e) {
+        REQUIRE(e.errors.size() == 1);
+        REQUIRE(e.errors[0].file == paths[1].string());
+        REQUIRE(e.errors[0].message == "expected unique value");
+    }
+}
+
+TEST_CASE("parse_files reports the first error") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_parse_files_error");
+
+    std::vector<std::filesystem::path> paths{
+        dir.write("a.conf", "number 1;\n"),
+        dir.write("b.conf", "number 'x';\n"),
+        dir.path / "missing.conf",
+    };
+
+    test_config c;
+    try {
+        cfg::parse_files(paths, make_grammar(), c);
+        FAIL("expected parse_error");
+    } catch (cfg::parse_error const &e) {
+        REQUIRE(e.errors.size() > 0);
+        REQUIRE(e.errors[0].file == paths[1].string());
+        REQUIRE(e.errors[0].line == 1);
+    }
+
+    // Files before the error have been merged.
+    REQUIRE(c.numbers == std::vector<int>{1});
+}
+
+TEST_CASE("parse_directory") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_parse_directory");
+
+    dir.write("20-second.conf", "number 2;\n");
+    dir.write("10-first.conf", "number 1;\n");
+    dir.write("30-third.conf", "number 3;\n");
+    dir.write("40-ignored.txt", "number 4;\n");
+    dir.write(".50-hidden.conf", "number 5;\n");
+    std::filesystem::create_directory(dir.path / "60-dir.conf");
+
+    test_config c;
+    cfg::parse_directory(dir.path, make_grammar(), c);
+
+    REQUIRE(c.numbers == std::vector<int>{1, 2, 3});
+}
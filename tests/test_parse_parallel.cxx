@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    struct user {
+        std::string name;
+        int uid = 0;
+        bool admin = false;
+    };
+
+    struct test_config {
+        std::map<std::string, user> users;
+        std::vector<int> numbers;
+        std::string motd;
+        bool debug = false;
+    };
+
+    auto make_grammar() {
+        namespace cfg = sk::config;
+        return cfg::config<test_config>(
+            cfg::block<user>("user", &user::name, &test_config::users,
+                             cfg::option("uid", &user::uid),
+                             cfg::option("admin", &user::admin)),
+            cfg::option("number", &test_config::numbers),
+            cfg::option("motd", &test_config::motd),
+            cfg::option("debug", &test_config::debug));
+    }
+
+    auto make_text(int n) {
+        std::string text;
+        for (int i = 0; i < n; ++i) {
+            text += "# entry " + std::to_string(i) + "\n";
+            text += "user u" + std::to_string(i) + " {\n";
+            text += "    uid " + std::to_string(i) + ";\n";
+            if (i % 7 == 0)
+                text += "    admin;\n";
+            text += "};\n";
+            text += "number " + std::to_string(i) + "; motd 'm;" +
+                    std::to_string(i) + "';\n";
+        }
+        return text;
+    }
+
+} // namespace
+
+TEST_CASE("parse_parallel") {
+    namespace cfg = sk::config;
+
+    auto text = make_text(500);
+
+    test_config expected;
+    cfg::parse(text, make_grammar(), expected);
+
+    for (std::size_t shard_size : {0, 1, 100, 4096}) {
+        test_config c;
+        cfg::parse_parallel(text, make_grammar(), c, "", shard_size);
+
+        REQUIRE(c.users.size() == expected.users.size());
+        for (auto &&[name, u] : expected.users) {
+            REQUIRE(c.users.at(name).uid == u.uid);
+            REQUIRE(c.users.at(name).admin == u.admin);
+        }
+        REQUIRE(c.numbers == expected.numbers);
+        REQUIRE(c.motd == expected.motd);
+        REQUIRE(c.debug == expected.debug);
+    }
+}
+
+TEST_CASE("parse_parallel error line numbers") {
+    namespace cfg = sk::config;
+
+    auto text = make_text(100);
+    text += "\r\nnumber 1;\nnumber 'x';\n";
+
+    test_config c;
+    try {
+        cfg::parse_parallel(text, make_grammar(), c, "test.conf", 64);
+        FAIL("expected parse_error");
+    } catch (cfg::parse_error const &e) {
+        REQUIRE(e.errors.size() > 0);
+        REQUIRE(e.errors[0].file == "test.conf");
+        REQUIRE(e.errors[0].line == 100 * 5 + 15 + 3);
+    }
+}
+
+TEST_CASE("parse_parallel duplicate key across shards") {
+    namespace cfg = sk::config;
+
+    auto text = make_text(50) + "user u3 { uid 1; };\n";
+
+    test_config c;
+    REQUIRE_THROWS_AS(cfg::parse_parallel(text, make_grammar(), c, "", 1),
+                      cfg::parse_error);
+}
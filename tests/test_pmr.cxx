@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <deque>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    namespace cfg = sk::config;
+
+    struct test_block {
+        std::pmr::string name;
+        std::pmr::string value;
+        std::pmr::vector<std::pmr::string> items;
+    };
+
+    struct test_config {
+        std::pmr::string string;
+        std::pmr::vector<int> vector;
+        std::pmr::vector<std::pmr::string> strings;
+        std::pmr::list<int> list;
+        std::pmr::deque<int> deque;
+        std::pmr::set<std::pmr::string> set;
+        std::pmr::unordered_set<int> unordered_set;
+        std::pmr::map<std::pmr::string, int> map;
+        std::pmr::unordered_map<std::pmr::string, std::pmr::string>
+            unordered_map;
+        std::pmr::map<std::pmr::string, test_block> blocks;
+        std::pmr::vector<test_block> anonymous_blocks;
+    };
+
+
+    auto const grammar = cfg::config<test_config>(
+        cfg::option("string", &test_config::string),
+        cfg::option("vector", &test_config::vector),
+        cfg::option("strings", &test_config::strings),
+        cfg::option("list", &test_config::list),
+        cfg::option("deque", &test_config::deque),
+        cfg::option("set", &test_config::set),
+        cfg::option("unordered-set", &test_config::unordered_set),
+        cfg::option("map", &test_config::map),
+        cfg::option("unordered-map", &test_config::unordered_map),
+        cfg::block<test_block>("block", &test_block::name,
+                               &test_config::blocks,
+                               cfg::option("value", &test_block::value),
+                               cfg::option("items", &test_block::items)),
+        cfg::block<test_block>("anonymous-block",
+                               &test_config::anonymous_blocks,
+                               cfg::option("value", &test_block::value),
+                               cfg::option("items", &test_block::items)));
+
+    // Strings are longer than the small string buffer, so they allocate.
+    auto const input = R"(
+string "a string which is long enough to allocate";
+vector 1, 2, 3;
+strings "first string which allocates", "second string which allocates";
+list 1, 2;
+deque 3, 4;
+set "set item which is long enough", "another set item which is long";
+unordered-set 5, 6;
+map {
+    "map key which is long enough" 1;
+    "another map key which is long" 2;
+};
+unordered-map {
+    "unordered map key which is long" "unordered map value which is long";
+};
+block "a block name which is long enough" {
+    value "a block value which is long enough";
+    items "a block item which is long enough";
+};
+anonymous-block {
+    value "an anonymous block value which is long";
+};
+)";
+
+    /*
+     * A memory resource which counts the bytes allocated from it.
+     */
+    struct counting_resource : std::pmr::memory_resource {
+        std::size_t allocated = 0;
+
+        auto do_allocate(std::size_t bytes, std::size_t alignment)
+            -> void * override {
+            allocated += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, std::size_t bytes,
+                           std::size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        auto do_is_equal(std::pmr::memory_resource const &other) const noexcept
+            -> bool override {
+            return this == &other;
+        }
+    };
+
+} // namespace
+
+TEST_CASE("pmr containers with the default resource") {
+    test_config c;
+    cfg::parse(input, grammar, c);
+
+    REQUIRE(c.string == "a string which is long enough to allocate");
+    REQUIRE(c.vector == std::pmr::vector<int>{1, 2, 3});
+    REQUIRE(c.strings.size() == 2);
+    REQUIRE(c.strings[1] == "second string which allocates");
+    REQUIRE(c.list == std::pmr::list<int>{1, 2});
+    REQUIRE(c.deque == std::pmr::deque<int>{3, 4});
+    REQUIRE(c.set.contains("another set item which is long"));
+    REQUIRE(c.unordered_set.contains(6));
+    REQUIRE(c.map.at("another map key which is long") == 2);
+    REQUIRE(c.unordered_map.at("unordered map key which is long") ==
+            "unordered map value which is long");
+    REQUIRE(c.blocks.at("a block name which is long enough").value ==
+            "a block value which is long enough");
+    REQUIRE(c.anonymous_blocks.at(0).value ==
+            "an anonymous block value which is long");
+}
+
+TEST_CASE("pmr containers are allocated from the parse's resource") {
+    counting_resource counter;
+    std::pmr::monotonic_buffer_resource arena(&counter);
+
+    test_config c;
+    cfg::parse(input, grammar, c, &arena);
+
+    REQUIRE(counter.allocated > 0);
+
+    auto check = [&](auto const &v) {
+        REQUIRE(v.get_allocator().resource() == &arena);
+    };
+
+    check(c.string);
+    check(c.vector);
+    check(c.strings);
+    for (auto const &s : c.strings)
+        check(s);
+    check(c.list);
+    check(c.deque);
+    check(c.set);
+    for (auto const &s : c.set)
+        check(s);
+    check(c.unordered_set);
+    check(c.map);
+    for (auto const &[k, v] : c.map)
+        check(k);
+    check(c.unordered_map);
+    for (auto const &[k, v] : c.unordered_map) {
+        check(k);
+        check(v);
+    }
+    check(c.blocks);
+    for (auto const &[k, b] : c.blocks) {
+        check(k);
+        check(b.name);
+        check(b.value);
+        check(b.items);
+        for (auto const &s : b.items)
+            check(s);
+    }
+    check(c.anonymous_blocks);
+    check(c.anonymous_blocks.at(0).value);
+
+    REQUIRE(c.strings[0] == "first string which allocates");
+    REQUIRE(c.map.at("map key which is long enough") == 1);
+    REQUIRE(c.blocks.at("a block name which is long enough").items.at(0) ==
+            "a block item which is long enough");
+}
+
+TEST_CASE("pmr containers keep values parsed before the resource") {
+    std::pmr::monotonic_buffer_resource arena;
+
+    test_config c;
+    c.vector = {1};
+    c.set.insert("a set item which was there before");
+
+    cfg::parse("vector 2; set \"a new set item which is long\";", grammar, c,
+               &arena);
+
+    REQUIRE(c.vector == std::pmr::vector<int>{1, 2});
+    REQUIRE(c.vector.get_allocator().resource() == &arena);
+    REQUIRE(c.set.size() == 2);
+    REQUIRE(c.set.contains("a set item which was there before"));
+    for (auto const &s : c.set)
+        REQUIRE(s.get_allocator().resource() == &arena);
+}
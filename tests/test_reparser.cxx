@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    struct user {
+        std::string name;
+        int uid = 0;
+    };
+
+    struct test_config {
+        std::map<std::string, user> users;
+        std::vector<int> numbers;
+        std::string motd;
+    };
+
+    auto make_grammar() {
+        namespace cfg = sk::config;
+        return cfg::config<test_config>(
+            cfg::block<user>("user", &user::name, &test_config::users,
+                             cfg::option("uid", &user::uid)),
+            cfg::option("number", &test_config::numbers),
+            cfg::option("motd", &test_config::motd));
+    }
+
+} // namespace
+
+TEST_CASE("reparser") {
+    namespace cfg = sk::config;
+
+    auto parser = cfg::make_reparser<test_config>(make_grammar(), "test.conf");
+
+    std::string text = "motd 'hello';\n"
+                       "user alice { uid 1; };\n"
+                       "user bob {\n"
+                       "    uid 2;\n"
+                       "};\n"
+                       "number 1; number 2;\n";
+
+    test_config c;
+    parser.parse(text, c);
+    REQUIRE(parser.parsed() == 5);
+    REQUIRE(parser.reused() == 0);
+    REQUIRE(c.users.size() == 2);
+    REQUIRE(c.numbers == std::vector<int>{1, 2});
+
+    // Parsing the same text again doesn't parse anything.
+    parser.parse(text, c);
+    REQUIRE(parser.parsed() == 0);
+    REQUIRE(parser.reused() == 5);
+    REQUIRE(c.users.size() == 2);
+    REQUIRE(c.numbers == std::vector<int>{1, 2});
+
+    // Change one statement, remove one and add one.
+    text = "motd 'hello';\n"
+           "user bob {\n"
+           "    uid 3;\n"
+           "};\n"
+           "user carol { uid 4; };\n"
+           "number 1; number 2;\n";
+
+    parser.parse(text, c);
+    REQUIRE(parser.parsed() == 2);
+    REQUIRE(parser.reused() == 3);
+    REQUIRE(c.motd == "hello");
+    REQUIRE(c.users.size() == 2);
+    REQUIRE(c.users.at("bob").uid == 3);
+    REQUIRE(c.users.at("carol").uid == 4);
+    REQUIRE(c.numbers == std::vector<int>{1, 2});
+}
+
+TEST_CASE("reparser errors") {
+    namespace cfg = sk::config;
+
+    auto parser = cfg::make_reparser<test_config>(make_grammar(), "test.conf");
+
+    std::string text = "user alice { uid 1; };\n"
+                       "number 1;\n";
+
+    test_config c;
+    parser.parse(text, c);
+
+    SECTION("syntax error") {
+        text = "user alice { uid 1; };\n"
+               "\n"
+               "number 'x';\n";
+        try {
+            parser.parse(text, c);
+            FAIL("expected parse_error");
+        } catch (cfg::parse_error const &e) {
+            REQUIRE(e.errors.size() > 0);
+            REQUIRE(e.errors[0].file == "test.conf");
+            REQUIRE(e.errors[0].line == 3);
+        }
+    }
+
+    SECTION("duplicate key in an unchanged statement") {
+        text = "user alice { uid 2; };\n"
+               "user alice { uid 1; };\n";
+        try {
+            parser.parse(text, c);
+            FAIL("expected parse_error");
+        } catch (cfg::parse_error const &e) {
+            REQUIRE(e.errors.size() == 1);
+            REQUIRE(e.errors[0].message == "expected unique value");
+        }
+    }
+
+    // After an error, ret is unchanged.
+    REQUIRE(c.users.at("alice").uid == 1);
+    REQUIRE(c.numbers == std::vector<int>{1});
+}
+
+TEST_CASE("reparser updates the previous result") {
+    namespace cfg = sk::config;
+
+    auto parser = cfg::make_reparser<test_config>(make_grammar(), "test.conf");
+
+    std::string text = "motd 'hello';\n"
+                       "user alice { uid 1; };\n"
+                       "user bob { uid 2; };\n"
+                       "number 1;\n"
+                       "number 2;\n";
+
+    test_config c;
+    parser.parse(text, c);
+    REQUIRE(!parser.updated());
+
+    auto const *alice = &c.users.at("alice");
+
+    SECTION("named blocks") {
+        text = "motd 'hello';\n"
+               "user alice { uid 1; };\n"
+               "user bob { uid 3; };\n"
+               "user carol { uid 4; };\n"
+               "number 1;\n"
+               "number 2;\n";
+
+        parser.parse(text, c);
+        REQUIRE(parser.updated());
+        REQUIRE(parser.parsed() == 2);
+        REQUIRE(c.users.size() == 3);
+        REQUIRE(c.users.at("bob").uid == 3);
+        REQUIRE(c.users.at("carol").uid == 4);
+        REQUIRE(c.numbers == std::vector<int>{1, 2});
+
+        // Unchanged blocks are left where they are.
+        REQUIRE(&c.users.at("alice") == alice);
+    }
+
+    SECTION("other members") {
+        text = "user alice { uid 1; };\n"
+               "number 2;\n"
+               "user bob { uid 2; };\n"
+               "number 1;\n"
+               "number 3;\n";
+
+        parser.parse(text, c);
+        REQUIRE(parser.updated());
+        REQUIRE(parser.parsed() == 1);
+        REQUIRE(c.motd.empty());
+        REQUIRE(c.numbers == std::vector<int>{2, 1, 3});
+        REQUIRE(c.users.size() == 2);
+        REQUIRE(&c.users.at("alice") == alice);
+    }
+
+    SECTION("errors") {
+        auto bad = text + "user alice { uid 5; };\n";
+        REQUIRE_THROWS_AS(parser.parse(bad, c), cfg::parse_error);
+        REQUIRE(c.users.size() == 2);
+        REQUIRE(c.users.at("alice").uid == 1);
+        REQUIRE(c.numbers == std::vector<int>{1, 2});
+
+        text += "user carol { uid 4; };\n";
+        parser.parse(text, c);
+        REQUIRE(parser.updated());
+        REQUIRE(c.users.size() == 3);
+    }
+
+    SECTION("another object") {
+        test_config d;
+        parser.parse(text, d);
+        REQUIRE(!parser.updated());
+        REQUIRE(d.users.size() == 2);
+        REQUIRE(d.numbers == std::vector<int>{1, 2});
+    }
+}
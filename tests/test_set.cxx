@@ -79,3 +79,56 @@ int-value 42;
 )",
                                      grammar, c));
 }
+
+TEST_CASE("std::set<int> with many values") {
+    namespace cr = sk::config;
+
+    struct test_config {
+        std::set<int> items;
+    };
+
+    auto grammar =
+        cr::config<test_config>(cr::option("int-value", &test_config::items));
+
+    // Values out of order, over several options which overlap in range.
+    std::string input;
+    for (int i = 0; i < 3; ++i) {
+        input += "int-value ";
+        for (int j = 0; j < 10000; ++j) {
+            if (j)
+                input += ", ";
+            input += std::to_string((j * 7919 % 10000) * 3 + i);
+        }
+        input += ";\n";
+    }
+
+    test_config c;
+    sk::config::parse(input, grammar, c);
+
+    REQUIRE(c.items.size() == 30000);
+    for (int i = 0; i < 30000; ++i)
+        REQUIRE(c.items.contains(i));
+}
+
+TEST_CASE("std::set<int> reports a duplicate in the same option") {
+    namespace cr = sk::config;
+
+    struct test_config {
+        std::set<int> items;
+    };
+
+    auto grammar =
+        cr::config<test_config>(cr::option("int-value", &test_config::items));
+    test_config c;
+
+    // The error is reported at the end of the option's value.
+    try {
+        sk::config::parse("int-value 1;\nint-value 5, 3, 4, 3, 2;\n",
+                          grammar, c);
+        FAIL("no exception");
+    } catch (sk::config::parse_error const &e) {
+        REQUIRE(e.errors.at(0).message == "expected unique value");
+        REQUIRE(e.errors.at(0).line == 2);
+        REQUIRE(e.errors.at(0).column == 23);
+    }
+}
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    struct temp_directory {
+        std::filesystem::path path;
+
+        explicit temp_directory(std::string const &name)
+            : path(std::filesystem::temp_directory_path() / name) {
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+        }
+
+        ~temp_directory() {
+            std::error_code ec;
+            std::filesystem::remove_all(path, ec);
+        }
+
+        auto write(std::string const &name, std::string const &contents)
+            -> std::filesystem::path {
+            auto p = path / name;
+            std::ofstream strm(p, std::ios::binary | std::ios::trunc);
+            strm << contents;
+            return p;
+        }
+    };
+
+    struct user {
+        std::string name;
+        int uid = 0;
+        bool admin = false;
+    };
+
+    struct test_config {
+        std::map<std::string, user> users;
+        std::vector<int> numbers;
+        std::string motd;
+    };
+
+    auto make_grammar() {
+        namespace cfg = sk::config;
+        return cfg::config<test_config>(
+            cfg::block<user>("user", &user::name, &test_config::users,
+                             cfg::option("uid", &user::uid),
+                             cfg::option("admin", &user::admin)),
+            cfg::option("number", &test_config::numbers),
+            cfg::option("motd", &test_config::motd));
+    }
+
+    char const *test_text = R"(
+        user alice { uid 1000; admin; };
+        user bob { uid 1001; };
+        number 1;
+        number 2;
+        motd "hello, world";
+    )";
+
+    void check(test_config const &config) {
+        REQUIRE(config.users.size() == 2);
+        REQUIRE(config.users.at("alice").uid == 1000);
+        REQUIRE(config.users.at("alice").admin == true);
+        REQUIRE(config.users.at("bob").uid == 1001);
+        REQUIRE(config.users.at("bob").admin == false);
+        REQUIRE(config.numbers == std::vector{1, 2});
+        REQUIRE(config.motd == "hello, world");
+    }
+
+    struct include_policy : sk::config::parser_policy {
+        static constexpr bool allow_include = true;
+    };
+
+    struct newline_policy : sk::config::parser_policy {
+        static constexpr auto option_terminator() {
+            return boost::spirit::x3::eol;
+        }
+    };
+
+} // namespace
+
+TEST_CASE("parse_file_cached") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_snapshot");
+    auto path = dir.write("test.conf", test_text);
+    auto cache = dir.path / "cache";
+
+    test_config first;
+    REQUIRE(cfg::parse_file_cached(path, make_grammar(), first, cache) ==
+            false);
+    check(first);
+
+    test_config second;
+    REQUIRE(cfg::parse_file_cached(path, make_grammar(), second, cache) ==
+            true);
+    check(second);
+}
+
+TEST_CASE("parse_file_cached reparses a changed file") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_snapshot_changed");
+    auto path = dir.write("test.conf", test_text);
+    auto cache = dir.path / "cache";
+
+    test_config config;
+    cfg::parse_file_cached(path, make_grammar(), config, cache);
+
+    dir.write("test.conf", "number 42;\n");
+    REQUIRE(cfg::parse_file_cached(path, make_grammar(), config, cache) ==
+            false);
+    REQUIRE(config.users.empty());
+    REQUIRE(config.numbers == std::vector{42});
+    REQUIRE(config.motd.empty());
+}
+
+TEST_CASE("parse_file_cached reparses when a glob matches a new file") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_snapshot_glob");
+    std::filesystem::create_directories(dir.path / "conf.d");
+    dir.write("conf.d/1.conf", "number 1;\n");
+    auto path = dir.write("test.conf", "include \"conf.d/*.conf\";\n");
+    auto cache = dir.path / "cache";
+
+    test_config config;
+    REQUIRE(cfg::parse_file_cached<include_policy>(path, make_grammar(),
+                                                   config, cache) == false);
+    REQUIRE(config.numbers == std::vector{1});
+
+    REQUIRE(cfg::parse_file_cached<include_policy>(path, make_grammar(),
+                                                   config, cache) == true);
+    REQUIRE(config.numbers == std::vector{1});
+
+    dir.write("conf.d/2.conf", "number 2;\n");
+    REQUIRE(cfg::parse_file_cached<include_policy>(path, make_grammar(),
+                                                   config, cache) == false);
+    REQUIRE(config.numbers == std::vector{1, 2});
+
+    std::filesystem::remove(dir.path / "conf.d/1.conf");
+    REQUIRE(cfg::parse_file_cached<include_policy>(path, make_grammar(),
+                                                   config, cache) == false);
+    REQUIRE(config.numbers == std::vector{2});
+}
+
+TEST_CASE("parse_file_cached interns strings in the grammar's table") {
+    namespace cfg = sk::config;
+
+    struct interned_config {
+        std::vector<cfg::interned_string> names;
+    };
+
+    auto grammar = cfg::config<interned_config>(
+        cfg::option("name", &interned_config::names));
+
+    temp_directory dir("sk_config_test_snapshot_interned");
+    auto path = dir.write("test.conf", "name alice, bob, alice;\n");
+    auto cache = dir.path / "cache";
+
+    interned_config first;
+    REQUIRE(cfg::parse_file_cached(path, grammar, first, cache) == false);
+
+    cfg::intern_table table;
+    interned_config second;
+    REQUIRE(cfg::parse_file_cached(
+                path, cfg::with_intern_table(table, grammar), second,
+                cache) == true);
+    REQUIRE(second.names == first.names);
+    REQUIRE(table.size() == 2);
+    REQUIRE(second.names[0].c_str() == table.intern("alice").c_str());
+    REQUIRE(second.names[2].c_str() == second.names[0].c_str());
+}
+
+TEST_CASE("parse_file_cached rejects a snapshot from another grammar") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_snapshot_grammar");
+    auto path = dir.write("test.conf", "number 1;\nmotd \"x\";\n");
+    auto cache = dir.path / "cache";
+
+    test_config config;
+    cfg::parse_file_cached(path, make_grammar(), config, cache);
+
+    // Same type, but a different set of options.
+    auto other = cfg::config<test_config>(
+        cfg::option("number", &test_config::numbers),
+        cfg::option("motd", &test_config::motd));
+
+    test_config other_config;
+    REQUIRE(cfg::parse_file_cached(path, other, other_config, cache) ==
+            false);
+    REQUIRE(other_config.numbers == std::vector{1});
+    REQUIRE(other_config.motd == "x");
+}
+
+TEST_CASE("parse_file_cached rejects a snapshot from another policy") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_snapshot_policy");
+    auto path = dir.write("test.conf", "number 1;\nnumber 2;\n");
+    auto cache = dir.path / "cache";
+
+    test_config config;
+    REQUIRE(cfg::parse_file_cached<include_policy>(path, make_grammar(),
+                                                   config, cache) == false);
+    REQUIRE(cfg::parse_file_cached<include_policy>(path, make_grammar(),
+                                                   config, cache) == true);
+
+    // The default policy doesn't allow includes, so it can't use a
+    // snapshot which might contain included files.
+    REQUIRE(cfg::parse_file_cached(path, make_grammar(), config, cache) ==
+            false);
+    REQUIRE(cfg::parse_file_cached(path, make_grammar(), config, cache) ==
+            true);
+
+    // With a different terminator, the same text doesn't parse.
+    REQUIRE_THROWS_AS(cfg::parse_file_cached<newline_policy>(
+                          path, make_grammar(), config, cache),
+                      cfg::parse_error);
+}
+
+TEST_CASE("parse_file_cached ignores a corrupt snapshot") {
+    namespace cfg = sk::config;
+
+    temp_directory dir("sk_config_test_snapshot_corrupt");
+    auto path = dir.write("test.conf", test_text);
+    auto cache = dir.path / "cache";
+
+    test_config config;
+    cfg::parse_file_cached(path, make_grammar(), config, cache);
+
+    for (auto &&entry : std::filesystem::directory_iterator(cache)) {
+        auto size = std::filesystem::file_size(entry.path());
+        std::filesystem::resize_file(entry.path(), size - 3);
+    }
+
+    test_config result;
+    REQUIRE(cfg::parse_file_cached(path, make_grammar(), result, cache) ==
+            false);
+    check(result);
+}
+
+TEST_CASE("snapshot round trip") {
+    namespace cfg = sk::config;
+
+    cfg::snapshot_writer w;
+    w.write_string("hello");
+    w.write(std::uint32_t(42));
+
+    cfg::snapshot_reader r(w.data());
+    std::string s;
+    std::uint32_t n = 0;
+    r.read_string(s);
+    r.read(n);
+    REQUIRE(s == "hello");
+    REQUIRE(n == 42);
+    REQUIRE(r.at_end());
+
+    REQUIRE_THROWS_AS(r.read(n), cfg::snapshot_error);
+}
+
+TEST_CASE("snapshot rejects a truncated wide string") {
+    namespace cfg = sk::config;
+
+    // A wide string whose size isn't a whole number of characters.
+    cfg::snapshot_writer w;
+    w.write_size(sizeof(wchar_t) + 1);
+    w.write_bytes(L"ab", sizeof(wchar_t) + 1);
+
+    {
+        cfg::snapshot_reader r(w.data());
+        std::wstring s;
+        REQUIRE_THROWS_AS(r.read_string(s), cfg::snapshot_error);
+    }
+
+    {
+        cfg::snapshot_reader r(w.data());
+        std::u32string s;
+        REQUIRE_THROWS_AS(cfg::snapshot_traits<std::u32string>::read(r, s),
+                          cfg::snapshot_error);
+    }
+}
@@ -34,6 +34,7 @@
 #include <string>
 
 #include <sk/config/config.hxx>
+#include <sk/config/detail/scan.hxx>
 #include <sk/config/option.hxx>
 #include <sk/config/parse.hxx>
 #include <sk/config/parser/string.hxx>
@@ -107,3 +108,116 @@ END;
 
     REQUIRE(c.v == "This is a long string which can have\nembedded newlines.");
 }
+
+TEST_CASE("heredoc terminator") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        std::string v;
+    };
+
+    auto grammar = cfg::config<test_config>(cfg::option("v", &test_config::v));
+    test_config c;
+
+    SECTION("token inside a line") {
+        cfg::parse("v <<<END\nnot END\n xENDING\nEND;", grammar, c);
+        REQUIRE(c.v == "not END\n xENDING");
+    }
+
+    SECTION("CRLF line endings") {
+        cfg::parse("v <<<END\r\none\r\ntwo\r\nEND;", grammar, c);
+        REQUIRE(c.v == "one\r\ntwo");
+    }
+
+    SECTION("CR line endings") {
+        cfg::parse("v <<<END\rone\rEND;", grammar, c);
+        REQUIRE(c.v == "one");
+    }
+
+    SECTION("large body") {
+        std::string line = "echo \"END of line\" | grep -v ENDING\n";
+        std::string body;
+        while (body.size() < 1024 * 1024)
+            body += line;
+
+        cfg::parse("v <<<END\n" + body + "END;", grammar, c);
+        body.pop_back();
+        REQUIRE(c.v == body);
+    }
+
+    SECTION("no terminator") {
+        REQUIRE_THROWS_AS(cfg::parse("v <<<END\nbody\nEN", grammar, c),
+                          cfg::parse_error);
+    }
+
+    SECTION("empty body") {
+        REQUIRE_THROWS_AS(cfg::parse("v <<<END\n\nEND;", grammar, c),
+                          cfg::parse_error);
+        REQUIRE_THROWS_AS(cfg::parse("v <<<END\n", grammar, c),
+                          cfg::parse_error);
+    }
+}
+
+TEST_CASE("long quoted string") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        std::string v;
+    };
+
+    // Put escapes at every offset, so they fall in different places in the
+    // scanner's blocks.
+    std::string input = "v \"";
+    std::string expected;
+    for (int i = 0; i < 200; ++i) {
+        auto run = std::string(static_cast<std::size_t>(i % 37), 'x');
+        input += run + "\\\"" + run + "\\n'";
+        expected += run + "\"" + run + "\n'";
+    }
+    input += "\";";
+
+    auto grammar = cfg::config<test_config>(cfg::option("v", &test_config::v));
+    test_config c;
+    cfg::parse(input, grammar, c);
+    REQUIRE(c.v == expected);
+}
+
+TEST_CASE("invalid quoted string") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        std::string v;
+    };
+
+    auto grammar = cfg::config<test_config>(cfg::option("v", &test_config::v));
+    test_config c;
+
+    auto long_ = std::string(100, 'x');
+    REQUIRE_THROWS_AS(cfg::parse("v \"" + long_ + "\\q\";", grammar, c),
+                      cfg::parse_error);
+    REQUIRE_THROWS_AS(cfg::parse("v \"" + long_, grammar, c),
+                      cfg::parse_error);
+    REQUIRE_THROWS_AS(cfg::parse("v \"" + long_ + "\\", grammar, c),
+                      cfg::parse_error);
+    REQUIRE_THROWS_AS(cfg::parse("v '" + long_ + "\\\"';", grammar, c),
+                      cfg::parse_error);
+}
+
+TEST_CASE("find_either") {
+    using sk::config::detail::find_either;
+
+    for (std::size_t size = 0; size < 100; ++size) {
+        std::string s(size, 'x');
+        REQUIRE(find_either(s.data(), s.data() + size, 'a', 'b') ==
+                s.data() + size);
+
+        for (std::size_t i = 0; i < size; ++i) {
+            auto t = s;
+            t[i] = (i % 2) ? 'a' : 'b';
+            if (i + 1 < size)
+                t[i + 1] = 'a';
+            REQUIRE(find_either(t.data(), t.data() + size, 'a', 'b') ==
+                    t.data() + i);
+        }
+    }
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sk/config/config.hxx>
+#include <sk/config/option.hxx>
+#include <sk/config/parse.hxx>
+#include <sk/config/parser/string_view.hxx>
+#include <sk/config/parser/vector.hxx>
+#include <sk/config/source_buffer.hxx>
+
+namespace {
+
+    // Return true if v points into buf.
+    bool in_buffer(sk::config::source_buffer const &buf,
+                   std::string_view v) {
+        return v.data() >= buf.begin() && v.data() + v.size() <= buf.end();
+    }
+
+} // namespace
+
+TEST_CASE("std::string_view") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        std::string_view bare, quoted, escaped, here;
+    };
+
+    auto grammar = cfg::config<test_config>(
+        cfg::option("bare", &test_config::bare),
+        cfg::option("quoted", &test_config::quoted),
+        cfg::option("escaped", &test_config::escaped),
+        cfg::option("here", &test_config::here));
+
+    cfg::source_buffer buf(R"(
+bare bare-string;
+quoted 'a quoted string';
+escaped "a \"string\"\twith escapes";
+here <<<END
+heredoc text
+END;
+)");
+
+    test_config c;
+    cfg::parse(buf, grammar, c);
+
+    REQUIRE(c.bare == "bare-string");
+    REQUIRE(in_buffer(buf, c.bare));
+
+    REQUIRE(c.quoted == "a quoted string");
+    REQUIRE(in_buffer(buf, c.quoted));
+
+    REQUIRE(c.escaped == "a \"string\"\twith escapes");
+    REQUIRE(!in_buffer(buf, c.escaped));
+
+    REQUIRE(c.here == "heredoc text");
+    REQUIRE(in_buffer(buf, c.here));
+}
+
+TEST_CASE("std::vector<std::string_view>") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        std::vector<std::string_view> list;
+    };
+
+    auto grammar =
+        cfg::config<test_config>(cfg::option("list", &test_config::list));
+
+    cfg::source_buffer buf(R"(list one, "two", 'th\'ree';)");
+
+    test_config c;
+    cfg::parse(buf, grammar, c);
+
+    REQUIRE(c.list.size() == 3);
+    REQUIRE(c.list[0] == "one");
+    REQUIRE(c.list[1] == "two");
+    REQUIRE(c.list[2] == "th'ree");
+    REQUIRE(in_buffer(buf, c.list[1]));
+}
+
+TEST_CASE("std::string_view error") {
+    namespace cfg = sk::config;
+
+    struct test_config {
+        std::string_view v;
+    };
+
+    auto grammar =
+        cfg::config<test_config>(cfg::option("v", &test_config::v));
+
+    cfg::source_buffer buf("v 'unterminated;\n", "test.conf");
+
+    test_config c;
+    try {
+        cfg::parse(buf, grammar, c);
+        FAIL("expected parse_error");
+    } catch (cfg::parse_error const &e) {
+        REQUIRE(e.errors.size() > 0);
+        REQUIRE(e.errors[0].file == "test.conf");
+        REQUIRE(e.errors[0].line == 1);
+        REQUIRE(e.errors[0].message == "expected a string");
+    }
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2019, 2020, 2021 SiKol Ltd.
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sk/config.hxx>
+
+namespace {
+
+    struct test_user {
+        std::string name;
+        int uid = 0;
+        std::set<int> groups;
+    };
+
+    struct test_config {
+        std::vector<int> numbers;
+        std::map<std::string, test_user> users;
+    };
+
+    namespace cfg = sk::config;
+
+    auto const grammar = cfg::config<test_config>(
+        cfg::option("number", &test_config::numbers),
+        cfg::block<test_user>("user", &test_user::name, &test_config::users,
+                              cfg::option("uid", &test_user::uid),
+                              cfg::option("groups", &test_user::groups)));
+
+    // Return the error parse() throws for the given input.
+    auto parse_error_for(std::string_view input) -> cfg::parse_error {
+        test_config c;
+        try {
+            cfg::parse(input, grammar, c);
+        } catch (cfg::parse_error const &e) {
+            return e;
+        }
+        FAIL("parse() did not fail");
+        return cfg::parse_error("", {});
+    }
+
+    struct include_policy : cfg::parser_policy {
+        static constexpr bool allow_include = true;
+    };
+
+} // namespace
+
+TEST_CASE("try_parse success") {
+    test_config c;
+    auto r = cfg::try_parse(R"(
+number 1, 2;
+user alice {
+    uid 1000;
+    groups 1, 2;
+};
+)",
+                            grammar, c);
+
+    REQUIRE(r);
+    REQUIRE(r.has_value());
+    REQUIRE(r.error().empty());
+    REQUIRE(c.numbers == std::vector{1, 2});
+    REQUIRE(c.users.at("alice").uid == 1000);
+    REQUIRE(c.users.at("alice").groups == std::set{1, 2});
+}
+
+TEST_CASE("try_parse errors") {
+    auto check = [](std::string_view input, std::size_t line,
+                    std::string_view message) {
+        test_config c;
+        auto r = cfg::try_parse(input, grammar, c, "test.conf");
+        REQUIRE(!r);
+        REQUIRE(!r.has_value());
+        REQUIRE(!r.error().empty());
+
+        auto const &err = r.error().front();
+        REQUIRE(err.file == "test.conf");
+        REQUIRE(err.line == line);
+        REQUIRE(err.message == message);
+    };
+
+    check("number x;", 1, "expected a list of values");
+    check("number 1;\nuser a { uid 1; groups 1, 1; };", 2,
+          "expected unique value");
+    check("user a { uid 1; };\nuser a { uid 2; };", 2,
+          "expected unique value");
+    check("number 1;\nunknown;", 2, "expected eoi");
+}
+
+TEST_CASE("try_parse reports the same first error as parse") {
+    auto inputs = {
+        "number x;",
+        "number 1",
+        "number 1,,2;",
+        "user a { uid 1 };",
+        "user a {\n uid 1;\n groups 1, 1;\n};",
+        "user a { uid 1; }",
+        "number 1;\nuser a { uid 'x'; };",
+    };
+
+    for (std::string_view input : inputs) {
+        INFO(input);
+        auto expected = parse_error_for(input);
+        REQUIRE(!expected.errors.empty());
+
+        test_config c;
+        auto r = cfg::try_parse(input, grammar, c);
+        REQUIRE(!r);
+
+        auto const &want = expected.errors.front();
+        auto const &got = r.error().front();
+        REQUIRE(got.line == want.line);
+        REQUIRE(got.column == want.column);
+        REQUIRE(got.message == want.message);
+    }
+}
+
+TEST_CASE("try_parse error can be moved out") {
+    test_config c;
+    auto errors = cfg::try_parse("number x;", grammar, c).error();
+    REQUIRE(errors.size() == 1);
+}
+
+TEST_CASE("try_parse errors in include statements") {
+    auto dir = std::filesystem::temp_directory_path() /
+               "sk_config_test_try_parse_include";
+    std::filesystem::create_directories(dir);
+    auto bad = dir / "bad.conf";
+    std::ofstream(bad) << "number 1;\nnumber x;\n";
+
+    {
+        test_config c;
+        auto r = cfg::try_parse<include_policy>("number 1;\ninclude 42;",
+                                                grammar, c, "test.conf");
+        REQUIRE(!r);
+        REQUIRE(r.error().size() == 1);
+        REQUIRE(r.error()[0].line == 2);
+        REQUIRE(r.error()[0].message.starts_with("expected "));
+    }
+
+    {
+        test_config c;
+        auto r = cfg::try_parse<include_policy>(
+            "number 1;\ninclude \"" + bad.generic_string() + "\";\n", grammar,
+            c, "test.conf");
+        REQUIRE(!r);
+        REQUIRE(r.error().size() == 2);
+        REQUIRE(r.error()[0].line == 2);
+        REQUIRE(r.error()[0].message == "expected a list of values");
+        REQUIRE(r.error()[1].file == "test.conf");
+        REQUIRE(r.error()[1].line == 2);
+        REQUIRE(r.error()[1].message == "included from here");
+    }
+
+    std::filesystem::remove_all(dir);
+}